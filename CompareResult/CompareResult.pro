@@ -1,6 +1,6 @@
 QT       += core gui
 
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets xml
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets xml concurrent
 
 CONFIG += c++17
 
@@ -10,13 +10,29 @@ CONFIG += c++17
 
 SOURCES += \
     ImageViewWidget.cpp \
+    boxgridindex.cpp \
     main.cpp \
     comparewidget.cpp \
+    datasetevaluator.cpp \
+    detectionmatcher.cpp \
+    evaluationpanel.cpp \
+    ioukernel.cpp \
+    pathtable.cpp \
+    prcurvepanel.cpp \
+    prcurveview.cpp \
     vocParser.cpp
 
 HEADERS += \
     ImageViewWidget.hpp \
+    boxgridindex.h \
     comparewidget.h \
+    datasetevaluator.h \
+    detectionmatcher.h \
+    evaluationpanel.h \
+    ioukernel.h \
+    pathtable.h \
+    prcurvepanel.h \
+    prcurveview.h \
     vocParser.h
 
 # Default rules for deployment.
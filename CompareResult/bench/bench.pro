@@ -0,0 +1,22 @@
+QT       += core xml
+QT       -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = CompareResultBench
+
+# IoU 的微基准：逐对调用 calculateIoU 与批量 IoU 核（标量 / SIMD）对比
+INCLUDEPATH += ..
+
+SOURCES += \
+    main.cpp \
+    ../boxgridindex.cpp \
+    ../detectionmatcher.cpp \
+    ../ioukernel.cpp
+
+HEADERS += \
+    ../boxgridindex.h \
+    ../detectionmatcher.h \
+    ../ioukernel.h \
+    ../vocParser.h
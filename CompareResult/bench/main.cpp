@@ -0,0 +1,179 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <algorithm>
+#include <cmath>
+
+#include "detectionmatcher.h"
+#include "ioukernel.h"
+
+// IoU 计算的微基准
+// 随机生成一组 GT 和一组 DT 框，分别用逐对调用 calculateIoU、批量核的标量版本和 SIMD 版本填满 IoU 矩阵，
+// 报告每秒计算的框对数，以及与 calculateIoU 结果的最大差值；批量核的结果必须与 calculateIoU 逐位一致，否则返回 1
+// 用法示例：CompareResultBench --sizes 16x16,64x64,256x256,2048x256 --repeat 20
+
+namespace {
+
+struct BenchResult
+{
+    QString name;
+    int gtCount = 0;
+    int dtCount = 0;
+    double seconds = 0.0;
+    qint64 pairs = 0;
+    double maxError = 0.0; // 与 calculateIoU 的最大差值
+    qint64 mismatches = 0; // 与 calculateIoU 不相等的项数（包括 NaN）
+};
+
+QVector<QRect> randomBoxes(QRandomGenerator& random, int count, int imageWidth, int imageHeight)
+{
+    QVector<QRect> boxes;
+    boxes.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const int width = random.bounded(8, 300);
+        const int height = random.bounded(8, 300);
+        boxes.append(QRect(random.bounded(imageWidth - width), random.bounded(imageHeight - height), width, height));
+    }
+    return boxes;
+}
+
+// 现在的做法：每一对框调用一次 calculateIoU
+BenchResult benchPairwise(const QVector<QRect>& gt, const QVector<QRect>& dt, int repeat, QVector<double>& reference)
+{
+    BenchResult result;
+    result.name = "pairwise";
+    reference.resize(gt.size() * dt.size());
+    QElapsedTimer timer;
+    timer.start();
+    for (int r = 0; r < repeat; ++r) {
+        for (qsizetype d = 0; d < dt.size(); ++d) {
+            for (qsizetype g = 0; g < gt.size(); ++g) {
+                reference[d * gt.size() + g] = calculateIoU(gt[g], dt[d]);
+            }
+        }
+    }
+    result.seconds = timer.nsecsElapsed() / 1e9;
+    result.pairs = qint64(gt.size()) * dt.size() * repeat;
+    return result;
+}
+
+// 批量核：计时包含把 GT 转成结构数组的时间
+BenchResult benchKernel(const QString& name, bool simd, const QVector<QRect>& gt, const QVector<QRect>& dt, int repeat,
+                        const QVector<double>& reference)
+{
+    BenchResult result;
+    result.name = name;
+    QVector<double> matrix(gt.size() * dt.size());
+    QElapsedTimer timer;
+    timer.start();
+    for (int r = 0; r < repeat; ++r) {
+        BoxArray boxes;
+        boxes.reserve(int(gt.size()));
+        for (const QRect& box : gt) {
+            boxes.append(box);
+        }
+        for (qsizetype d = 0; d < dt.size(); ++d) {
+            double* row = matrix.data() + d * gt.size();
+            if (simd) {
+                IoUKernel::row(boxes, dt[d], row);
+            } else {
+                IoUKernel::rowScalar(boxes, dt[d], row);
+            }
+        }
+    }
+    result.seconds = timer.nsecsElapsed() / 1e9;
+    result.pairs = qint64(gt.size()) * dt.size() * repeat;
+    for (qsizetype i = 0; i < matrix.size(); ++i) {
+        result.maxError = std::max(result.maxError, std::abs(matrix[i] - reference[i]));
+        result.mismatches += matrix[i] != reference[i];
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("CompareResultBench");
+
+    QCommandLineParser cli;
+    cli.setApplicationDescription("CompareResult IoU 计算基准测试");
+    cli.addHelpOption();
+    QCommandLineOption sizesOption("sizes", "GT×DT 框数列表，逗号分隔", "list", "16x16,64x64,256x256,2048x256");
+    QCommandLineOption repeatOption("repeat", "每项重复次数", "n", "20");
+    QCommandLineOption seedOption("seed", "随机种子", "n", "12345");
+    QCommandLineOption csvOption("csv", "以 CSV 输出结果，便于和基线比较");
+    cli.addOptions({sizesOption, repeatOption, seedOption, csvOption});
+    cli.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QVector<QPair<int, int>> sizes;
+    for (const QString& size : cli.value(sizesOption).split(',', Qt::SkipEmptyParts)) {
+        const QStringList parts = size.split('x');
+        const int gtCount = parts.value(0).toInt();
+        const int dtCount = parts.value(1, parts.value(0)).toInt();
+        if (gtCount < 1 || dtCount < 1) {
+            err << "参数错误：" << size << "\n";
+            cli.showHelp(1);
+        }
+        sizes.append({gtCount, dtCount});
+    }
+    const int repeat = qMax(1, cli.value(repeatOption).toInt());
+    QRandomGenerator random(cli.value(seedOption).toUInt());
+
+    QVector<BenchResult> results;
+    for (const auto& [gtCount, dtCount] : std::as_const(sizes)) {
+        const QVector<QRect> gt = randomBoxes(random, gtCount, 4000, 3000);
+        const QVector<QRect> dt = randomBoxes(random, dtCount, 4000, 3000);
+        QVector<double> reference;
+        QVector<BenchResult> group;
+        group.append(benchPairwise(gt, dt, repeat, reference));
+        group.append(benchKernel("scalar", false, gt, dt, repeat, reference));
+        if (IoUKernel::hasSimd()) {
+            group.append(benchKernel("simd", true, gt, dt, repeat, reference));
+        }
+        for (BenchResult& r : group) {
+            r.gtCount = gtCount;
+            r.dtCount = dtCount;
+        }
+        results += group;
+    }
+
+    if (cli.isSet(csvOption)) {
+        out << "bench,gt,dt,seconds,pairs_per_s,max_error\n";
+    } else {
+        out << QString("%1 %2 %3 %4 %5\n")
+                   .arg("bench", -10).arg("gt", 6).arg("dt", 6).arg("Mpairs/s", 10).arg("max error", 12);
+    }
+    for (const BenchResult& r : std::as_const(results)) {
+        const double pairsPerSecond = r.pairs / qMax(1e-9, r.seconds);
+        if (cli.isSet(csvOption)) {
+            out << QString("%1,%2,%3,%4,%5,%6\n")
+                       .arg(r.name).arg(r.gtCount).arg(r.dtCount)
+                       .arg(r.seconds, 0, 'f', 4)
+                       .arg(pairsPerSecond, 0, 'f', 1)
+                       .arg(r.maxError, 0, 'g', 3);
+        } else {
+            out << QString("%1 %2 %3 %4 %5\n")
+                       .arg(r.name, -10).arg(r.gtCount, 6).arg(r.dtCount, 6)
+                       .arg(pairsPerSecond / 1e6, 10, 'f', 1)
+                       .arg(r.maxError, 12, 'g', 3);
+        }
+    }
+    err << "IoU 核：" << (IoUKernel::hasSimd() ? "SSE2" : "标量") << "\n";
+
+    int exitCode = 0;
+    for (const BenchResult& r : std::as_const(results)) {
+        if (r.mismatches > 0) {
+            err << "错误：" << r.name << " " << r.gtCount << "x" << r.dtCount << " 有 " << r.mismatches
+                << " 项与 calculateIoU 不一致，最大差值 " << r.maxError << "\n";
+            exitCode = 1;
+        }
+    }
+    return exitCode;
+}
@@ -0,0 +1,101 @@
+#include "boxgridindex.h"
+#include <algorithm>
+
+BoxGridIndex::BoxGridIndex(const QList<VocObject>& objects)
+    : objects_(&objects), stamp_(objects.size(), 0)
+{
+    QHash<QString, QVector<int>> byClass;
+    for (int i = 0; i < objects.size(); ++i) {
+        byClass[objects[i].name].append(i);
+    }
+
+    for (auto it = byClass.constBegin(); it != byClass.constEnd(); ++it) {
+        const QVector<int>& members = it.value();
+        Grid grid;
+        qint64 sideSum = 0;
+        for (int i : members) {
+            const QRect& box = objects[i].bndbox;
+            grid.bounds = grid.bounds.isNull() ? box : grid.bounds.united(box);
+            sideSum += std::max(box.width(), box.height());
+        }
+
+        // 格子边长取平均框边长，一个框通常只落在几个格子里；格子太多时加倍边长
+        grid.cellSize = std::max<int>(1, int(sideSum / members.size()));
+        for (;;) {
+            grid.columns = (grid.bounds.width() + grid.cellSize - 1) / grid.cellSize;
+            grid.rows = (grid.bounds.height() + grid.cellSize - 1) / grid.cellSize;
+            if (qint64(grid.columns) * grid.rows <= qint64(kCellsPerBox) * members.size()) {
+                break;
+            }
+            grid.cellSize *= 2;
+        }
+
+        auto cellRange = [&grid](const QRect& box, int& x0, int& x1, int& y0, int& y1) {
+            x0 = std::clamp((box.left() - grid.bounds.left()) / grid.cellSize, 0, grid.columns - 1);
+            x1 = std::clamp((box.right() - grid.bounds.left()) / grid.cellSize, 0, grid.columns - 1);
+            y0 = std::clamp((box.top() - grid.bounds.top()) / grid.cellSize, 0, grid.rows - 1);
+            y1 = std::clamp((box.bottom() - grid.bounds.top()) / grid.cellSize, 0, grid.rows - 1);
+        };
+
+        // 两遍：先数每个格子的框数，再按前缀和填入
+        const int cellCount = grid.columns * grid.rows;
+        grid.cellBegin = QVector<int>(cellCount + 1, 0);
+        for (int i : members) {
+            int x0, x1, y0, y1;
+            cellRange(objects[i].bndbox, x0, x1, y0, y1);
+            for (int y = y0; y <= y1; ++y) {
+                for (int x = x0; x <= x1; ++x) {
+                    ++grid.cellBegin[y * grid.columns + x + 1];
+                }
+            }
+        }
+        for (int c = 0; c < cellCount; ++c) {
+            grid.cellBegin[c + 1] += grid.cellBegin[c];
+        }
+        grid.items.resize(grid.cellBegin[cellCount]);
+        QVector<int> fill(grid.cellBegin.constBegin(), grid.cellBegin.constEnd() - 1);
+        for (int i : members) {
+            int x0, x1, y0, y1;
+            cellRange(objects[i].bndbox, x0, x1, y0, y1);
+            for (int y = y0; y <= y1; ++y) {
+                for (int x = x0; x <= x1; ++x) {
+                    grid.items[fill[y * grid.columns + x]++] = i;
+                }
+            }
+        }
+        grids_.insert(it.key(), std::move(grid));
+    }
+}
+
+void BoxGridIndex::query(const QString& name, const QRect& box, QVector<int>& out) const
+{
+    out.clear();
+    auto it = grids_.constFind(name);
+    if (it == grids_.constEnd() || !it->bounds.intersects(box)) {
+        return;
+    }
+    const Grid& grid = *it;
+    const int x0 = std::clamp((box.left() - grid.bounds.left()) / grid.cellSize, 0, grid.columns - 1);
+    const int x1 = std::clamp((box.right() - grid.bounds.left()) / grid.cellSize, 0, grid.columns - 1);
+    const int y0 = std::clamp((box.top() - grid.bounds.top()) / grid.cellSize, 0, grid.rows - 1);
+    const int y1 = std::clamp((box.bottom() - grid.bounds.top()) / grid.cellSize, 0, grid.rows - 1);
+
+    ++epoch_;
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            const int cell = y * grid.columns + x;
+            for (int k = grid.cellBegin[cell]; k < grid.cellBegin[cell + 1]; ++k) {
+                const int i = grid.items[k];
+                if (stamp_[i] == epoch_) {
+                    continue;
+                }
+                stamp_[i] = epoch_;
+                // 同一格子里的框不一定重叠，这里精确判断一次（QRect 的右、下边界是闭区间，与 IoU 的算法一致）
+                if ((*objects_)[i].bndbox.intersects(box)) {
+                    out.append(i);
+                }
+            }
+        }
+    }
+    std::sort(out.begin(), out.end()); // 与逐个比较时的顺序相同，IoU 相等时选中同一个框
+}
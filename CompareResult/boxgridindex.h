@@ -0,0 +1,42 @@
+#ifndef BOXGRIDINDEX_H
+#define BOXGRIDINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QRect>
+#include <QString>
+#include <QVector>
+#include "vocParser.h"
+
+// 一张图片中框的均匀网格索引，每个类别一张网格
+// 查询只返回同类别、与给定框有重叠（IoU > 0）的框，航拍、人群等密集图片上不用逐对计算 IoU
+class BoxGridIndex
+{
+public:
+    static constexpr int kMinBoxes = 32;      // 框比这少时逐个比较更快，不建索引
+    static constexpr int kCellsPerBox = 2;    // 每个类别的网格数不超过框数的这个倍数
+
+    BoxGridIndex() = default;
+    explicit BoxGridIndex(const QList<VocObject>& objects);
+
+    // 类别为 name、与 box 有重叠的框的序号，按序号从小到大写入 out（先清空）
+    void query(const QString& name, const QRect& box, QVector<int>& out) const;
+
+private:
+    struct Grid
+    {
+        QRect bounds;          // 该类别所有框的外接矩形
+        int cellSize = 1;
+        int columns = 1;
+        int rows = 1;
+        QVector<int> cellBegin; // 压缩存储：第 c 个格子的框序号为 items[cellBegin[c], cellBegin[c + 1])
+        QVector<int> items;
+    };
+
+    const QList<VocObject>* objects_ = nullptr;
+    QHash<QString, Grid> grids_;
+    mutable QVector<int> stamp_; // 一个框跨多个格子时只返回一次
+    mutable int epoch_ = 0;
+};
+
+#endif // BOXGRIDINDEX_H
@@ -1,35 +1,34 @@
 #include "comparewidget.h"
 #include <QDirIterator>
+#include <algorithm>
 
-static double calculateIoU(const QRect& r1, const QRect& r2)
+void CompareWidget::compare(qint64 index, bool tp)
 {
-    int xA = std::max(r1.left(), r2.left());
-    int yA = std::max(r1.top(), r2.top());
-    int xB = std::min(r1.right(), r2.right()); // QRect right() is x + width - 1
-    int yB = std::min(r1.bottom(), r2.bottom()); // QRect bottom() is y + height - 1
-
-    int interWidth = std::max(0, xB - xA + 1);
-    int interHeight = std::max(0, yB - yA + 1);
-    double interArea = static_cast<double>(interWidth * interHeight);
-
-    if (interArea == 0) {
-        return 0.0;
+    if (index >= gt_xml_list.size() || index >= dt_xml_list.size()) {
+        return; // GT 或 DT 比图片少，这张图片没有对应的标注
     }
-
-    double box1Area = static_cast<double>(r1.width() * r1.height());
-    double box2Area = static_cast<double>(r2.width() * r2.height());
-
-    double iou = interArea / (box1Area + box2Area - interArea);
-
-    return iou;
+    // 评估过整个数据集后直接用缓存的匹配结果，不再解析 XML
+    if (const ImageMatch* cached = evaluator->cachedMatch(index)) {
+        drawMatch(*cached, tp);
+        return;
+    }
+    if (current_match_index != index) {
+        const QString gt_xml_path = paths.path(gt_xml_list[index]);
+        const QString dt_xml_path = paths.path(dt_xml_list[index]);
+        current_match = ImageMatch::compute(parser.parseObjects(gt_xml_path), parser.parseObjects(dt_xml_path));
+        current_match_index = index;
+    }
+    drawMatch(current_match, tp);
 }
 
-void CompareWidget::compare(QString gt_xml_path, QString dt_xml_path, bool tp)
+// DT 标签中附上置信度
+static QString scoreText(const VocObject& obj)
 {
-    QList<VocObject> gt_obj_list = parser.parseObjects(gt_xml_path);
-    QList<VocObject> dt_obj_list = parser.parseObjects(dt_xml_path);
+    return obj.hasScore ? QString(" %1").arg(obj.score, 0, 'f', 2) : QString();
+}
 
-    const double IOU_THRESHOLD = 0.5;
+void CompareWidget::drawMatch(const ImageMatch& match, bool tp)
+{
     const QColor TP_COLOR(0, 255, 0, 150);    // Green (True Positive)
     const QColor FP_COLOR(0, 0, 255, 150);    // Blue (False Positive)
     const QColor FN_COLOR(255, 0, 0, 150);    // Red (False Negative)
@@ -45,86 +44,44 @@ void CompareWidget::compare(QString gt_xml_path, QString dt_xml_path, bool tp)
     QList<QRectF> dt_rects_fp;
     QList<QString> dt_labels_fp;
 
-    // Keep track of matched detections to avoid matching them multiple times
-    QVector<bool> dt_matched_flags(dt_obj_list.size(), false);
-
-    // --- Matching Process ---
-    // Iterate through ground truth objects
-    for (const VocObject& gt_obj : gt_obj_list)
+    for (int g = 0; g < match.gt.size(); ++g)
     {
-        double best_iou = 0.0;
-        int best_dt_match_idx = -1;
-
-        // Find the best matching detection for the current GT object
-        for (int i = 0; i < dt_obj_list.size(); ++i)
-        {
-            if (dt_matched_flags[i]) // If this detection is already matched to a higher IoU GT
-            {
-                // Optional: If you want to allow a detection to match multiple GTs (uncommon), remove this.
-                // Or, if a GT can only match one DT, and a DT can only match one GT (common for evaluation)
-                // this greedy approach might need refinement (e.g. Hungarian algorithm for optimal assignment)
-                // For visualization, this greedy approach is often sufficient.
-                // continue; // Let's allow a DT to be considered for multiple GTs, but only one GT claims it.
-            }
-
-            const VocObject& dt_obj = dt_obj_list[i];
-
-            if (gt_obj.name == dt_obj.name) // Class names must match
-            {
-                double iou = calculateIoU(gt_obj.bndbox, dt_obj.bndbox);
-                if (iou > best_iou)
-                {
-                    best_iou = iou;
-                    best_dt_match_idx = i;
-                }
-            }
-        }
-
+        const VocObject& gt_obj = match.gt[g];
         QRectF gt_bndbox_f(gt_obj.bndbox.left(), gt_obj.bndbox.top(), gt_obj.bndbox.width(), gt_obj.bndbox.height());
-
-        if (best_dt_match_idx != -1 && best_iou >= IOU_THRESHOLD && !dt_matched_flags[best_dt_match_idx])
+        const int d = match.gtMatch(iou_index, g);
+        if (d >= 0)
         {
             // --- True Positive (TP) ---
-            // This GT object is matched with a DT object
+            const double iou = match.iou(d, g);
             gt_rects_tp.append(gt_bndbox_f);
-            gt_labels_tp.append(QString("TP: %1 (IoU: %2)").arg(gt_obj.name).arg(best_iou, 0, 'f', 2));
+            gt_labels_tp.append(QString("TP: %1 (IoU: %2)").arg(gt_obj.name).arg(iou, 0, 'f', 2));
 
-            const VocObject& matched_dt_obj = dt_obj_list[best_dt_match_idx];
+            const VocObject& matched_dt_obj = match.dt[d];
             QRectF dt_bndbox_f(matched_dt_obj.bndbox.left(), matched_dt_obj.bndbox.top(), matched_dt_obj.bndbox.width(), matched_dt_obj.bndbox.height());
             dt_rects_tp.append(dt_bndbox_f);
-            dt_labels_tp.append(QString("TP: %1 (IoU: %2)").arg(matched_dt_obj.name).arg(best_iou, 0, 'f', 2));
-
-            dt_matched_flags[best_dt_match_idx] = true; // Mark this detection as matched
+            dt_labels_tp.append(QString("TP: %1%2 (IoU: %3)").arg(matched_dt_obj.name, scoreText(matched_dt_obj)).arg(iou, 0, 'f', 2));
         }
         else
         {
             // --- False Negative (FN) ---
-            // This GT object was not detected or matched with low IoU
             gt_rects_fn.append(gt_bndbox_f);
             gt_labels_fn.append(QString("FN: %1").arg(gt_obj.name));
-                // If best_dt_match_idx was valid but IoU too low, that dt_obj is still considered unmatched for now
         }
     }
 
     // --- Identify False Positives (FP) ---
-    // Iterate through detection objects to find those not matched
-    for (int i = 0; i < dt_obj_list.size(); ++i)
+    for (int d = 0; d < match.dt.size(); ++d)
     {
-        if (!dt_matched_flags[i])
+        if (match.dtMatch(iou_index, d) < 0)
         {
-            const VocObject& dt_obj = dt_obj_list[i];
+            const VocObject& dt_obj = match.dt[d];
             QRectF dt_bndbox_f(dt_obj.bndbox.left(), dt_obj.bndbox.top(), dt_obj.bndbox.width(), dt_obj.bndbox.height());
             dt_rects_fp.append(dt_bndbox_f);
-            dt_labels_fp.append(QString("FP: %1").arg(dt_obj.name));
+            dt_labels_fp.append(QString("FP: %1%2").arg(dt_obj.name, scoreText(dt_obj)));
         }
     }
 
-    // --- Update Image Viewers ---
-    // This assumes your ImageViewer has methods like clearRectangles() and
-    // addRectangles(rects, color, labels)
-    // You might need to adapt this part based on your ImageViewer's API.
-
-    imageViewer1->clearDrawingData(); // Hypothetical method
+    imageViewer1->clearDrawingData();
     if (!gt_rects_tp.isEmpty() && tp) {
         imageViewer1->addRectanglesToDraw(gt_rects_tp, TP_COLOR, gt_labels_tp);
     }
@@ -133,7 +90,7 @@ void CompareWidget::compare(QString gt_xml_path, QString dt_xml_path, bool tp)
     }
     imageViewer1->update(); // Trigger repaint
 
-    imageViewer2->clearDrawingData(); // Hypothetical method
+    imageViewer2->clearDrawingData();
     if (!dt_rects_tp.isEmpty() && tp) {
         imageViewer2->addRectanglesToDraw(dt_rects_tp, TP_COLOR, dt_labels_tp);
     }
@@ -160,6 +117,8 @@ CompareWidget::CompareWidget(QWidget *parent)
     btnLoadGtXmlDir = new QPushButton("GT xml 路径", centralWidget);
     btnLoadDtXmlDir = new QPushButton("DT xml 路径", centralWidget);
     btnCompare      = new QPushButton("对比", centralWidget);
+    btnEvaluate     = new QPushButton("评估全部", centralWidget);
+    btnEvaluate->setToolTip("在后台匹配所有图片，统计每个类别的精确率、召回率和 AP；完成后翻页直接使用缓存的结果");
     // btnFilterTp  = new QPushButton("当前显示TP标签", centralWidget);
     checkBoxShow    = new QCheckBox("当前显示TP", centralWidget);
     checkBoxShow->setStyleSheet(
@@ -196,6 +155,14 @@ CompareWidget::CompareWidget(QWidget *parent)
         "}"
         );
 
+    sliderIou       = new QSlider(Qt::Horizontal, centralWidget);
+    sliderIou->setRange(0, ImageMatch::kThresholdCount - 1);
+    sliderIou->setPageStep(1);
+    sliderIou->setTickPosition(QSlider::TicksBelow);
+    sliderIou->setMaximumWidth(160);
+    sliderIou->setToolTip("切换 IoU 阈值，图片和评估结果都使用已算好的匹配，不重新解析 XML");
+    labelIou        = new QLabel(QString("IoU ≥ %1").arg(ImageMatch::threshold(iou_index), 0, 'f', 2), centralWidget);
+
     progressBar     = new QProgressBar(centralWidget);
     progressBar->setStyleSheet(
         "QProgressBar {"
@@ -219,6 +186,13 @@ CompareWidget::CompareWidget(QWidget *parent)
     midLayout->addWidget(imageViewer1);
     midLayout->addWidget(imageViewer2);
 
+    evaluator = new DatasetEvaluator(this);
+    resultTabs = new QTabWidget(centralWidget);
+    evaluationPanel = new EvaluationPanel(resultTabs);
+    prCurvePanel = new PrCurvePanel(resultTabs);
+    resultTabs->addTab(evaluationPanel, "评估结果");
+    resultTabs->addTab(prCurvePanel, "PR 曲线");
+
 
     btnPre       = new QPushButton("上一张", centralWidget);
     btnNext      = new QPushButton("下一张", centralWidget);
@@ -227,7 +201,10 @@ CompareWidget::CompareWidget(QWidget *parent)
     topLayout->addWidget(btnLoadGtXmlDir);
     topLayout->addWidget(btnLoadDtXmlDir);
     topLayout->addWidget(btnCompare);
+    topLayout->addWidget(btnEvaluate);
     topLayout->addWidget(checkBoxShow);
+    topLayout->addWidget(labelIou);
+    topLayout->addWidget(sliderIou);
     topLayout->addWidget(progressBar);
     topLayout->addItem(new QSpacerItem(40, 20, QSizePolicy::Expanding, QSizePolicy::Minimum));
 
@@ -238,7 +215,8 @@ CompareWidget::CompareWidget(QWidget *parent)
     bottomLayout->addItem(new QSpacerItem(40, 20, QSizePolicy::Expanding, QSizePolicy::Minimum));
 
     mainLayout->addLayout(topLayout);
-    mainLayout->addLayout(midLayout);
+    mainLayout->addLayout(midLayout, 3);
+    mainLayout->addWidget(resultTabs, 1);
     mainLayout->addLayout(bottomLayout);
 
     midLayout->setStretchFactor(imageViewer1, 1);
@@ -257,6 +235,8 @@ CompareWidget::CompareWidget(QWidget *parent)
         qDebug() << "Selected directory:" << image_dir;
 
         image_list.clear(); // Clear previous results
+        compactPaths();
+        resetEvaluation(); // 文件列表变了，缓存的匹配结果不再对应
 
         QStringList nameFilters;
         nameFilters << "*.png" << "*.jpg" << "*.jpeg" << "*.bmp";
@@ -267,7 +247,7 @@ CompareWidget::CompareWidget(QWidget *parent)
 
         while (it.hasNext()) {
             QString filePath = it.next(); // it.next() advances and returns the current path
-            image_list.push_back(filePath);
+            image_list.push_back(paths.add(filePath));
         }
 
         if (image_list.size() > 0)
@@ -275,8 +255,8 @@ CompareWidget::CompareWidget(QWidget *parent)
             progressBar->setRange(0, image_list.size());
             progressBar->setValue(0); // Initial value
             current_index = 0;
-            imageViewer1->loadImage(image_list[current_index]);
-            imageViewer2->loadImage(image_list[current_index]);
+            imageViewer1->loadImage(paths.path(image_list[current_index]));
+            imageViewer2->loadImage(paths.path(image_list[current_index]));
         }
     });
 
@@ -290,6 +270,8 @@ CompareWidget::CompareWidget(QWidget *parent)
         qDebug() << "Selected directory:" << gt_xml_dir;
 
         gt_xml_list.clear(); // Clear previous results
+        compactPaths();
+        resetEvaluation(); // 文件列表变了，缓存的匹配结果不再对应
 
         QStringList nameFilters;
         nameFilters << "*.xml";
@@ -300,7 +282,7 @@ CompareWidget::CompareWidget(QWidget *parent)
 
         while (it.hasNext()) {
             QString filePath = it.next(); // it.next() advances and returns the current path
-            gt_xml_list.push_back(filePath);
+            gt_xml_list.push_back(paths.add(filePath));
         }
 
     });
@@ -315,6 +297,8 @@ CompareWidget::CompareWidget(QWidget *parent)
         qDebug() << "Selected directory:" << dt_xml_dir;
 
         dt_xml_list.clear(); // Clear previous results
+        compactPaths();
+        resetEvaluation(); // 文件列表变了，缓存的匹配结果不再对应
 
         QStringList nameFilters;
         nameFilters << "*.xml";
@@ -325,14 +309,56 @@ CompareWidget::CompareWidget(QWidget *parent)
 
         while (it.hasNext()) {
             QString filePath = it.next(); // it.next() advances and returns the current path
-            dt_xml_list.push_back(filePath);
+            dt_xml_list.push_back(paths.add(filePath));
         }
     });
 
     QObject::connect(btnCompare, &QPushButton::clicked, this, [this]() {
         if (image_list.size() > current_index && dt_xml_list.size() > 0 && gt_xml_list.size() > 0)
         {
-            compare(gt_xml_list[current_index], dt_xml_list[current_index], show_tp);
+            compare(current_index, show_tp);
+        }
+    });
+
+    QObject::connect(btnEvaluate, &QPushButton::clicked, this, [this]() {
+        if (gt_xml_list.isEmpty() || dt_xml_list.isEmpty())
+        {
+            evaluationPanel->setMessage("请先加载 GT 和 DT 目录");
+            return;
+        }
+        if (gt_xml_list.size() != dt_xml_list.size())
+        {
+            qWarning() << "GT 和 DT 文件数不同，只评估前" << std::min(gt_xml_list.size(), dt_xml_list.size()) << "对";
+        }
+        btnEvaluate->setEnabled(false);
+        evaluator->start(paths, gt_xml_list, dt_xml_list);
+    });
+
+    QObject::connect(evaluator, &DatasetEvaluator::progressChanged, evaluationPanel, &EvaluationPanel::setProgress);
+    QObject::connect(evaluator, &DatasetEvaluator::finished, this, [this]() {
+        btnEvaluate->setEnabled(true);
+        showEvaluation();
+        if (image_list.size() > current_index && evaluator->cachedMatch(current_index))
+        {
+            compare(current_index, show_tp);
+        }
+    });
+    QObject::connect(evaluator, &DatasetEvaluator::cancelled, this, [this]() {
+        btnEvaluate->setEnabled(true);
+    });
+
+    QObject::connect(sliderIou, &QSlider::valueChanged, this, [this](int value) {
+        iou_index = value;
+        labelIou->setText(QString("IoU ≥ %1").arg(ImageMatch::threshold(iou_index), 0, 'f', 2));
+        if (evaluator->hasEvaluation())
+        {
+            showEvaluation();
+        }
+        // 只重画已经对比过的图片：匹配结果在缓存里，不用重新解析
+        if (image_list.size() > current_index
+            && (evaluator->cachedMatch(current_index) || current_match_index == current_index))
+        {
+            compare(current_index, show_tp);
         }
     });
 
@@ -348,7 +374,7 @@ CompareWidget::CompareWidget(QWidget *parent)
         }
         if (image_list.size() > current_index && dt_xml_list.size() > 0 && gt_xml_list.size() > 0)
         {
-            compare(gt_xml_list[current_index], dt_xml_list[current_index], show_tp);
+            compare(current_index, show_tp);
         }
     });
 
@@ -368,11 +394,11 @@ CompareWidget::CompareWidget(QWidget *parent)
                 progressBar->setValue(0); // Or handle as an error/empty state
             }
 
-            imageViewer1->loadImage(image_list[current_index]);
-            imageViewer2->loadImage(image_list[current_index]);
+            imageViewer1->loadImage(paths.path(image_list[current_index]));
+            imageViewer2->loadImage(paths.path(image_list[current_index]));
             if (image_list.size() > current_index && dt_xml_list.size() > 0 && gt_xml_list.size() > 0)
             {
-                compare(gt_xml_list[current_index], dt_xml_list[current_index], show_tp);
+                compare(current_index, show_tp);
             }
         }
     });
@@ -391,11 +417,11 @@ CompareWidget::CompareWidget(QWidget *parent)
                 progressBar->setValue(0);
             }
 
-            imageViewer1->loadImage(image_list[current_index]);
-            imageViewer2->loadImage(image_list[current_index]);
+            imageViewer1->loadImage(paths.path(image_list[current_index]));
+            imageViewer2->loadImage(paths.path(image_list[current_index]));
             if (image_list.size() > current_index && dt_xml_list.size() > 0 && gt_xml_list.size() > 0)
             {
-                compare(gt_xml_list[current_index], dt_xml_list[current_index], show_tp);
+                compare(current_index, show_tp);
             }
         }
     });
@@ -406,3 +432,35 @@ CompareWidget::~CompareWidget()
 {
 
 }
+
+void CompareWidget::compactPaths()
+{
+    QVector<PathId>* lists[] = {&image_list, &gt_xml_list, &dt_xml_list};
+    QVector<QVector<QString>> kept;
+    for (const QVector<PathId>* list : lists) {
+        QVector<QString> listPaths;
+        listPaths.reserve(list->size());
+        for (PathId id : *list) {
+            listPaths.append(paths.path(id));
+        }
+        kept.append(listPaths);
+    }
+    paths.clear();
+    for (int i = 0; i < kept.size(); ++i) {
+        *lists[i] = paths.addAll(kept[i]);
+    }
+}
+
+void CompareWidget::showEvaluation()
+{
+    evaluationPanel->setEvaluation(evaluator->evaluation(iou_index));
+    prCurvePanel->setEvaluation(evaluator->evaluation(iou_index));
+}
+
+void CompareWidget::resetEvaluation()
+{
+    evaluator->clear();
+    evaluationPanel->clear();
+    prCurvePanel->clear();
+    current_match_index = -1;
+}
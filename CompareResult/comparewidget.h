@@ -11,10 +11,17 @@
 #include <QPushButton>
 #include <QLineEdit>
 #include <QCheckBox>
+#include <QLabel>
+#include <QSlider>
 #include <QFileDialog> // 用于打开文件对话框
 #include <QScrollArea> // 可选，如果图片非常大，可以放在滚动区域
 
 #include "vocParser.h"
+#include "pathtable.h"
+#include "datasetevaluator.h"
+#include "evaluationpanel.h"
+#include "prcurvepanel.h"
+#include <QTabWidget>
 
 class CompareWidget : public QWidget
 {
@@ -36,7 +43,10 @@ private:
     QPushButton  *btnLoadGtXmlDir = nullptr;
     QPushButton  *btnLoadDtXmlDir = nullptr;
     QPushButton  *btnCompare = nullptr;
+    QPushButton  *btnEvaluate = nullptr;
     QCheckBox    *checkBoxShow = nullptr;
+    QSlider      *sliderIou = nullptr; // IoU 阈值 0.50:0.05:0.95
+    QLabel       *labelIou = nullptr;
     QProgressBar *progressBar = nullptr;
 
     QPushButton  *btnPre = nullptr;
@@ -45,23 +55,44 @@ private:
     ImageViewWidget *imageViewer1 = nullptr;
     ImageViewWidget *imageViewer2 = nullptr;
 
+    QTabWidget       *resultTabs = nullptr; // 评估结果 / PR 曲线
+    EvaluationPanel  *evaluationPanel = nullptr;
+    PrCurvePanel     *prCurvePanel = nullptr;
+    DatasetEvaluator *evaluator = nullptr; // 后台评估整个数据集，并缓存每张图片的匹配结果
+
 private:
     QString image_dir;
     QString gt_xml_dir;
     QString dt_xml_dir;
 
-    QVector<QString> image_list;
-    QVector<QString> gt_xml_list;
-    QVector<QString> dt_xml_list;
+    // 三个列表共用一个路径表，只保存路径序号；gt 和 dt 目录中同名的文件名只存一份
+    PathTable paths;
+    QVector<PathId> image_list;
+    QVector<PathId> gt_xml_list;
+    QVector<PathId> dt_xml_list;
     qint64 current_index = 0;
 
     bool show_tp = true;
+    int iou_index = 0; // 当前显示的 IoU 阈值序号，见 ImageMatch::threshold
+
+    // 未评估时当前图片的匹配结果，拖动阈值时直接重新着色，不再解析 XML
+    ImageMatch current_match;
+    qint64 current_match_index = -1;
 
     VocParser parser;
 
 
 private:
-    void compare(QString gt_xml_path, QString dt_xml_path, bool tp=true);
+    // 对比第 index 对 GT/DT：评估过时使用缓存的结果，否则解析这两个文件
+    void compare(qint64 index, bool tp=true);
+    void drawMatch(const ImageMatch& match, bool tp);
+    // 把当前阈值下的评估结果显示到结果面板
+    void showEvaluation();
+    // 任一目录重新加载后取消评估并丢弃缓存
+    void resetEvaluation();
+    // 某个列表清空后调用：清空路径表，只把三个列表中还在用的路径重新加入
+    // 路径表只增不减，不这样做的话每次重新选择目录都会留下一份旧路径
+    void compactPaths();
 
 };
 #endif // COMPAREWIDGET_H
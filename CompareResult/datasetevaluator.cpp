@@ -0,0 +1,245 @@
+#include "datasetevaluator.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QtConcurrent>
+#include <algorithm>
+
+QVector<DatasetEvaluation> DatasetEvaluation::summarize(const QVector<ImageMatch>& matches)
+{
+    constexpr int T = ImageMatch::kThresholdCount;
+
+    // 类别按名字排序，之后用序号代替名字
+    QMap<QString, int> classIndex;
+    for (const ImageMatch& match : matches) {
+        for (const VocObject& obj : match.gt) {
+            classIndex.insert(obj.name, 0);
+        }
+        for (const VocObject& obj : match.dt) {
+            classIndex.insert(obj.name, 0);
+        }
+    }
+    QVector<ClassEvaluation> classes;
+    for (auto it = classIndex.begin(); it != classIndex.end(); ++it) {
+        it.value() = int(classes.size());
+        classes.append(ClassEvaluation());
+        classes.last().name = it.key();
+    }
+
+    QVector<DatasetEvaluation> results(T);
+    for (int t = 0; t < T; ++t) {
+        results[t].images = int(matches.size());
+        results[t].iouThreshold = ImageMatch::threshold(t);
+        results[t].classes = classes;
+        results[t].total.name = "全部";
+    }
+
+    struct Detection
+    {
+        float score;
+        int classIndex;
+        int image;
+        int dt;
+    };
+    QVector<Detection> detections;
+    for (int m = 0; m < matches.size(); ++m) {
+        const ImageMatch& match = matches[m];
+        for (int g = 0; g < match.gt.size(); ++g) {
+            const int c = classIndex.value(match.gt[g].name);
+            for (int t = 0; t < T; ++t) {
+                ClassEvaluation& counts = results[t].classes[c];
+                ++counts.gt;
+                if (match.gtMatch(t, g) >= 0) {
+                    ++counts.tp;
+                } else {
+                    ++counts.fn;
+                }
+            }
+        }
+        for (int d = 0; d < match.dt.size(); ++d) {
+            const int c = classIndex.value(match.dt[d].name);
+            for (int t = 0; t < T; ++t) {
+                if (match.dtMatch(t, d) < 0) {
+                    ++results[t].classes[c].fp;
+                }
+            }
+            detections.append({match.dt[d].score, c, m, d});
+        }
+    }
+    for (DatasetEvaluation& result : results) {
+        for (const ClassEvaluation& counts : std::as_const(result.classes)) {
+            result.total.gt += counts.gt;
+            result.total.tp += counts.tp;
+            result.total.fp += counts.fp;
+            result.total.fn += counts.fn;
+        }
+    }
+
+    std::sort(detections.begin(), detections.end(),
+              [](const Detection& a, const Detection& b) { return a.score > b.score; });
+
+    // 一次扫描：按阈值分别累加每个类别和合计的 TP/FP，每组同分的检测结束后给涉及到的类别各记一个点
+    const int classCount = int(classes.size());
+    QVector<int> tp(T * classCount, 0);
+    QVector<int> fp(T * classCount, 0);
+    QVector<int> totalTp(T, 0);
+    QVector<int> totalFp(T, 0);
+    QVector<bool> touched(classCount, false);
+    QVector<int> touchedClasses;
+    const int totalGt = results[0].total.gt;
+    for (qsizetype i = 0; i < detections.size();) {
+        const float score = detections[i].score;
+        for (; i < detections.size() && detections[i].score == score; ++i) {
+            const Detection& detection = detections[i];
+            const ImageMatch& match = matches[detection.image];
+            const int c = detection.classIndex;
+            for (int t = 0; t < T; ++t) {
+                if (match.dtMatch(t, detection.dt) >= 0) {
+                    ++tp[t * classCount + c];
+                    ++totalTp[t];
+                } else {
+                    ++fp[t * classCount + c];
+                    ++totalFp[t];
+                }
+            }
+            if (!touched[c]) {
+                touched[c] = true;
+                touchedClasses.append(c);
+            }
+        }
+        for (int t = 0; t < T; ++t) {
+            for (int c : std::as_const(touchedClasses)) {
+                ClassEvaluation& counts = results[t].classes[c];
+                const int k = t * classCount + c;
+                if (counts.gt > 0) { // 没有 GT 的类别召回率无意义，不画曲线
+                    counts.curve.append(QPointF(double(tp[k]) / counts.gt, double(tp[k]) / (tp[k] + fp[k])));
+                }
+            }
+            if (totalGt > 0) {
+                results[t].total.curve.append(
+                    QPointF(double(totalTp[t]) / totalGt, double(totalTp[t]) / (totalTp[t] + totalFp[t])));
+            }
+        }
+        for (int c : std::as_const(touchedClasses)) {
+            touched[c] = false;
+        }
+        touchedClasses.clear();
+    }
+
+    // 各阈值的 AP 和 mAP，再按类别对阈值取平均
+    int classesWithGt = 0;
+    for (int c = 0; c < classCount; ++c) {
+        if (results[0].classes[c].gt == 0) { // 只有误检的类别没有 AP，不参与 mAP
+            continue;
+        }
+        ++classesWithGt;
+        double apSum = 0.0;
+        for (int t = 0; t < T; ++t) {
+            ClassEvaluation& counts = results[t].classes[c];
+            counts.ap = averagePrecision(counts.curve);
+            results[t].total.ap += counts.ap;
+            apSum += counts.ap;
+        }
+        for (int t = 0; t < T; ++t) {
+            results[t].classes[c].apRange = apSum / T;
+        }
+    }
+    double mapRange = 0.0;
+    for (DatasetEvaluation& result : results) {
+        if (classesWithGt > 0) {
+            result.total.ap /= classesWithGt;
+        }
+        mapRange += result.total.ap;
+    }
+    for (DatasetEvaluation& result : results) {
+        result.total.apRange = mapRange / T;
+    }
+    return results;
+}
+
+double DatasetEvaluation::averagePrecision(const QVector<QPointF>& curve)
+{
+    double ap = 0.0;
+    double maxPrecision = 0.0;
+    // 从右往左扫描，右侧的最大精确率就是插值后的精确率
+    for (qsizetype i = curve.size() - 1; i >= 0; --i) {
+        maxPrecision = std::max(maxPrecision, curve[i].y());
+        const double previousRecall = i > 0 ? curve[i - 1].x() : 0.0;
+        ap += (curve[i].x() - previousRecall) * maxPrecision;
+    }
+    return ap;
+}
+
+DatasetEvaluator::DatasetEvaluator(QObject *parent)
+    : QObject(parent)
+{
+    connect(&watcher_, &QFutureWatcher<ImageMatch>::progressValueChanged, this, [this](int value) {
+        emit progressChanged(value, int(pairs_.size()));
+    });
+    connect(&watcher_, &QFutureWatcher<ImageMatch>::finished, this, &DatasetEvaluator::onFinished);
+}
+
+DatasetEvaluator::~DatasetEvaluator()
+{
+    watcher_.cancel();
+    watcher_.waitForFinished(); // 工作线程还在使用 pairs_ 的副本，等它们结束
+}
+
+void DatasetEvaluator::start(const PathTable& paths, const QVector<PathId>& gtFiles, const QVector<PathId>& dtFiles)
+{
+    cancel();
+    const qsizetype count = std::min(gtFiles.size(), dtFiles.size());
+    pairs_.clear();
+    pairs_.reserve(count);
+    for (qsizetype i = 0; i < count; ++i) {
+        pairs_.append({paths.path(gtFiles[i]), paths.path(dtFiles[i])});
+    }
+
+    // 每对文件独立解析和匹配，VocParser 没有共享状态，每个任务各用一个
+    watcher_.setFuture(QtConcurrent::mapped(pairs_, [](const FilePair& pair) {
+        VocParser parser;
+        return ImageMatch::compute(parser.parseObjects(pair.gtPath), parser.parseObjects(pair.dtPath));
+    }));
+    emit progressChanged(0, int(pairs_.size()));
+}
+
+void DatasetEvaluator::cancel()
+{
+    if (watcher_.isRunning()) {
+        watcher_.cancel(); // 已经开始的任务会做完，结果被丢弃
+    }
+}
+
+void DatasetEvaluator::clear()
+{
+    cancel();
+    matches_.clear();
+    evaluations_.clear();
+}
+
+const ImageMatch* DatasetEvaluator::cachedMatch(qint64 index) const
+{
+    if (index < 0 || index >= matches_.size()) {
+        return nullptr;
+    }
+    return &matches_[index];
+}
+
+const DatasetEvaluation& DatasetEvaluator::evaluation(int t) const
+{
+    return t >= 0 && t < evaluations_.size() ? evaluations_[t] : empty_;
+}
+
+void DatasetEvaluator::onFinished()
+{
+    if (watcher_.isCanceled()) {
+        emit cancelled();
+        return;
+    }
+    QElapsedTimer elapsed;
+    elapsed.start();
+    matches_ = watcher_.future().results(); // mapped 的结果与输入顺序一致
+    evaluations_ = DatasetEvaluation::summarize(matches_);
+    qDebug() << "评估完成，图片数：" << matches_.size() << "汇总用时" << elapsed.elapsed() << "ms";
+    emit finished();
+}
@@ -0,0 +1,92 @@
+#ifndef DATASETEVALUATOR_H
+#define DATASETEVALUATOR_H
+
+#include <QFutureWatcher>
+#include <QObject>
+#include <QPointF>
+#include <QString>
+#include <QVector>
+#include "detectionmatcher.h"
+#include "pathtable.h"
+
+// 一个类别（或全部类别合计）的评估结果
+struct ClassEvaluation
+{
+    QString name;
+    int gt = 0; // GT 框数 = tp + fn
+    int tp = 0;
+    int fp = 0;
+    int fn = 0;
+    double ap = 0; // 合计行中为各类别 AP 的平均值（mAP）
+    double apRange = 0; // 阈值 0.50:0.95 下 AP 的平均值，各阈值的结果中相同；合计行为 mAP@[.5:.95]
+    // PR 曲线上的点 (召回率, 精确率)，按置信度从高到低，每组同分的检测一个点；合计行为所有类别混在一起的曲线
+    QVector<QPointF> curve;
+
+    double precision() const { return tp + fp > 0 ? double(tp) / (tp + fp) : 0.0; }
+    double recall() const { return gt > 0 ? double(tp) / gt : 0.0; }
+};
+
+// 整个数据集在一个 IoU 阈值下的评估结果
+struct DatasetEvaluation
+{
+    QVector<ClassEvaluation> classes; // 按类别名排序
+    ClassEvaluation total;
+    int images = 0;
+    double iouThreshold = 0.5;
+
+    bool isEmpty() const { return images == 0; }
+
+    // 汇总每张图片的匹配结果，返回 ImageMatch::kThresholdCount 个阈值各自的结果
+    // 所有图片的检测按置信度统一排序一次，扫描一遍同时得到每个阈值下每个类别的 PR 曲线
+    static QVector<DatasetEvaluation> summarize(const QVector<ImageMatch>& matches);
+
+    // PR 曲线的全点插值 AP：每个召回率处取其右侧的最大精确率
+    // 没有置信度时所有检测同分，曲线只有一个点，AP = 精确率 × 召回率
+    static double averagePrecision(const QVector<QPointF>& curve);
+};
+
+// 在线程池中并行解析并匹配每一对 GT/DT 文件，结果按图片缓存，之后翻页时直接取用不再解析
+class DatasetEvaluator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DatasetEvaluator(QObject *parent = nullptr);
+    ~DatasetEvaluator();
+
+    // 第 i 个 GT 文件与第 i 个 DT 文件配对（与逐张对比相同），已有的评估会被取消
+    void start(const PathTable& paths, const QVector<PathId>& gtFiles, const QVector<PathId>& dtFiles);
+    void cancel();
+    // 取消并丢弃缓存，文件列表变化后调用
+    void clear();
+
+    bool isRunning() const { return watcher_.isRunning(); }
+    bool hasEvaluation() const { return !evaluations_.isEmpty(); }
+    // 第 index 对图片的缓存结果，包含所有阈值，不在缓存中时返回 nullptr
+    const ImageMatch* cachedMatch(qint64 index) const;
+    // 第 t 个阈值（ImageMatch::threshold(t)）下的结果，没有评估过时为空结果
+    const DatasetEvaluation& evaluation(int t) const;
+
+signals:
+    void progressChanged(int done, int total);
+    void finished(); // evaluation() 和缓存已更新
+    void cancelled();
+
+private:
+    void onFinished();
+
+    struct FilePair
+    {
+        QString gtPath;
+        QString dtPath;
+    };
+
+    QFutureWatcher<ImageMatch> watcher_;
+    QVector<FilePair> pairs_; // 正在评估的文件，路径在开始时取出，工作线程不访问路径表
+
+    QVector<ImageMatch> matches_; // 最近一次完成的评估，序号与文件列表一致
+    QVector<DatasetEvaluation> evaluations_; // 每个阈值一个
+    DatasetEvaluation empty_;
+};
+
+#endif // DATASETEVALUATOR_H
@@ -0,0 +1,125 @@
+#include "detectionmatcher.h"
+#include "boxgridindex.h"
+#include "ioukernel.h"
+#include <QHash>
+#include <algorithm>
+#include <numeric>
+
+double calculateIoU(const QRect& r1, const QRect& r2)
+{
+    int xA = std::max(r1.left(), r2.left());
+    int yA = std::max(r1.top(), r2.top());
+    int xB = std::min(r1.right(), r2.right()); // QRect right() is x + width - 1
+    int yB = std::min(r1.bottom(), r2.bottom()); // QRect bottom() is y + height - 1
+
+    int interWidth = std::max(0, xB - xA + 1);
+    int interHeight = std::max(0, yB - yA + 1);
+    double interArea = static_cast<double>(interWidth * interHeight);
+
+    if (interArea == 0) {
+        return 0.0;
+    }
+
+    double box1Area = static_cast<double>(r1.width() * r1.height());
+    double box2Area = static_cast<double>(r2.width() * r2.height());
+
+    double iou = interArea / (box1Area + box2Area - interArea);
+
+    return iou;
+}
+
+double ImageMatch::iou(int d, int g) const
+{
+    const auto begin = columns.constBegin() + rowBegin[d];
+    const auto end = columns.constBegin() + rowBegin[d + 1];
+    const auto it = std::lower_bound(begin, end, g);
+    return it != end && *it == g ? ious[it - columns.constBegin()] : 0.0;
+}
+
+ImageMatch ImageMatch::compute(QList<VocObject> gt, QList<VocObject> dt)
+{
+    ImageMatch match;
+    match.gt = std::move(gt);
+    match.dt = std::move(dt);
+    const int gtCount = int(match.gt.size());
+    const int dtCount = int(match.dt.size());
+
+    // GT 的坐标转成结构数组交给批量 IoU 核；类别名换成序号，比较时不用比字符串
+    const BoxArray gtBoxes = BoxArray::fromObjects(match.gt);
+    QHash<QString, int> classIds;
+    QVector<int> gtClass(gtCount);
+    for (int g = 0; g < gtCount; ++g) {
+        auto it = classIds.find(match.gt[g].name);
+        if (it == classIds.end()) {
+            it = classIds.insert(match.gt[g].name, int(classIds.size()));
+        }
+        gtClass[g] = it.value();
+    }
+
+    // 建 IoU 矩阵：GT 较多时用网格索引只取有重叠的同类别 GT，否则批量算一整行再挑出同类别的非零项
+    // 两种方式的候选都按 GT 序号升序，IoU 逐位相同，匹配结果与逐个比较完全一致
+    const bool useGrid = gtCount >= BoxGridIndex::kMinBoxes && dtCount > 0;
+    const BoxGridIndex grid = useGrid ? BoxGridIndex(match.gt) : BoxGridIndex();
+    QVector<int> candidates;
+    QVector<double> row(useGrid ? 0 : gtCount);
+    match.rowBegin.reserve(dtCount + 1);
+    match.rowBegin.append(0);
+    for (int d = 0; d < dtCount; ++d) {
+        const VocObject& dt_obj = match.dt[d];
+        const int dtClass = classIds.value(dt_obj.name, -1);
+        if (dtClass >= 0) { // 图片中没有这个类别的 GT 时整行为空
+            if (useGrid) {
+                grid.query(dt_obj.name, dt_obj.bndbox, candidates);
+                for (int g : std::as_const(candidates)) {
+                    match.columns.append(g);
+                    match.ious.append(IoUKernel::pair(gtBoxes, g, dt_obj.bndbox));
+                }
+            } else {
+                IoUKernel::row(gtBoxes, dt_obj.bndbox, row.data());
+                for (int g = 0; g < gtCount; ++g) {
+                    if (gtClass[g] == dtClass && row[g] > 0) {
+                        match.columns.append(g);
+                        match.ious.append(row[g]);
+                    }
+                }
+            }
+        }
+        match.rowBegin.append(int(match.columns.size()));
+    }
+
+    QVector<int> order(dtCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&match](int a, int b) {
+        return match.dt[a].score > match.dt[b].score;
+    });
+
+    // 一遍扫描：每个 DT 在每个阈值下各认领一次，矩阵中没有的 GT（IoU 为 0）在任何阈值下都不会被认领
+    // 阈值取 1 时也要能匹配完全重合的框，与 COCO 一样把阈值限制在 1 - 1e-10 以下
+    match.gtMatches = QVector<int>(kThresholdCount * gtCount, -1);
+    match.dtMatches = QVector<int>(kThresholdCount * dtCount, -1);
+    for (int d : std::as_const(order)) {
+        const int begin = match.rowBegin[d];
+        const int end = match.rowBegin[d + 1];
+        if (begin == end) {
+            continue;
+        }
+        for (int t = 0; t < kThresholdCount; ++t) {
+            int* gtMatched = match.gtMatches.data() + t * gtCount;
+            double best_iou = std::min(threshold(t), 1.0 - 1e-10);
+            int best_gt_match_idx = -1;
+            for (int k = begin; k < end; ++k) {
+                const int g = match.columns[k];
+                if (gtMatched[g] >= 0 || match.ious[k] < best_iou) { // 已被认领或 IoU 不够
+                    continue;
+                }
+                best_iou = match.ious[k];
+                best_gt_match_idx = g;
+            }
+            if (best_gt_match_idx >= 0) {
+                gtMatched[best_gt_match_idx] = d;
+                match.dtMatches[t * dtCount + d] = best_gt_match_idx;
+            }
+        }
+    }
+    return match;
+}
@@ -0,0 +1,43 @@
+#ifndef DETECTIONMATCHER_H
+#define DETECTIONMATCHER_H
+
+#include <QList>
+#include <QRect>
+#include <QVector>
+#include "vocParser.h"
+
+// 两个框的 IoU，坐标按 VOC 的闭区间像素计算（QRect 的 right() = x + width - 1）
+// 匹配时改用 IoUKernel 批量计算，这里保留为逐对计算的参考实现，基准测试用它做对照
+double calculateIoU(const QRect& r1, const QRect& r2);
+
+// 一张图片中 GT 与 DT 的匹配结果，界面画框和整个数据集的评估共用
+// IoU 矩阵只算一次，以压缩行（CSR）存储同类别、有重叠的 GT/DT 对，由它一次得到所有阈值下的匹配结果
+struct ImageMatch
+{
+    // IoU 阈值 0.50:0.05:0.95，与 COCO 的 mAP@[.5:.95] 相同
+    // 按百分数相除得到最接近 0.85 等十进制值的 double；0.5 + 0.05 * t 在 t = 7 时大了一个最低位，恰好 85/100 的 IoU 会被判为不够
+    static constexpr int kThresholdCount = 10;
+    static double threshold(int t) { return (50 + 5 * t) / 100.0; }
+
+    QList<VocObject> gt;
+    QList<VocObject> dt;
+
+    // 第 d 个 DT 的非零 IoU：GT 序号为 columns[rowBegin[d], rowBegin[d + 1])，按序号升序，值在 ious 中
+    QVector<int> rowBegin;
+    QVector<int> columns;
+    QVector<double> ious; // 与 calculateIoU 逐位一致，和 double 阈值直接比较
+
+    QVector<int> gtMatches; // [t * gt.size() + g]：阈值 t 下 gt[g] 匹配到的 dt 序号，-1 为漏检（FN）
+    QVector<int> dtMatches; // [t * dt.size() + d]：阈值 t 下 dt[d] 匹配到的 gt 序号，-1 为误检（FP）
+
+    int gtMatch(int t, int g) const { return gtMatches[t * gt.size() + g]; }
+    int dtMatch(int t, int d) const { return dtMatches[t * dt.size() + d]; }
+    // dt[d] 与 gt[g] 的 IoU，不同类别或没有重叠时为 0
+    double iou(int d, int g) const;
+
+    // 与 COCO 评估相同：DT 按置信度从高到低依次认领同类别、还没被认领、IoU 最大且达到阈值的 GT
+    // 置信度相同的 DT 按文件中的顺序；所有阈值在同一遍扫描中完成
+    static ImageMatch compute(QList<VocObject> gt, QList<VocObject> dt);
+};
+
+#endif // DETECTIONMATCHER_H
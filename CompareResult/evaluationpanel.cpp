@@ -0,0 +1,89 @@
+#include "evaluationpanel.h"
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QVBoxLayout>
+
+EvaluationPanel::EvaluationPanel(QWidget *parent)
+    : QWidget(parent)
+{
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    QHBoxLayout* topLayout = new QHBoxLayout();
+    labelSummary = new QLabel(this);
+    progressBar = new QProgressBar(this);
+    progressBar->setMaximumWidth(240);
+    progressBar->setVisible(false);
+    topLayout->addWidget(labelSummary);
+    topLayout->addStretch();
+    topLayout->addWidget(progressBar);
+    layout->addLayout(topLayout);
+
+    classTable = new QTableWidget(0, 9, this);
+    classTable->setHorizontalHeaderLabels(QStringList() << "类别" << "GT" << "TP" << "FP" << "FN"
+                                                        << "精确率" << "召回率" << "AP" << "AP@[.5:.95]");
+    classTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    classTable->verticalHeader()->setVisible(false);
+    classTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    classTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    layout->addWidget(classTable);
+
+    clear();
+}
+
+void EvaluationPanel::setProgress(int done, int total)
+{
+    progressBar->setVisible(true);
+    progressBar->setRange(0, total);
+    progressBar->setValue(done);
+    labelSummary->setText(QString("正在评估：%1 / %2 张图片").arg(done).arg(total));
+}
+
+void EvaluationPanel::setEvaluation(const DatasetEvaluation& evaluation)
+{
+    progressBar->setVisible(false);
+    classTable->setRowCount(0);
+    classTable->setRowCount(int(evaluation.classes.size()) + 1);
+    for (int i = 0; i < evaluation.classes.size(); ++i) {
+        setRow(i, evaluation.classes[i]);
+    }
+    setRow(int(evaluation.classes.size()), evaluation.total);
+
+    labelSummary->setText(QString("%1 张图片，IoU 阈值 %2：精确率 %3，召回率 %4，mAP %5；mAP@[.5:.95] %6")
+                              .arg(evaluation.images)
+                              .arg(evaluation.iouThreshold, 0, 'f', 2)
+                              .arg(evaluation.total.precision(), 0, 'f', 3)
+                              .arg(evaluation.total.recall(), 0, 'f', 3)
+                              .arg(evaluation.total.ap, 0, 'f', 3)
+                              .arg(evaluation.total.apRange, 0, 'f', 3));
+}
+
+void EvaluationPanel::setMessage(const QString& message)
+{
+    progressBar->setVisible(false);
+    labelSummary->setText(message);
+}
+
+void EvaluationPanel::clear()
+{
+    classTable->setRowCount(0);
+    setMessage("加载图片、GT 和 DT 目录后点击“评估全部”，统计每个类别的精确率、召回率和 AP");
+}
+
+void EvaluationPanel::setRow(int row, const ClassEvaluation& counts)
+{
+    const QStringList values{counts.name,
+                             QString::number(counts.gt),
+                             QString::number(counts.tp),
+                             QString::number(counts.fp),
+                             QString::number(counts.fn),
+                             QString::number(counts.precision(), 'f', 3),
+                             QString::number(counts.recall(), 'f', 3),
+                             counts.gt > 0 ? QString::number(counts.ap, 'f', 3) : QString("-"),
+                             counts.gt > 0 ? QString::number(counts.apRange, 'f', 3) : QString("-")};
+    for (int column = 0; column < values.size(); ++column) {
+        QTableWidgetItem* item = new QTableWidgetItem(values[column]);
+        item->setTextAlignment(column == 0 ? Qt::AlignLeft | Qt::AlignVCenter : Qt::AlignRight | Qt::AlignVCenter);
+        classTable->setItem(row, column, item);
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef EVALUATIONPANEL_H
+#define EVALUATIONPANEL_H
+
+#include <QLabel>
+#include <QProgressBar>
+#include <QTableWidget>
+#include <QWidget>
+#include "datasetevaluator.h"
+
+// 整个数据集的评估结果：每个类别一行 TP/FP/FN、精确率、召回率和 AP，最后一行为合计和 mAP
+class EvaluationPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit EvaluationPanel(QWidget *parent = nullptr);
+
+    void setProgress(int done, int total);
+    void setEvaluation(const DatasetEvaluation& evaluation);
+    void setMessage(const QString& message);
+    void clear();
+
+private:
+    void setRow(int row, const ClassEvaluation& counts);
+
+    QLabel *labelSummary = nullptr;
+    QProgressBar *progressBar = nullptr;
+    QTableWidget *classTable = nullptr;
+};
+
+#endif // EVALUATIONPANEL_H
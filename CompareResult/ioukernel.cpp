@@ -0,0 +1,125 @@
+#include "ioukernel.h"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COMPARERESULT_IOU_SSE2 1
+#endif
+
+namespace {
+
+struct Query
+{
+    double x1;
+    double y1;
+    double x2;
+    double y2;
+    double area;
+};
+
+Query toQuery(const QRect& box)
+{
+    Query q;
+    q.x1 = double(box.left());
+    q.y1 = double(box.top());
+    q.x2 = double(box.right()) + 1;
+    q.y2 = double(box.bottom()) + 1;
+    q.area = (q.x2 - q.x1) * (q.y2 - q.y1);
+    return q;
+}
+
+// 与 calculateIoU 相同的运算顺序：先求交集，再 (面积 + 面积) - 交集，最后相除；没有交集时为 0
+inline double iouAt(const BoxArray& boxes, int i, const Query& q)
+{
+    const double iw = std::max(0.0, std::min(boxes.x2[i], q.x2) - std::max(boxes.x1[i], q.x1));
+    const double ih = std::max(0.0, std::min(boxes.y2[i], q.y2) - std::max(boxes.y1[i], q.y1));
+    const double inter = iw * ih;
+    if (inter == 0) {
+        return 0.0;
+    }
+    return inter / ((boxes.area[i] + q.area) - inter);
+}
+
+} // namespace
+
+void BoxArray::reserve(int count)
+{
+    x1.reserve(count);
+    y1.reserve(count);
+    x2.reserve(count);
+    y2.reserve(count);
+    area.reserve(count);
+}
+
+void BoxArray::append(const QRect& box)
+{
+    const Query q = toQuery(box);
+    x1.append(q.x1);
+    y1.append(q.y1);
+    x2.append(q.x2);
+    y2.append(q.y2);
+    area.append(q.area);
+}
+
+BoxArray BoxArray::fromObjects(const QList<VocObject>& objects)
+{
+    BoxArray boxes;
+    boxes.reserve(int(objects.size()));
+    for (const VocObject& obj : objects) {
+        boxes.append(obj.bndbox);
+    }
+    return boxes;
+}
+
+void IoUKernel::rowScalar(const BoxArray& boxes, const QRect& query, double* out)
+{
+    const Query q = toQuery(query);
+    for (int i = 0; i < boxes.size(); ++i) {
+        out[i] = iouAt(boxes, i, q);
+    }
+}
+
+void IoUKernel::row(const BoxArray& boxes, const QRect& query, double* out)
+{
+#ifdef COMPARERESULT_IOU_SSE2
+    const Query q = toQuery(query);
+    const int n = boxes.size();
+    const __m128d qx1 = _mm_set1_pd(q.x1);
+    const __m128d qy1 = _mm_set1_pd(q.y1);
+    const __m128d qx2 = _mm_set1_pd(q.x2);
+    const __m128d qy2 = _mm_set1_pd(q.y2);
+    const __m128d qarea = _mm_set1_pd(q.area);
+    const __m128d zero = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        const __m128d iw = _mm_max_pd(zero, _mm_sub_pd(_mm_min_pd(_mm_loadu_pd(boxes.x2.constData() + i), qx2),
+                                                       _mm_max_pd(_mm_loadu_pd(boxes.x1.constData() + i), qx1)));
+        const __m128d ih = _mm_max_pd(zero, _mm_sub_pd(_mm_min_pd(_mm_loadu_pd(boxes.y2.constData() + i), qy2),
+                                                       _mm_max_pd(_mm_loadu_pd(boxes.y1.constData() + i), qy1)));
+        const __m128d inter = _mm_mul_pd(iw, ih);
+        const __m128d uni = _mm_sub_pd(_mm_add_pd(_mm_loadu_pd(boxes.area.constData() + i), qarea), inter);
+        // 没有交集时为 0，两个框面积都为 0 时 0/0 的 NaN 也在这里去掉
+        const __m128d overlap = _mm_cmpneq_pd(inter, zero);
+        _mm_storeu_pd(out + i, _mm_and_pd(overlap, _mm_div_pd(inter, uni)));
+    }
+    for (; i < n; ++i) {
+        out[i] = iouAt(boxes, i, q);
+    }
+#else
+    rowScalar(boxes, query, out);
+#endif
+}
+
+double IoUKernel::pair(const BoxArray& boxes, int index, const QRect& query)
+{
+    return iouAt(boxes, index, toQuery(query));
+}
+
+bool IoUKernel::hasSimd()
+{
+#ifdef COMPARERESULT_IOU_SSE2
+    return true;
+#else
+    return false;
+#endif
+}
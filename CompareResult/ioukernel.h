@@ -0,0 +1,43 @@
+#ifndef IOUKERNEL_H
+#define IOUKERNEL_H
+
+#include <QList>
+#include <QRect>
+#include <QVector>
+#include "vocParser.h"
+
+// 一组框的结构数组（SoA）：每个坐标一列，批量计算 IoU 时可以一次读入连续的几个框
+// 坐标换成半开区间 [x1, x2) × [y1, y2)，x2 = right() + 1，与 calculateIoU 的闭区间像素算法一致
+// 用 double 存放：坐标和面积都是整数，double 可以精确表示，交集、并集也不会有舍入误差
+struct BoxArray
+{
+    QVector<double> x1;
+    QVector<double> y1;
+    QVector<double> x2;
+    QVector<double> y2;
+    QVector<double> area;
+
+    int size() const { return int(x1.size()); }
+    void reserve(int count);
+    void append(const QRect& box);
+
+    static BoxArray fromObjects(const QList<VocObject>& objects);
+};
+
+// 批量计算 IoU：一个框对一组框得到 IoU 矩阵的一行，逐个 DT 调用即得到整个矩阵
+// 有 SSE2 时一次算 2 个框，否则用标量版本；交集和并集都是精确的整数，只在最后相除时舍入一次，
+// 所以结果与 calculateIoU 逐位一致，和 double 阈值比较不会因为精度不同而改变匹配结果
+class IoUKernel
+{
+public:
+    // out[i] = IoU(boxes[i], query)，out 至少有 boxes.size() 个元素
+    static void row(const BoxArray& boxes, const QRect& query, double* out);
+    static void rowScalar(const BoxArray& boxes, const QRect& query, double* out);
+
+    // 单个框的 IoU，与 row 的结果逐位一致，只需要少数几个框时使用
+    static double pair(const BoxArray& boxes, int index, const QRect& query);
+
+    static bool hasSimd();
+};
+
+#endif // IOUKERNEL_H
@@ -0,0 +1,207 @@
+#include "pathtable.h"
+#include <QVarLengthArray>
+
+PathTable::PathTable()
+{
+    directories_.append({-1, internName(QString())}); // kRootDirectory
+}
+
+void PathTable::clear()
+{
+    QWriteLocker locker(&lock_);
+    names_.clear();
+    nameIds_.clear();
+    directories_.clear();
+    childDirectories_.clear();
+    entries_.clear();
+    entryIds_.clear();
+    lastDirectoryPath_.clear();
+    lastDirectory_ = kRootDirectory;
+    directories_.append({-1, internName(QString())}); // kRootDirectory
+}
+
+PathId PathTable::add(const QString& path)
+{
+    QWriteLocker locker(&lock_);
+    return addLocked(path);
+}
+
+QVector<PathId> PathTable::addAll(const QVector<QString>& paths)
+{
+    QVector<PathId> ids;
+    ids.reserve(paths.size());
+    QWriteLocker locker(&lock_);
+    for (const QString& path : paths) {
+        ids.append(addLocked(path));
+    }
+    return ids;
+}
+
+PathId PathTable::addLocked(const QString& path)
+{
+    const qsizetype slash = path.lastIndexOf('/');
+    int directory = kRootDirectory;
+    if (slash >= 0) {
+        const QStringView prefix = QStringView(path).left(slash + 1); // 包含结尾的 '/'
+        if (prefix == lastDirectoryPath_) {
+            directory = lastDirectory_;
+        } else {
+            lastDirectoryPath_ = prefix.toString();
+            directory = lastDirectory_ = directoryForLocked(lastDirectoryPath_);
+        }
+    }
+
+    const int name = internName(path.mid(slash + 1));
+    auto it = entryIds_.constFind(key(directory, name));
+    if (it != entryIds_.constEnd()) {
+        return it.value();
+    }
+    const PathId id = PathId(entries_.size());
+    entries_.append({directory, name});
+    entryIds_.insert(key(directory, name), id);
+    return id;
+}
+
+int PathTable::internName(const QString& name)
+{
+    auto it = nameIds_.constFind(name);
+    if (it != nameIds_.constEnd()) {
+        return it.value();
+    }
+    const int id = int(names_.size());
+    names_.append(name);
+    nameIds_.insert(name, id);
+    return id;
+}
+
+int PathTable::directoryForLocked(const QString& dirPath)
+{
+    // dirPath 以 '/' 结尾，按 '/' 逐段沿前缀树向下查找，没有的目录就新建
+    int directory = kRootDirectory;
+    qsizetype begin = 0;
+    while (begin < dirPath.size()) {
+        const qsizetype end = dirPath.indexOf('/', begin);
+        const int name = internName(dirPath.mid(begin, end - begin));
+        auto it = childDirectories_.constFind(key(directory, name));
+        if (it == childDirectories_.constEnd()) {
+            it = childDirectories_.insert(key(directory, name), int(directories_.size()));
+            directories_.append({directory, name});
+        }
+        directory = it.value();
+        begin = end + 1;
+    }
+    return directory;
+}
+
+int PathTable::findDirectoryLocked(QStringView dirPath) const
+{
+    int directory = kRootDirectory;
+    qsizetype begin = 0;
+    while (begin < dirPath.size()) {
+        const qsizetype end = dirPath.indexOf(QLatin1Char('/'), begin);
+        const int name = nameIds_.value(dirPath.mid(begin, end - begin).toString(), -1);
+        const int child = name >= 0 ? childDirectories_.value(key(directory, name), -1) : -1;
+        if (child < 0) {
+            return -1;
+        }
+        directory = child;
+        begin = end + 1;
+    }
+    return directory;
+}
+
+void PathTable::appendDirectoryPath(int directory, QString& out) const
+{
+    QVarLengthArray<int, 32> chain;
+    qsizetype length = out.size();
+    for (int d = directory; d != kRootDirectory; d = directories_[d].parent) {
+        chain.append(d);
+        length += names_[directories_[d].name].size() + 1;
+    }
+    out.reserve(length);
+    for (qsizetype i = chain.size() - 1; i >= 0; --i) {
+        out += names_[directories_[chain[i]].name];
+        out += QLatin1Char('/');
+    }
+}
+
+PathId PathTable::find(const QString& path) const
+{
+    QReadLocker locker(&lock_);
+    const qsizetype slash = path.lastIndexOf('/');
+    const int directory = slash >= 0 ? findDirectoryLocked(QStringView(path).left(slash + 1)) : kRootDirectory;
+    const int name = directory >= 0 ? nameIds_.value(path.mid(slash + 1), -1) : -1;
+    return name >= 0 ? entryIds_.value(key(directory, name), -1) : -1;
+}
+
+QString PathTable::path(PathId id) const
+{
+    QReadLocker locker(&lock_);
+    return pathLocked(id);
+}
+
+QVector<QString> PathTable::paths(QVector<PathId>::const_iterator begin, QVector<PathId>::const_iterator end) const
+{
+    QVector<QString> result;
+    result.reserve(end - begin);
+    QReadLocker locker(&lock_);
+    for (auto it = begin; it != end; ++it) {
+        result.append(pathLocked(*it));
+    }
+    return result;
+}
+
+QString PathTable::pathLocked(PathId id) const
+{
+    const Entry& entry = entries_.at(id);
+    const QString& name = names_[entry.name];
+    QString result;
+    result.reserve(name.size() + 64);
+    appendDirectoryPath(entry.directory, result);
+    result += name;
+    return result;
+}
+
+QString PathTable::fileName(PathId id) const
+{
+    QReadLocker locker(&lock_);
+    return names_[entries_.at(id).name];
+}
+
+int PathTable::directory(PathId id) const
+{
+    QReadLocker locker(&lock_);
+    return entries_.at(id).directory;
+}
+
+QString PathTable::directoryPath(int directory) const
+{
+    QReadLocker locker(&lock_);
+    QString result;
+    appendDirectoryPath(directory, result);
+    return result;
+}
+
+int PathTable::parentDirectory(int directory) const
+{
+    QReadLocker locker(&lock_);
+    return directories_.at(directory).parent;
+}
+
+QString PathTable::directoryName(int directory) const
+{
+    QReadLocker locker(&lock_);
+    return names_[directories_.at(directory).name];
+}
+
+int PathTable::size() const
+{
+    QReadLocker locker(&lock_);
+    return int(entries_.size());
+}
+
+int PathTable::directoryCount() const
+{
+    QReadLocker locker(&lock_);
+    return int(directories_.size());
+}
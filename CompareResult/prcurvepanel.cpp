@@ -0,0 +1,74 @@
+#include "prcurvepanel.h"
+#include <QHBoxLayout>
+
+PrCurvePanel::PrCurvePanel(QWidget *parent)
+    : QWidget(parent)
+{
+    QHBoxLayout* layout = new QHBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    classList = new QListWidget(this);
+    classList->setMaximumWidth(220);
+    curveView = new PrCurveView(this);
+    layout->addWidget(classList);
+    layout->addWidget(curveView, 1);
+
+    connect(classList, &QListWidget::itemChanged, this, &PrCurvePanel::updateCurves);
+}
+
+void PrCurvePanel::setEvaluation(const DatasetEvaluation& evaluation)
+{
+    evaluation_ = evaluation;
+
+    const QSignalBlocker blocker(classList);
+    classList->clear();
+    // 第一项为合计，之后每个有 GT 的类别一项；UserRole 为类别序号，合计为 -1
+    auto addItem = [this](const ClassEvaluation& counts, int classIndex, bool checked) {
+        QListWidgetItem* item = new QListWidgetItem(QString("%1 (AP %2)").arg(counts.name).arg(counts.ap, 0, 'f', 3),
+                                                    classList);
+        item->setData(Qt::UserRole, classIndex);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(checked ? Qt::Checked : Qt::Unchecked);
+    };
+    int classesWithGt = 0;
+    for (const ClassEvaluation& counts : std::as_const(evaluation_.classes)) {
+        if (counts.gt > 0) {
+            ++classesWithGt;
+        }
+    }
+    addItem(evaluation_.total, -1, true);
+    for (int i = 0; i < evaluation_.classes.size(); ++i) {
+        if (evaluation_.classes[i].gt > 0) {
+            addItem(evaluation_.classes[i], i, classesWithGt <= kDefaultCurves);
+        }
+    }
+    updateCurves();
+}
+
+void PrCurvePanel::clear()
+{
+    evaluation_ = DatasetEvaluation();
+    classList->clear();
+    updateCurves();
+}
+
+void PrCurvePanel::updateCurves()
+{
+    QVector<PrCurveView::Curve> curves;
+    for (int row = 0; row < classList->count(); ++row) {
+        const QListWidgetItem* item = classList->item(row);
+        if (item->checkState() != Qt::Checked) {
+            continue;
+        }
+        const int classIndex = item->data(Qt::UserRole).toInt();
+        const ClassEvaluation& counts = classIndex < 0 ? evaluation_.total : evaluation_.classes[classIndex];
+        PrCurveView::Curve curve;
+        curve.name = counts.name;
+        // 合计用黑色，各类别按行号在色环上取色
+        curve.color = classIndex < 0 ? palette().text().color() : QColor::fromHsv((row * 47) % 360, 200, 200);
+        curve.points = counts.curve;
+        curve.ap = counts.ap;
+        curves.append(curve);
+    }
+    curveView->setCurves(curves);
+}
@@ -0,0 +1,32 @@
+#ifndef PRCURVEPANEL_H
+#define PRCURVEPANEL_H
+
+#include <QListWidget>
+#include <QWidget>
+#include "datasetevaluator.h"
+#include "prcurveview.h"
+
+// "PR 曲线" 面板：左侧勾选类别（第一项为所有类别合计），右侧画出选中类别的曲线
+class PrCurvePanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kDefaultCurves = 8; // 类别较少时默认全部显示，否则只显示合计
+
+    explicit PrCurvePanel(QWidget *parent = nullptr);
+
+    void setEvaluation(const DatasetEvaluation& evaluation);
+    void clear();
+
+private slots:
+    void updateCurves();
+
+private:
+    DatasetEvaluation evaluation_;
+
+    QListWidget *classList = nullptr;
+    PrCurveView *curveView = nullptr;
+};
+
+#endif // PRCURVEPANEL_H
@@ -0,0 +1,102 @@
+#include "prcurveview.h"
+#include <QPainter>
+#include <QPainterPath>
+#include <algorithm>
+
+PrCurveView::PrCurveView(QWidget *parent)
+    : QWidget(parent)
+{
+    setMinimumSize(240, 180);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+}
+
+void PrCurveView::setCurves(const QVector<Curve>& curves)
+{
+    curves_ = curves;
+    update();
+}
+
+void PrCurveView::paintEvent(QPaintEvent* event)
+{
+    Q_UNUSED(event);
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.fillRect(rect(), palette().base());
+
+    const QFontMetrics metrics = painter.fontMetrics();
+    const int left = metrics.horizontalAdvance("0.0") + 12;
+    const int bottom = metrics.height() * 2 + 8;
+    const QRectF plot(left, 8, width() - left - 12, height() - bottom - 8);
+    if (plot.width() <= 0 || plot.height() <= 0) {
+        return;
+    }
+    auto toWidget = [&plot](const QPointF& p) {
+        return QPointF(plot.left() + p.x() * plot.width(), plot.bottom() - p.y() * plot.height());
+    };
+
+    // 网格和刻度
+    painter.setPen(QPen(palette().mid().color(), 1, Qt::DotLine));
+    for (int i = 0; i <= 10; ++i) {
+        const double t = i / 10.0;
+        painter.drawLine(toWidget(QPointF(t, 0)), toWidget(QPointF(t, 1)));
+        painter.drawLine(toWidget(QPointF(0, t)), toWidget(QPointF(1, t)));
+    }
+    painter.setPen(palette().text().color());
+    painter.drawRect(plot);
+    for (int i = 0; i <= 10; i += 2) {
+        const QString text = QString::number(i / 10.0, 'f', 1);
+        const QPointF x = toWidget(QPointF(i / 10.0, 0));
+        painter.drawText(QRectF(x.x() - 20, plot.bottom() + 2, 40, metrics.height()), Qt::AlignCenter, text);
+        const QPointF y = toWidget(QPointF(0, i / 10.0));
+        painter.drawText(QRectF(0, y.y() - metrics.height() / 2.0, left - 4, metrics.height()),
+                         Qt::AlignRight | Qt::AlignVCenter, text);
+    }
+    painter.drawText(QRectF(plot.left(), plot.bottom() + metrics.height() + 4, plot.width(), metrics.height()),
+                     Qt::AlignCenter, "召回率");
+
+    if (curves_.isEmpty()) {
+        painter.drawText(plot, Qt::AlignCenter, "评估完成后在左侧选择要显示的类别");
+        return;
+    }
+
+    // 曲线：点数可能有几十万，落在同一个像素上的点只画一次
+    for (const Curve& curve : std::as_const(curves_)) {
+        if (curve.points.isEmpty()) {
+            continue;
+        }
+        QPainterPath path(toWidget(QPointF(0, curve.points.first().y())));
+        QPoint last(-1, -1);
+        for (const QPointF& p : curve.points) {
+            const QPointF w = toWidget(p);
+            const QPoint pixel = w.toPoint();
+            if (pixel != last) {
+                path.lineTo(w);
+                last = pixel;
+            }
+        }
+        path.lineTo(toWidget(curve.points.last())); // 最后一个点总是画到
+        painter.setPen(QPen(curve.color, 2));
+        painter.drawPath(path);
+    }
+
+    // 图例
+    const int lineHeight = metrics.height() + 2;
+    int legendWidth = 0;
+    QStringList texts;
+    for (const Curve& curve : std::as_const(curves_)) {
+        texts << QString("%1  AP %2").arg(curve.name).arg(curve.ap, 0, 'f', 3);
+        legendWidth = std::max(legendWidth, metrics.horizontalAdvance(texts.last()));
+    }
+    const QRectF legend(plot.right() - legendWidth - 36, plot.top() + 4, legendWidth + 32, lineHeight * texts.size() + 4);
+    painter.setPen(palette().mid().color());
+    painter.setBrush(palette().base());
+    painter.drawRect(legend);
+    for (int i = 0; i < texts.size(); ++i) {
+        const double y = legend.top() + 2 + i * lineHeight + lineHeight / 2.0;
+        painter.setPen(QPen(curves_[i].color, 2));
+        painter.drawLine(QPointF(legend.left() + 4, y), QPointF(legend.left() + 22, y));
+        painter.setPen(palette().text().color());
+        painter.drawText(QRectF(legend.left() + 26, y - lineHeight / 2.0, legendWidth + 4, lineHeight),
+                         Qt::AlignLeft | Qt::AlignVCenter, texts[i]);
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef PRCURVEVIEW_H
+#define PRCURVEVIEW_H
+
+#include <QColor>
+#include <QPointF>
+#include <QString>
+#include <QVector>
+#include <QWidget>
+
+// 画 PR 曲线：横轴召回率，纵轴精确率，都是 0 到 1；右上角为图例和 AP
+class PrCurveView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    struct Curve
+    {
+        QString name;
+        QColor color;
+        QVector<QPointF> points; // (召回率, 精确率)，召回率递增
+        double ap = 0;
+    };
+
+    explicit PrCurveView(QWidget *parent = nullptr);
+
+    void setCurves(const QVector<Curve>& curves);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+
+private:
+    QVector<Curve> curves_;
+};
+
+#endif // PRCURVEVIEW_H
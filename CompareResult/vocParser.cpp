@@ -37,6 +37,22 @@ QList<VocObject> VocParser::parseObjects(const QString& filePath)
         VocObject obj;
         obj.name = getElementText(objectElement, "name");
 
+        // 检测结果的 XML 可能带置信度，GT 没有
+        QString scoreText = getElementText(objectElement, "score");
+        if (scoreText.isEmpty()) {
+            scoreText = getElementText(objectElement, "confidence");
+        }
+        if (!scoreText.isEmpty()) {
+            bool ok = false;
+            const float score = scoreText.toFloat(&ok);
+            if (ok) {
+                obj.score = score;
+                obj.hasScore = true;
+            } else {
+                qWarning() << "Warning: Invalid score" << scoreText << "in" << filePath << "for object" << obj.name;
+            }
+        }
+
         QDomElement bndboxElement = objectElement.firstChildElement("bndbox");
         if (!bndboxElement.isNull()) {
             int xmin = (int)getElementFloat(bndboxElement, "xmin");
@@ -11,6 +11,8 @@ struct VocObject
 {
     QString name;
     QRect   bndbox;
+    float   score = 1.0f;     // 检测结果的置信度，读自 <score> 或 <confidence>
+    bool    hasScore = false; // 没有置信度时 score 为 1，所有检测同分
 };
 
 class VocParser
@@ -1,4 +1,4 @@
-QT       += core gui xml
+QT       += core gui xml concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -9,15 +9,56 @@ CONFIG += c++17
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    annotationquery.cpp \
+    annotationreader.cpp \
+    annotationstore.cpp \
+    cocoreader.cpp \
+    datasetsample.cpp \
+    datasetwatcher.cpp \
+    directorypanel.cpp \
+    directorystats.cpp \
+    geometrypanel.cpp \
+    geometrystats.cpp \
+    histogram.cpp \
+    labelcountmodel.cpp \
     main.cpp \
     mainwindow.cpp \
+    parsecache.cpp \
+    parsereport.cpp \
+    pathtable.cpp \
+    qualitypanel.cpp \
+    querypanel.cpp \
+    vocfastscanner.cpp \
     vocParser.cpp \
-    xmlprocessor.cpp
+    xmlprocessor.cpp \
+    xmlscanner.cpp \
+    yoloreader.cpp
 
 HEADERS += \
+    annotationquery.h \
+    annotationreader.h \
+    annotationstore.h \
+    cocoreader.h \
+    datasetsample.h \
+    datasetstats.h \
+    datasetwatcher.h \
+    directorypanel.h \
+    directorystats.h \
+    geometrypanel.h \
+    geometrystats.h \
+    histogram.h \
+    labelcountmodel.h \
     mainwindow.h \
+    parsecache.h \
+    parsereport.h \
+    pathtable.h \
+    qualitypanel.h \
+    querypanel.h \
+    vocfastscanner.h \
     vocParser.h \
-    xmlprocessor.h
+    xmlprocessor.h \
+    xmlscanner.h \
+    yoloreader.h
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
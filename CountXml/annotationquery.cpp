@@ -0,0 +1,581 @@
+#include "annotationquery.h"
+#include "annotationstore.h"
+#include <QSaveFile>
+#include <QtAlgorithms>
+#include <algorithm>
+
+// ---------------- AnnotationIndex ----------------
+
+AnnotationIndex AnnotationIndex::build(const AnnotationStore& store)
+{
+    AnnotationIndex index;
+    index.fileCount_ = store.fileCount();
+    index.postings_.resize(store.labelCount());
+    const QVector<qint64>& labelBoxCounts = store.labelBoxCounts();
+    for (int label = 0; label < store.labelCount(); ++label) {
+        // 框数是图片数的上界，按它预留可以避免反复扩容
+        index.postings_[label].files.reserve(qMin<qint64>(labelBoxCounts[label], index.fileCount_));
+    }
+
+    const int* labelIds = store.labelIds().constData();
+    for (int file = 0; file < index.fileCount_; ++file) {
+        const qsizetype begin = store.fileBegin(file);
+        const qsizetype end = begin + store.fileBoxCount(file);
+        for (qsizetype b = begin; b < end; ++b) {
+            Posting& posting = index.postings_[labelIds[b]];
+            if (posting.files.isEmpty() || posting.files.last() != file) {
+                posting.files.append(file);
+                posting.counts.append(1);
+            } else {
+                ++posting.counts.last();
+            }
+        }
+    }
+    return index;
+}
+
+void AnnotationIndex::removeFile(const AnnotationStore& store, int file)
+{
+    const int* labelIds = store.labelIds().constData();
+    const qsizetype begin = store.fileBegin(file);
+    for (qsizetype b = begin; b < begin + store.fileBoxCount(file); ++b) {
+        if (labelIds[b] >= postings_.size()) {
+            continue;
+        }
+        Posting& posting = postings_[labelIds[b]];
+        const auto it = std::lower_bound(posting.files.begin(), posting.files.end(), file);
+        if (it != posting.files.end() && *it == file) { // 同一标签的其他框已经删过
+            const qsizetype i = it - posting.files.begin();
+            posting.files.remove(i);
+            posting.counts.remove(i);
+        }
+    }
+}
+
+void AnnotationIndex::addFile(const AnnotationStore& store, int file)
+{
+    if (postings_.size() < store.labelCount()) {
+        postings_.resize(store.labelCount());
+    }
+    const int* labelIds = store.labelIds().constData();
+    const qsizetype begin = store.fileBegin(file);
+    for (qsizetype b = begin; b < begin + store.fileBoxCount(file); ++b) {
+        Posting& posting = postings_[labelIds[b]];
+        const auto it = std::lower_bound(posting.files.begin(), posting.files.end(), file);
+        const qsizetype i = it - posting.files.begin();
+        if (it != posting.files.end() && *it == file) {
+            ++posting.counts[i];
+        } else {
+            posting.files.insert(i, file);
+            posting.counts.insert(i, 1);
+        }
+    }
+}
+
+const AnnotationIndex::Posting& AnnotationIndex::posting(int labelId) const
+{
+    static const Posting empty;
+    return labelId >= 0 && labelId < postings_.size() ? postings_[labelId] : empty;
+}
+
+// ---------------- FileSet ----------------
+
+// 文件序号的位图，条件之间的 and/or/not 按 64 位字整体运算
+class AnnotationQuery::FileSet
+{
+public:
+    explicit FileSet(int size, bool filled = false)
+        : size_(size), words_((size + 63) / 64, filled ? ~quint64(0) : 0)
+    {
+        clearTail();
+    }
+
+    void set(int i) { words_[i >> 6] |= quint64(1) << (i & 63); }
+    void assign(int i, bool value)
+    {
+        const quint64 bit = quint64(1) << (i & 63);
+        words_[i >> 6] = value ? (words_[i >> 6] | bit) : (words_[i >> 6] & ~bit);
+    }
+
+    void intersect(const FileSet& other)
+    {
+        for (qsizetype w = 0; w < words_.size(); ++w) {
+            words_[w] &= other.words_[w];
+        }
+    }
+    void unite(const FileSet& other)
+    {
+        for (qsizetype w = 0; w < words_.size(); ++w) {
+            words_[w] |= other.words_[w];
+        }
+    }
+    void invert()
+    {
+        for (quint64& word : words_) {
+            word = ~word;
+        }
+        clearTail();
+    }
+
+    QVector<int> toIndices() const
+    {
+        QVector<int> indices;
+        for (qsizetype w = 0; w < words_.size(); ++w) {
+            quint64 word = words_[w];
+            while (word) {
+                indices.append(int(w * 64 + qCountTrailingZeroBits(word)));
+                word &= word - 1; // 去掉最低位的 1
+            }
+        }
+        return indices;
+    }
+
+private:
+    // 最后一个字中超出 size_ 的位始终为 0
+    void clearTail()
+    {
+        if (size_ % 64 != 0 && !words_.isEmpty()) {
+            words_.last() &= (quint64(1) << (size_ % 64)) - 1;
+        }
+    }
+
+    int size_;
+    QVector<quint64> words_;
+};
+
+// ---------------- Parser ----------------
+
+class AnnotationQuery::Parser
+{
+public:
+    Parser(const QString& text, QVector<Node>& nodes) : text_(text), nodes_(nodes) {}
+
+    // 返回根节点下标，失败时返回 -1 并设置 error
+    int parseAll(QString& error)
+    {
+        next();
+        const int root = parseOr();
+        if (root >= 0 && token_.type != Token::End) {
+            fail("多余的内容");
+        }
+        error = error_;
+        return error_.isEmpty() ? root : -1;
+    }
+
+private:
+    struct Token
+    {
+        enum Type { End, Word, Quoted, Op, LParen, RParen, And, Or, Not };
+        Type type = End;
+        QString text;
+        Compare op = Compare::Equal;
+        int pos = 0;
+    };
+
+    static bool isDelimiter(QChar c)
+    {
+        return c.isSpace() || c == '(' || c == ')' || c == '<' || c == '>' || c == '=' || c == '!'
+               || c == '&' || c == '|' || c == '"';
+    }
+
+    void next()
+    {
+        while (pos_ < text_.size() && text_[pos_].isSpace()) {
+            ++pos_;
+        }
+        token_ = Token();
+        token_.pos = pos_;
+        if (pos_ >= text_.size()) {
+            return;
+        }
+
+        const QChar c = text_[pos_];
+        const QChar following = pos_ + 1 < text_.size() ? text_[pos_ + 1] : QChar();
+        if (c == '(' || c == ')') {
+            token_.type = c == '(' ? Token::LParen : Token::RParen;
+            ++pos_;
+        } else if (c == '&' && following == '&') {
+            token_.type = Token::And;
+            pos_ += 2;
+        } else if (c == '|' && following == '|') {
+            token_.type = Token::Or;
+            pos_ += 2;
+        } else if (c == '<' || c == '>' || c == '=' || c == '!') {
+            const bool withEqual = following == '=';
+            pos_ += withEqual ? 2 : 1;
+            token_.type = Token::Op;
+            if (c == '<') {
+                token_.op = withEqual ? Compare::LessEqual : Compare::Less;
+            } else if (c == '>') {
+                token_.op = withEqual ? Compare::GreaterEqual : Compare::Greater;
+            } else if (c == '=') {
+                token_.op = Compare::Equal;
+            } else if (withEqual) {
+                token_.op = Compare::NotEqual;
+            } else {
+                token_.type = Token::Not;
+            }
+        } else if (c == '"') {
+            const int close = text_.indexOf('"', pos_ + 1);
+            if (close < 0) {
+                fail("缺少右引号");
+                pos_ = text_.size();
+                return;
+            }
+            token_.type = Token::Quoted;
+            token_.text = text_.mid(pos_ + 1, close - pos_ - 1);
+            pos_ = close + 1;
+        } else if (c == '&' || c == '|') {
+            fail(QString("无法识别的字符 %1").arg(c));
+            pos_ = text_.size();
+        } else {
+            const int begin = pos_;
+            while (pos_ < text_.size() && !isDelimiter(text_[pos_])) {
+                ++pos_;
+            }
+            token_.text = text_.mid(begin, pos_ - begin);
+            const QString lower = token_.text.toLower();
+            token_.type = lower == "and" ? Token::And : lower == "or" ? Token::Or : lower == "not" ? Token::Not : Token::Word;
+        }
+    }
+
+    void fail(const QString& message)
+    {
+        if (error_.isEmpty()) {
+            error_ = QString("第 %1 个字符：%2").arg(token_.pos + 1).arg(message);
+        }
+    }
+
+    int addNode(const Node& node)
+    {
+        nodes_.append(node);
+        return nodes_.size() - 1;
+    }
+
+    int parseOr()
+    {
+        int left = parseAnd();
+        while (left >= 0 && token_.type == Token::Or) {
+            next();
+            const int right = parseAnd();
+            if (right < 0) {
+                return -1;
+            }
+            Node node;
+            node.kind = Kind::Or;
+            node.left = left;
+            node.right = right;
+            left = addNode(node);
+        }
+        return left;
+    }
+
+    int parseAnd()
+    {
+        int left = parseUnary();
+        while (left >= 0) {
+            if (token_.type == Token::And) {
+                next();
+            } else if (token_.type != Token::Word && token_.type != Token::Not && token_.type != Token::LParen) {
+                break; // 相邻的条件默认为 and
+            }
+            const int right = parseUnary();
+            if (right < 0) {
+                return -1;
+            }
+            Node node;
+            node.kind = Kind::And;
+            node.left = left;
+            node.right = right;
+            left = addNode(node);
+        }
+        return left;
+    }
+
+    int parseUnary()
+    {
+        if (token_.type == Token::Not) {
+            next();
+            const int operand = parseUnary();
+            if (operand < 0) {
+                return -1;
+            }
+            Node node;
+            node.kind = Kind::Not;
+            node.left = operand;
+            return addNode(node);
+        }
+        if (token_.type == Token::LParen) {
+            next();
+            const int inner = parseOr();
+            if (inner < 0) {
+                return -1;
+            }
+            if (token_.type != Token::RParen) {
+                fail("缺少右括号");
+                return -1;
+            }
+            next();
+            return inner;
+        }
+        return parseCondition();
+    }
+
+    int parseCondition()
+    {
+        if (token_.type != Token::Word) {
+            fail(token_.type == Token::End ? "表达式不完整" : "这里应该是一个条件");
+            return -1;
+        }
+
+        struct ConditionInfo
+        {
+            const char* name;
+            Kind kind;
+            int label;     // 0 不接受标签，1 必须有标签，2 标签可选
+            bool compare;  // 是否需要 OP n
+        };
+        static const ConditionInfo kConditions[] = {
+            {"objects", Kind::Objects, 0, true},
+            {"width", Kind::Width, 0, true},
+            {"height", Kind::Height, 0, true},
+            {"has", Kind::Has, 1, false},
+            {"count", Kind::Count, 1, true},
+            {"minside", Kind::MinSide, 2, true},
+            {"maxside", Kind::MaxSide, 2, true},
+        };
+        const QString name = token_.text.toLower();
+        const ConditionInfo* info = nullptr;
+        for (const ConditionInfo& candidate : kConditions) {
+            if (name == QLatin1String(candidate.name)) {
+                info = &candidate;
+            }
+        }
+        if (!info) {
+            fail(QString("未知的条件 %1").arg(token_.text));
+            return -1;
+        }
+        next();
+
+        Node node;
+        node.kind = info->kind;
+        if (token_.type == Token::LParen && info->label != 0) {
+            next();
+            if (token_.type != Token::Word && token_.type != Token::Quoted) {
+                fail("这里应该是标签名");
+                return -1;
+            }
+            node.label = token_.text;
+            next();
+            if (token_.type != Token::RParen) {
+                fail("缺少右括号");
+                return -1;
+            }
+            next();
+        } else if (info->label == 1) {
+            fail(QString("%1 需要标签，例如 %1(person)").arg(name));
+            return -1;
+        }
+
+        if (info->compare) {
+            if (token_.type != Token::Op) {
+                fail(QString("%1 后面需要比较，例如 %1 > 10").arg(name));
+                return -1;
+            }
+            node.op = token_.op;
+            next();
+            bool ok = false;
+            node.value = token_.type == Token::Word ? token_.text.toInt(&ok) : 0;
+            if (!ok) {
+                fail("这里应该是一个整数");
+                return -1;
+            }
+            next();
+        }
+        return addNode(node);
+    }
+
+    const QString& text_;
+    QVector<Node>& nodes_;
+    int pos_ = 0;
+    Token token_;
+    QString error_;
+};
+
+// ---------------- AnnotationQuery ----------------
+
+namespace {
+
+template <typename Op>
+inline bool compareValues(Op op, int lhs, int rhs)
+{
+    switch (op) {
+    case Op::Less:         return lhs < rhs;
+    case Op::LessEqual:    return lhs <= rhs;
+    case Op::Greater:      return lhs > rhs;
+    case Op::GreaterEqual: return lhs >= rhs;
+    case Op::Equal:        return lhs == rhs;
+    case Op::NotEqual:     return lhs != rhs;
+    }
+    return false;
+}
+
+} // namespace
+
+bool AnnotationQuery::parse(const QString& text, QString *error)
+{
+    nodes_.clear();
+    root_ = -1;
+    QString message;
+    if (text.trimmed().isEmpty()) {
+        message = "表达式为空";
+    } else {
+        root_ = Parser(text, nodes_).parseAll(message);
+    }
+    if (root_ < 0) {
+        nodes_.clear();
+    }
+    if (error) {
+        *error = message;
+    }
+    return root_ >= 0;
+}
+
+bool AnnotationQuery::writePathList(const QString& outputPath, const PathTable& paths, const QVector<PathId>& images,
+                                    const QVector<int>& files, QString *error)
+{
+    QSaveFile file(outputPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    QByteArray buffer;
+    for (int index : files) {
+        if (index < 0 || index >= images.size()) {
+            continue;
+        }
+        buffer += paths.path(images[index]).toUtf8();
+        buffer += '\n';
+        if (buffer.size() >= (1 << 20)) { // 按 1 MB 分批写入
+            file.write(buffer);
+            buffer.clear();
+        }
+    }
+    file.write(buffer);
+    if (!file.commit()) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    return true;
+}
+
+template <typename ValueFn>
+AnnotationQuery::FileSet AnnotationQuery::filterFiles(int fileCount, const Node& node, ValueFn valueOf)
+{
+    FileSet result(fileCount);
+    for (int file = 0; file < fileCount; ++file) {
+        if (compareValues(node.op, valueOf(file), node.value)) {
+            result.set(file);
+        }
+    }
+    return result;
+}
+
+QVector<int> AnnotationQuery::run(const AnnotationStore& store, const AnnotationIndex& index) const
+{
+    if (root_ < 0 || index.fileCount() != store.fileCount()) {
+        return QVector<int>();
+    }
+    return evaluate(root_, store, index).toIndices();
+}
+
+AnnotationQuery::FileSet AnnotationQuery::evaluate(int nodeIndex, const AnnotationStore& store,
+                                                   const AnnotationIndex& index) const
+{
+    const Node& node = nodes_[nodeIndex];
+    const int fileCount = store.fileCount();
+
+    switch (node.kind) {
+    case Kind::And: {
+        FileSet result = evaluate(node.left, store, index);
+        result.intersect(evaluate(node.right, store, index));
+        return result;
+    }
+    case Kind::Or: {
+        FileSet result = evaluate(node.left, store, index);
+        result.unite(evaluate(node.right, store, index));
+        return result;
+    }
+    case Kind::Not: {
+        FileSet result = evaluate(node.left, store, index);
+        result.invert();
+        return result;
+    }
+    case Kind::Objects: {
+        const int* counts = store.fileBoxCounts().constData();
+        return filterFiles(fileCount, node, [counts](int file) { return counts[file]; });
+    }
+    case Kind::Width:
+        return filterFiles(fileCount, node, [&store](int file) { return store.imageWidth(file); });
+    case Kind::Height:
+        return filterFiles(fileCount, node, [&store](int file) { return store.imageHeight(file); });
+    case Kind::Has: {
+        FileSet result(fileCount);
+        for (int file : index.posting(store.findLabel(node.label)).files) {
+            result.set(file);
+        }
+        return result;
+    }
+    case Kind::Count: {
+        // 不含这个标签的图片计数为 0：先按 0 是否满足条件整体填充，再只修改倒排表中的图片
+        const AnnotationIndex::Posting& posting = index.posting(store.findLabel(node.label));
+        FileSet result(fileCount, compareValues(node.op, 0, node.value));
+        for (qsizetype i = 0; i < posting.files.size(); ++i) {
+            result.assign(posting.files[i], compareValues(node.op, posting.counts[i], node.value));
+        }
+        return result;
+    }
+    case Kind::MinSide:
+    case Kind::MaxSide: {
+        const bool useMin = node.kind == Kind::MinSide;
+        const int* labelIds = store.labelIds().constData();
+        const int* xmin = store.xmin().constData();
+        const int* ymin = store.ymin().constData();
+        const int* xmax = store.xmax().constData();
+        const int* ymax = store.ymax().constData();
+        const int labelId = node.label.isEmpty() ? -1 : store.findLabel(node.label);
+
+        FileSet result(fileCount);
+        auto testFile = [&](int file) {
+            const qsizetype begin = store.fileBegin(file);
+            const qsizetype end = begin + store.fileBoxCount(file);
+            for (qsizetype b = begin; b < end; ++b) {
+                if (labelId >= 0 && labelIds[b] != labelId) {
+                    continue;
+                }
+                const int width = xmax[b] - xmin[b] + 1;
+                const int height = ymax[b] - ymin[b] + 1;
+                if (compareValues(node.op, useMin ? qMin(width, height) : qMax(width, height), node.value)) {
+                    result.set(file);
+                    return;
+                }
+            }
+        };
+        if (node.label.isEmpty()) {
+            for (int file = 0; file < fileCount; ++file) {
+                testFile(file);
+            }
+        } else if (labelId >= 0) {
+            for (int file : index.posting(labelId).files) { // 只看包含这个标签的图片
+                testFile(file);
+            }
+        }
+        return result;
+    }
+    }
+    return FileSet(fileCount);
+}
@@ -0,0 +1,113 @@
+#ifndef ANNOTATIONQUERY_H
+#define ANNOTATIONQUERY_H
+
+#include <QString>
+#include <QVector>
+#include "pathtable.h"
+
+class AnnotationStore;
+
+// 每个标签的倒排表：包含这个标签的图片（store 中的文件序号，升序）以及每张图片中这个标签的框数
+// 在统计结束时构建一次，按标签的查询只访问这个标签的倒排表，不扫描全部文件
+class AnnotationIndex
+{
+public:
+    struct Posting
+    {
+        QVector<int> files;
+        QVector<int> counts; // 与 files 一一对应
+    };
+
+    static AnnotationIndex build(const AnnotationStore& store);
+
+    // 增量更新：文件内容变化前用旧的 store 调用 removeFile，变化后用新的 store 调用 addFile，
+    // 只修改这个文件涉及的标签的倒排表
+    void removeFile(const AnnotationStore& store, int file);
+    void addFile(const AnnotationStore& store, int file);
+    void setFileCount(int count) { fileCount_ = count; }
+
+    int fileCount() const { return fileCount_; }
+    // labelId 超出范围时返回空的倒排表
+    const Posting& posting(int labelId) const;
+
+private:
+    int fileCount_ = 0;
+    QVector<Posting> postings_; // 下标为标签序号
+};
+
+// 图片筛选表达式，例如：
+//   objects > 25
+//   has(person) and not has(dog)
+//   minside(person) < 16 or count("traffic light") >= 3
+// 条件：
+//   objects OP n          图片中的框数
+//   width OP n, height OP n  图片宽高（未知时为 0）
+//   has(标签)             包含这个标签
+//   count(标签) OP n      这个标签的框数
+//   minside[(标签)] OP n  存在短边满足条件的框（可限定标签）
+//   maxside[(标签)] OP n  存在长边满足条件的框（可限定标签）
+// OP 为 < <= > >= = == !=；条件之间用 and / or / not（或 && || !）和括号组合，相邻的条件默认为 and
+// 标签名包含空格或特殊字符时用双引号括起来
+class AnnotationQuery
+{
+public:
+    // 解析表达式，失败时返回 false 并在 *error 中给出原因，之前的表达式被清空
+    bool parse(const QString& text, QString *error = nullptr);
+    bool isEmpty() const { return root_ < 0; }
+
+    // 返回满足条件的文件序号（升序）
+    QVector<int> run(const AnnotationStore& store, const AnnotationIndex& index) const;
+
+    // 把筛选结果写成训练流水线使用的路径列表：UTF-8，每行一个路径
+    // images 为每个文件序号对应的路径在 paths 中的序号（DatasetStats::images）
+    static bool writePathList(const QString& outputPath, const PathTable& paths, const QVector<PathId>& images,
+                              const QVector<int>& files, QString *error = nullptr);
+
+private:
+    enum class Kind
+    {
+        And,
+        Or,
+        Not,
+        Objects,
+        Width,
+        Height,
+        Has,
+        Count,
+        MinSide,
+        MaxSide
+    };
+    enum class Compare
+    {
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual,
+        Equal,
+        NotEqual
+    };
+
+    // 表达式树的节点保存在一个数组中，子节点用下标表示
+    struct Node
+    {
+        Kind kind = Kind::Objects;
+        Compare op = Compare::Equal;
+        int value = 0;
+        QString label;      // 为空表示不限定标签
+        int left = -1;      // And/Or/Not 的子节点
+        int right = -1;
+    };
+
+    class Parser;
+    class FileSet;
+
+    FileSet evaluate(int node, const AnnotationStore& store, const AnnotationIndex& index) const;
+    // 按每个文件的一个数值（框数、宽、高）筛选
+    template <typename ValueFn>
+    static FileSet filterFiles(int fileCount, const Node& node, ValueFn valueOf);
+
+    QVector<Node> nodes_;
+    int root_ = -1;
+};
+
+#endif // ANNOTATIONQUERY_H
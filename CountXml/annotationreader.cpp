@@ -0,0 +1,79 @@
+#include "annotationreader.h"
+#include "annotationstore.h"
+#include "cocoreader.h"
+#include "yoloreader.h"
+
+bool AnnotationReader::readImages(const QString& filePath, AnnotationStore& store, PathTable& paths,
+                                  QVector<PathId>& images, const ReadControl& control)
+{
+    Q_UNUSED(control);
+    store.beginFile();
+    parseInto(filePath, store);
+    images.append(paths.add(filePath));
+    return true;
+}
+
+std::unique_ptr<AnnotationReader> AnnotationReader::create(AnnotationFormat format, VocParser::Backend vocBackend)
+{
+    switch (format) {
+    case AnnotationFormat::Yolo:
+        return std::make_unique<YoloReader>();
+    case AnnotationFormat::Coco:
+        return std::make_unique<CocoReader>();
+    case AnnotationFormat::Voc:
+        break;
+    }
+    return std::make_unique<VocReader>(vocBackend);
+}
+
+QStringList AnnotationReader::nameFilters(AnnotationFormat format)
+{
+    switch (format) {
+    case AnnotationFormat::Yolo:
+        return {"*.txt"};
+    case AnnotationFormat::Coco:
+        return {"*.json"};
+    case AnnotationFormat::Voc:
+        break;
+    }
+    return {"*.xml"};
+}
+
+QStringList AnnotationReader::excludedNames(AnnotationFormat format)
+{
+    if (format == AnnotationFormat::Yolo) {
+        return {"classes.txt"}; // 类别名文件，不是标注
+    }
+    return {};
+}
+
+AnnotationFormat AnnotationReader::formatFromName(const QString& name, bool *ok)
+{
+    const QString lower = name.toLower();
+    bool known = true;
+    AnnotationFormat format = AnnotationFormat::Voc;
+    if (lower == "yolo") {
+        format = AnnotationFormat::Yolo;
+    } else if (lower == "coco") {
+        format = AnnotationFormat::Coco;
+    } else if (lower != "voc") {
+        known = false;
+    }
+    if (ok) {
+        *ok = known;
+    }
+    return format;
+}
+
+QString AnnotationReader::formatName(AnnotationFormat format)
+{
+    switch (format) {
+    case AnnotationFormat::Yolo:
+        return "yolo";
+    case AnnotationFormat::Coco:
+        return "coco";
+    case AnnotationFormat::Voc:
+        break;
+    }
+    return "voc";
+}
@@ -0,0 +1,114 @@
+#ifndef ANNOTATIONREADER_H
+#define ANNOTATIONREADER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+#include "parsereport.h"
+#include "pathtable.h"
+#include "vocParser.h"
+
+class AnnotationStore;
+
+// 支持的标注格式
+enum class AnnotationFormat
+{
+    Voc,  // 每张图片一个 .xml
+    Yolo, // 每张图片一个 .txt，类别名来自 classes.txt
+    Coco  // 一个 .json 包含全部图片
+};
+
+// 各种标注格式的统一读取接口，所有格式都写入同一个 AnnotationStore，统计代码不区分格式
+// 每张图片在 store 中对应一个"文件"，框坐标统一换算成 VOC 的像素坐标（xmax/ymax 包含在内）
+class AnnotationReader
+{
+public:
+    // 多图片文件的读取控制：取消标志和按字节的进度回调，都可以为空
+    struct ReadControl
+    {
+        const std::atomic<bool> *cancel = nullptr;
+        std::function<void(qint64 bytesDone, qint64 bytesTotal, int imagesRead)> progress;
+    };
+
+    virtual ~AnnotationReader() = default;
+
+    virtual AnnotationFormat format() const = 0;
+    // 一个标注文件恰好对应一张图片（VOC、YOLO）时为 true，可以按文件并行解析
+    virtual bool isPerImage() const { return true; }
+    // 解析结果只取决于文件本身，可以按 路径 + 大小 + 修改时间 缓存
+    virtual bool isCacheable() const { return false; }
+
+    // 之后发现的数据质量问题记到 report 中，为空时不记录
+    virtual void setReport(ParseReport *report) { report_ = report; }
+    ParseReport *report() const { return report_; }
+
+    // 单图片格式：把文件中的有效对象追加到 store 当前的文件中（调用方先 beginFile），返回追加的对象数
+    virtual int parseInto(const QString& filePath, AnnotationStore& store) = 0;
+    // 读取一个标注文件中的全部图片：每张图片 beginFile 一次，图片名加入 paths，images 同步追加其序号
+    // 返回 false 表示文件无法读取、格式错误或被取消
+    // 默认实现用于单图片格式，图片名即标注文件路径
+    virtual bool readImages(const QString& filePath, AnnotationStore& store, PathTable& paths,
+                            QVector<PathId>& images, const ReadControl& control);
+
+    static std::unique_ptr<AnnotationReader> create(AnnotationFormat format,
+                                                    VocParser::Backend vocBackend = VocParser::Backend::Stream);
+    // 扫描目录时使用的文件名过滤
+    static QStringList nameFilters(AnnotationFormat format);
+    // 符合 nameFilters 但不是标注的文件名，扫描时跳过
+    static QStringList excludedNames(AnnotationFormat format);
+    // "voc"、"yolo"、"coco"，无法识别时 *ok 为 false
+    static AnnotationFormat formatFromName(const QString& name, bool *ok);
+    static QString formatName(AnnotationFormat format);
+
+protected:
+    void note(ParseReport::Issue issue, const QString& filePath, const QString& detail = QString())
+    {
+        if (report_) {
+            report_->add(issue, filePath, detail);
+        }
+    }
+    bool wantsSample(ParseReport::Issue issue) const { return report_ && report_->wantsSample(issue); }
+
+    // 文件中的数字可能超出整数范围，直接转换是未定义行为
+    // 是有限值且在 Int 的范围内时写入 out 并返回 true，否则不修改 out
+    template <typename Int>
+    static bool toInteger(double value, Int& out)
+    {
+        const double lower = double(std::numeric_limits<Int>::min()); // -2^(n-1)，double 可以精确表示
+        if (!(value >= lower && value < -lower)) { // NaN 也不满足
+            return false;
+        }
+        out = Int(value);
+        return true;
+    }
+
+    ParseReport *report_ = nullptr;
+};
+
+// VOC：包装 VocParser
+class VocReader : public AnnotationReader
+{
+public:
+    explicit VocReader(VocParser::Backend backend) : parser_(backend) {}
+
+    AnnotationFormat format() const override { return AnnotationFormat::Voc; }
+    bool isCacheable() const override { return true; }
+    void setReport(ParseReport *report) override
+    {
+        AnnotationReader::setReport(report);
+        parser_.setReport(report);
+    }
+    int parseInto(const QString& filePath, AnnotationStore& store) override
+    {
+        return parser_.parseInto(filePath, store);
+    }
+
+private:
+    VocParser parser_;
+};
+
+#endif // ANNOTATIONREADER_H
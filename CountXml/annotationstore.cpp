@@ -0,0 +1,238 @@
+#include "annotationstore.h"
+
+int AnnotationStore::internLabel(const QString& name)
+{
+    auto it = labelIndex_.constFind(name);
+    if (it != labelIndex_.constEnd()) {
+        return it.value();
+    }
+    const int labelId = labels_.size();
+    labels_.append(name);
+    labelIndex_.insert(name, labelId);
+    labelBoxCounts_.append(0);
+    return labelId;
+}
+
+int AnnotationStore::internLabelUtf8(const char* name, int length)
+{
+    auto it = utf8LabelIndex_.constFind(QByteArray::fromRawData(name, length)); // 不复制字节
+    if (it != utf8LabelIndex_.constEnd()) {
+        return it.value();
+    }
+    const int labelId = internLabel(QString::fromUtf8(name, length));
+    utf8LabelIndex_.insert(QByteArray(name, length), labelId);
+    return labelId;
+}
+
+int AnnotationStore::beginFile()
+{
+    fileBegin_.append(labelIds_.size());
+    fileBoxCount_.append(0);
+    imageWidth_.append(0);
+    imageHeight_.append(0);
+    return fileBegin_.size() - 1;
+}
+
+void AnnotationStore::setImageSize(int width, int height)
+{
+    imageWidth_.last() = width;
+    imageHeight_.last() = height;
+}
+
+void AnnotationStore::addBox(int labelId, int xmin, int ymin, int xmax, int ymax)
+{
+    labelIds_.append(labelId);
+    xmin_.append(xmin);
+    ymin_.append(ymin);
+    xmax_.append(xmax);
+    ymax_.append(ymax);
+    fileBoxCount_.last() += 1;
+    labelBoxCounts_[labelId] += 1;
+}
+
+void AnnotationStore::rollbackFile()
+{
+    if (fileBegin_.isEmpty()) {
+        return;
+    }
+    const qsizetype begin = fileBegin_.last();
+    for (qsizetype i = begin; i < labelIds_.size(); ++i) {
+        labelBoxCounts_[labelIds_[i]] -= 1;
+    }
+    labelIds_.resize(begin);
+    xmin_.resize(begin);
+    ymin_.resize(begin);
+    xmax_.resize(begin);
+    ymax_.resize(begin);
+    fileBoxCount_.last() = 0;
+    imageWidth_.last() = 0;
+    imageHeight_.last() = 0;
+}
+
+void AnnotationStore::append(const AnnotationStore& other)
+{
+    QVector<int> remap(other.labelCount());
+    for (int i = 0; i < other.labelCount(); ++i) {
+        remap[i] = internLabel(other.labels_[i]);
+        labelBoxCounts_[remap[i]] += other.labelBoxCounts_[i];
+    }
+
+    const qsizetype offset = labelIds_.size();
+    fileBegin_.reserve(fileBegin_.size() + other.fileBegin_.size());
+    for (qsizetype begin : other.fileBegin_) {
+        fileBegin_.append(begin + offset);
+    }
+    fileBoxCount_.append(other.fileBoxCount_);
+    imageWidth_.append(other.imageWidth_);
+    imageHeight_.append(other.imageHeight_);
+
+    labelIds_.reserve(offset + other.labelIds_.size());
+    for (int labelId : other.labelIds_) {
+        labelIds_.append(remap[labelId]);
+    }
+    xmin_.append(other.xmin_);
+    ymin_.append(other.ymin_);
+    xmax_.append(other.xmax_);
+    ymax_.append(other.ymax_);
+    garbageBoxes_ += other.garbageBoxes_;
+    compact_ = compact_ && other.compact_;
+}
+
+int AnnotationStore::appendFile(const AnnotationStore& from, int fromFile)
+{
+    const int fileIndex = beginFile();
+    imageWidth_.last() = from.imageWidth_[fromFile];
+    imageHeight_.last() = from.imageHeight_[fromFile];
+    const qsizetype begin = labelIds_.size();
+    resizeBoxes(begin + from.fileBoxCount_[fromFile]);
+    copyBoxes(begin, from, fromFile);
+    fileBoxCount_.last() = from.fileBoxCount_[fromFile];
+    return fileIndex;
+}
+
+void AnnotationStore::replaceFile(int fileIndex, const AnnotationStore& from, int fromFile)
+{
+    qsizetype begin = fileBegin_[fileIndex];
+    const int oldCount = fileBoxCount_[fileIndex];
+    for (qsizetype b = begin; b < begin + oldCount; ++b) {
+        labelBoxCounts_[labelIds_[b]] -= 1;
+    }
+
+    const int count = from.fileBoxCount_[fromFile];
+    if (begin + oldCount == labelIds_.size()) {
+        resizeBoxes(begin + count); // 文件的框在数组末尾，直接伸缩
+    } else if (count <= oldCount) {
+        garbageBoxes_ += oldCount - count;
+        compact_ = compact_ && count == oldCount;
+    } else {
+        garbageBoxes_ += oldCount;
+        compact_ = false;
+        begin = labelIds_.size();
+        resizeBoxes(begin + count);
+    }
+    copyBoxes(begin, from, fromFile);
+    fileBegin_[fileIndex] = begin;
+    fileBoxCount_[fileIndex] = count;
+    imageWidth_[fileIndex] = from.imageWidth_[fromFile];
+    imageHeight_[fileIndex] = from.imageHeight_[fromFile];
+    compactIfSparse();
+}
+
+void AnnotationStore::removeFileSwapLast(int fileIndex)
+{
+    const qsizetype begin = fileBegin_[fileIndex];
+    const int count = fileBoxCount_[fileIndex];
+    for (qsizetype b = begin; b < begin + count; ++b) {
+        labelBoxCounts_[labelIds_[b]] -= 1;
+    }
+    if (begin + count == labelIds_.size()) {
+        resizeBoxes(begin);
+    } else {
+        garbageBoxes_ += count;
+        compact_ = false;
+    }
+
+    const int last = fileCount() - 1;
+    if (fileIndex != last) {
+        fileBegin_[fileIndex] = fileBegin_[last];
+        fileBoxCount_[fileIndex] = fileBoxCount_[last];
+        imageWidth_[fileIndex] = imageWidth_[last];
+        imageHeight_[fileIndex] = imageHeight_[last];
+        compact_ = compact_ && fileBoxCount_[fileIndex] == 0;
+    }
+    fileBegin_.removeLast();
+    fileBoxCount_.removeLast();
+    imageWidth_.removeLast();
+    imageHeight_.removeLast();
+    compactIfSparse();
+}
+
+void AnnotationStore::compact()
+{
+    if (compact_) {
+        return;
+    }
+    AnnotationStore result;
+    result.labels_ = labels_;
+    result.labelIndex_ = labelIndex_;
+    result.utf8LabelIndex_ = utf8LabelIndex_;
+    result.labelBoxCounts_ = QVector<qint64>(labels_.size(), 0); // 由 addBox 重新累计
+    result.reserveBoxes(boxCount());
+    for (int f = 0; f < fileCount(); ++f) {
+        result.beginFile();
+        result.setImageSize(imageWidth_[f], imageHeight_[f]);
+        const qsizetype begin = fileBegin_[f];
+        for (qsizetype b = begin; b < begin + fileBoxCount_[f]; ++b) {
+            result.addBox(labelIds_[b], xmin_[b], ymin_[b], xmax_[b], ymax_[b]);
+        }
+    }
+    *this = std::move(result);
+}
+
+void AnnotationStore::compactIfSparse()
+{
+    if (garbageBoxes_ > labelIds_.size() / 2) {
+        compact();
+    }
+}
+
+void AnnotationStore::copyBoxes(qsizetype begin, const AnnotationStore& from, int fromFile)
+{
+    QVector<int> remap(from.labelCount(), -1); // 按需映射，文件里通常只有少数标签
+    const qsizetype fromBegin = from.fileBegin_[fromFile];
+    for (int i = 0; i < from.fileBoxCount_[fromFile]; ++i) {
+        const int fromLabel = from.labelIds_[fromBegin + i];
+        if (remap[fromLabel] < 0) {
+            remap[fromLabel] = internLabel(from.labels_[fromLabel]);
+        }
+        labelIds_[begin + i] = remap[fromLabel];
+        xmin_[begin + i] = from.xmin_[fromBegin + i];
+        ymin_[begin + i] = from.ymin_[fromBegin + i];
+        xmax_[begin + i] = from.xmax_[fromBegin + i];
+        ymax_[begin + i] = from.ymax_[fromBegin + i];
+        labelBoxCounts_[remap[fromLabel]] += 1;
+    }
+}
+
+void AnnotationStore::resizeBoxes(qsizetype count)
+{
+    labelIds_.resize(count);
+    xmin_.resize(count);
+    ymin_.resize(count);
+    xmax_.resize(count);
+    ymax_.resize(count);
+}
+
+void AnnotationStore::reserveBoxes(qsizetype count)
+{
+    labelIds_.reserve(count);
+    xmin_.reserve(count);
+    ymin_.reserve(count);
+    xmax_.reserve(count);
+    ymax_.reserve(count);
+}
+
+void AnnotationStore::clear()
+{
+    *this = AnnotationStore();
+}
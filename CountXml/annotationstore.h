@@ -0,0 +1,99 @@
+#ifndef ANNOTATIONSTORE_H
+#define ANNOTATIONSTORE_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QByteArray>
+#include <QVector>
+
+// 整个数据集的标注按列存储
+// 标签名只在字典中存一份，框用标签序号和连续的 xmin/ymin/xmax/ymax 数组表示，
+// 每个文件对应 [fileBegin, fileBegin + fileBoxCount) 这一段框，另外记录 <size> 中的图片宽高（未知时为 0）
+// 增量更新（replaceFile/removeFileSwapLast）原地修改，框数组中可能留下空洞、文件的框也不再按文件顺序排列，
+// 按文件读取不受影响；需要整段遍历框数组时先 compact()
+// 坐标和 VOC 一致，xmax/ymax 为包含在内的最后一个像素
+class AnnotationStore
+{
+public:
+    // ---- 标签字典 ----
+    int internLabel(const QString& name);
+    // 按 UTF-8 字节查找标签，已有的标签不需要构造 QString
+    int internLabelUtf8(const char* name, int length);
+    // 已有标签的序号，没有这个标签时返回 -1
+    int findLabel(const QString& name) const { return labelIndex_.value(name, -1); }
+    int labelCount() const { return labels_.size(); }
+    QString labelName(int labelId) const { return labels_.value(labelId); }
+    const QStringList& labels() const { return labels_; }
+    // 每个标签的框数，下标为标签序号
+    const QVector<qint64>& labelBoxCounts() const { return labelBoxCounts_; }
+
+    // ---- 写入 ----
+    // 开始一个新文件，之后的 addBox 都属于它，返回文件序号
+    int beginFile();
+    void addBox(int labelId, int xmin, int ymin, int xmax, int ymax);
+    // 设置最后一个文件的图片宽高
+    void setImageSize(int width, int height);
+    // 丢弃最后一个文件已经写入的框（文件本身保留，框数为 0），用于解析失败时回滚
+    void rollbackFile();
+    // 把另一个 store 的全部文件追加到末尾，标签序号会重新映射
+    void append(const AnnotationStore& other);
+    // 把 from 的第 fromFile 个文件追加为新文件，返回文件序号
+    int appendFile(const AnnotationStore& from, int fromFile);
+    // 用 from 的第 fromFile 个文件替换第 fileIndex 个文件，文件序号不变
+    // 框数不超过原来时写回原位置，否则写到数组末尾，原位置留下空洞
+    void replaceFile(int fileIndex, const AnnotationStore& from, int fromFile);
+    // 删除第 fileIndex 个文件，最后一个文件移到它的位置（序号 fileCount() - 1 变为 fileIndex）
+    void removeFileSwapLast(int fileIndex);
+    // 去掉空洞，框重新按文件顺序连续存放，文件序号不变
+    void compact();
+    void reserveBoxes(qsizetype count);
+    void clear();
+
+    // ---- 读取 ----
+    int fileCount() const { return fileBegin_.size(); }
+    // 有效的框数，不含空洞
+    qsizetype boxCount() const { return labelIds_.size() - garbageBoxes_; }
+    // 框是否按文件顺序连续存放、没有空洞，为 false 时框数组的长度大于 boxCount()
+    bool isCompact() const { return compact_; }
+    qsizetype fileBegin(int fileIndex) const { return fileBegin_[fileIndex]; }
+    int fileBoxCount(int fileIndex) const { return fileBoxCount_[fileIndex]; }
+    // 每个文件的框数，和文件序号一一对应
+    const QVector<int>& fileBoxCounts() const { return fileBoxCount_; }
+    int imageWidth(int fileIndex) const { return imageWidth_[fileIndex]; }
+    int imageHeight(int fileIndex) const { return imageHeight_[fileIndex]; }
+
+    const QVector<int>& labelIds() const { return labelIds_; }
+    const QVector<int>& xmin() const { return xmin_; }
+    const QVector<int>& ymin() const { return ymin_; }
+    const QVector<int>& xmax() const { return xmax_; }
+    const QVector<int>& ymax() const { return ymax_; }
+
+private:
+    void resizeBoxes(qsizetype count);
+    // 把 from 的第 fromFile 个文件的框写到 [begin, begin + 框数)，标签重新映射并计入 labelBoxCounts_
+    void copyBoxes(qsizetype begin, const AnnotationStore& from, int fromFile);
+    // 空洞超过框数组的一半时整体压缩一次，均摊到每次修改上是常数
+    void compactIfSparse();
+
+    QStringList labels_;
+    QHash<QString, int> labelIndex_;
+    QHash<QByteArray, int> utf8LabelIndex_; // internLabelUtf8 的缓存，按需填充
+    QVector<qint64> labelBoxCounts_;
+
+    QVector<qsizetype> fileBegin_;
+    QVector<int> fileBoxCount_;
+    QVector<int> imageWidth_;
+    QVector<int> imageHeight_;
+
+    QVector<int> labelIds_;
+    QVector<int> xmin_;
+    QVector<int> ymin_;
+    QVector<int> xmax_;
+    QVector<int> ymax_;
+
+    qsizetype garbageBoxes_ = 0; // 框数组中不属于任何文件的位置数
+    bool compact_ = true;
+};
+
+#endif // ANNOTATIONSTORE_H
@@ -0,0 +1,48 @@
+QT       += core xml concurrent
+QT       -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = CountXmlBench
+
+# 解析和统计的基准测试：生成确定性的 VOC 数据集，对比不同解析后端和线程数
+INCLUDEPATH += ..
+
+SOURCES += \
+    main.cpp \
+    vocgenerator.cpp \
+    ../annotationquery.cpp \
+    ../annotationreader.cpp \
+    ../annotationstore.cpp \
+    ../cocoreader.cpp \
+    ../datasetsample.cpp \
+    ../directorystats.cpp \
+    ../geometrystats.cpp \
+    ../histogram.cpp \
+    ../parsecache.cpp \
+    ../parsereport.cpp \
+    ../pathtable.cpp \
+    ../vocfastscanner.cpp \
+    ../vocParser.cpp \
+    ../xmlprocessor.cpp \
+    ../yoloreader.cpp
+
+HEADERS += \
+    vocgenerator.h \
+    ../annotationquery.h \
+    ../annotationreader.h \
+    ../annotationstore.h \
+    ../cocoreader.h \
+    ../datasetsample.h \
+    ../datasetstats.h \
+    ../directorystats.h \
+    ../geometrystats.h \
+    ../histogram.h \
+    ../parsecache.h \
+    ../parsereport.h \
+    ../pathtable.h \
+    ../vocfastscanner.h \
+    ../vocParser.h \
+    ../xmlprocessor.h \
+    ../yoloreader.h
@@ -0,0 +1,286 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+#include "vocgenerator.h"
+#include "xmlprocessor.h"
+
+// CountXml 解析与统计的基准测试
+// 先按参数生成确定性的 VOC 数据集，再对每个解析后端和线程数报告 files/s、objects/s 和内存分配次数
+// 用法示例：CountXmlBench --files 50000 --objects 1-40 --labels 80 --malformed 0.01 --threads 1,4,16
+
+namespace {
+
+std::atomic<qint64> g_allocations{0};
+
+// 默认不输出解析警告和调试信息，避免日志格式化本身影响测量结果
+void quietMessageHandler(QtMsgType type, const QMessageLogContext&, const QString& message)
+{
+    if (type == QtCriticalMsg || type == QtFatalMsg) {
+        fprintf(stderr, "%s\n", qPrintable(message));
+    }
+}
+
+} // namespace
+
+#if defined(__GLIBC__)
+// glibc 下替换 malloc 系列函数，Qt 容器的内存直接来自 malloc，只统计 operator new 会漏掉它们
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(size_t size) noexcept
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) noexcept
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) noexcept
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) noexcept
+{
+    __libc_free(ptr);
+}
+}
+#define ALLOCATION_SOURCE "malloc"
+#else
+// 其他平台只统计 operator new，Qt 容器通过 malloc 分配的内存不在其中
+#include <new>
+void *operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+#define ALLOCATION_SOURCE "operator new"
+#endif
+
+namespace {
+
+struct BenchResult
+{
+    QString name;
+    QString backend;
+    int threads = 1;
+    double seconds = 0.0;
+    qint64 files = 0;
+    qint64 objects = 0;
+    qint64 allocations = 0;
+};
+
+QString backendName(VocParser::Backend backend)
+{
+    switch (backend) {
+    case VocParser::Backend::Dom:
+        return "dom";
+    case VocParser::Backend::Stream:
+        return "stream";
+    case VocParser::Backend::Fast:
+        return "fast";
+    }
+    return "unknown";
+}
+
+// 单线程直接调用 VocParser::parseObjects，只测解析器本身
+BenchResult benchParser(VocParser::Backend backend, const QVector<QString>& files, int repeat)
+{
+    BenchResult result;
+    result.name = "parser";
+    result.backend = backendName(backend);
+
+    VocParser parser(backend);
+    const qint64 allocationsBefore = g_allocations.load();
+    QElapsedTimer timer;
+    timer.start();
+    for (int r = 0; r < repeat; ++r) {
+        for (const QString& file : files) {
+            result.objects += parser.parseObjects(file).size();
+        }
+    }
+    result.seconds = timer.nsecsElapsed() / 1e9;
+    result.allocations = g_allocations.load() - allocationsBefore;
+    result.files = qint64(files.size()) * repeat;
+    return result;
+}
+
+// 通过 XmlProcessor::analyzeDataset 测完整的统计流程（不使用缓存）
+BenchResult benchProcessor(VocParser::Backend backend, int threads, const QVector<QString>& files, int repeat)
+{
+    BenchResult result;
+    result.name = "processor";
+    result.backend = backendName(backend);
+    result.threads = threads;
+
+    XmlProcessor processor;
+    processor.setParserBackend(backend);
+    processor.setThreadCount(threads);
+    const QVector<PathId> ids = processor.pathTable()->addAll(files);
+    const qint64 allocationsBefore = g_allocations.load();
+    QElapsedTimer timer;
+    timer.start();
+    for (int r = 0; r < repeat; ++r) {
+        const DatasetStats stats = processor.analyzeDataset(ids);
+        result.objects += stats.store ? stats.store->boxCount() : 0;
+    }
+    result.seconds = timer.nsecsElapsed() / 1e9;
+    result.allocations = g_allocations.load() - allocationsBefore;
+    result.files = qint64(files.size()) * repeat;
+    return result;
+}
+
+QVector<VocParser::Backend> parseBackends(const QString& text, bool *ok)
+{
+    QVector<VocParser::Backend> backends;
+    *ok = true;
+    for (const QString& name : text.split(',', Qt::SkipEmptyParts)) {
+        if (name == "stream") {
+            backends.append(VocParser::Backend::Stream);
+        } else if (name == "dom") {
+            backends.append(VocParser::Backend::Dom);
+        } else if (name == "fast") {
+            backends.append(VocParser::Backend::Fast);
+        } else {
+            *ok = false;
+        }
+    }
+    return backends;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("CountXmlBench");
+
+    QCommandLineParser cli;
+    cli.setApplicationDescription("CountXml 解析与统计基准测试");
+    cli.addHelpOption();
+    QCommandLineOption filesOption("files", "生成的文件数", "n", "20000");
+    QCommandLineOption objectsOption("objects", "每个文件的 object 数范围 min-max", "range", "1-20");
+    QCommandLineOption labelsOption("labels", "标签词表大小", "n", "20");
+    QCommandLineOption malformedOption("malformed", "有问题的文件比例 (0-1)", "rate", "0");
+    QCommandLineOption seedOption("seed", "随机种子", "n", "12345");
+    QCommandLineOption dirOption("dir", "数据集目录，默认生成到临时目录并在结束时删除", "dir");
+    QCommandLineOption threadsOption("threads", "XmlProcessor 的线程数列表，逗号分隔",
+                                     "list", QString("1,%1").arg(QThread::idealThreadCount()));
+    QCommandLineOption backendsOption("backends", "解析后端列表，逗号分隔", "list", "dom,stream,fast");
+    QCommandLineOption repeatOption("repeat", "每项重复次数", "n", "1");
+    QCommandLineOption csvOption("csv", "以 CSV 输出结果，便于和基线比较");
+    QCommandLineOption verboseOption("verbose", "输出解析警告和调试信息");
+    cli.addOptions({filesOption, objectsOption, labelsOption, malformedOption, seedOption, dirOption,
+                    threadsOption, backendsOption, repeatOption, csvOption, verboseOption});
+    cli.process(app);
+
+    if (!cli.isSet(verboseOption)) {
+        qInstallMessageHandler(quietMessageHandler);
+    }
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    VocGenerator::Options options;
+    options.fileCount = cli.value(filesOption).toInt();
+    const QStringList objectRange = cli.value(objectsOption).split('-');
+    options.minObjects = objectRange.value(0).toInt();
+    options.maxObjects = objectRange.value(1, objectRange.value(0)).toInt();
+    options.labelCount = cli.value(labelsOption).toInt();
+    options.malformedRate = cli.value(malformedOption).toDouble();
+    options.seed = cli.value(seedOption).toUInt();
+    const int repeat = qMax(1, cli.value(repeatOption).toInt());
+
+    bool backendsOk = false;
+    const QVector<VocParser::Backend> backends = parseBackends(cli.value(backendsOption), &backendsOk);
+    QVector<int> threadCounts;
+    for (const QString& value : cli.value(threadsOption).split(',', Qt::SkipEmptyParts)) {
+        threadCounts.append(qMax(1, value.toInt()));
+    }
+    if (options.fileCount < 1 || options.minObjects < 0 || options.maxObjects < options.minObjects
+        || options.labelCount < 1 || !backendsOk || backends.isEmpty() || threadCounts.isEmpty()) {
+        err << "参数错误。\n";
+        cli.showHelp(1);
+    }
+
+    QTemporaryDir tempDir;
+    const QString rootDir = cli.isSet(dirOption) ? cli.value(dirOption) : tempDir.path();
+    QElapsedTimer timer;
+    timer.start();
+    const VocGenerator::Summary dataset = VocGenerator::generate(rootDir, options);
+    if (dataset.files.isEmpty()) {
+        err << "生成数据集失败：" << rootDir << "\n";
+        return 2;
+    }
+    err << QString("生成 %1 个文件（%2 个 object，%3 个有问题的文件）用时 %4 ms：%5\n")
+               .arg(dataset.files.size()).arg(dataset.objects).arg(dataset.malformedFiles)
+               .arg(timer.elapsed()).arg(rootDir);
+
+    // 预热：让文件进入系统缓存，之后的结果只反映解析和统计本身
+    benchParser(VocParser::Backend::Stream, dataset.files, 1);
+
+    QVector<BenchResult> results;
+    for (VocParser::Backend backend : backends) {
+        results.append(benchParser(backend, dataset.files, repeat));
+        for (int threads : std::as_const(threadCounts)) {
+            results.append(benchProcessor(backend, threads, dataset.files, repeat));
+        }
+    }
+
+    if (cli.isSet(csvOption)) {
+        out << "bench,backend,threads,seconds,files_per_s,objects_per_s,allocations_per_file\n";
+    } else {
+        out << QString("%1 %2 %3 %4 %5 %6\n")
+                   .arg("bench", -10).arg("backend", -8).arg("threads", 8)
+                   .arg("files/s", 12).arg("objects/s", 12).arg("allocs/file", 12);
+    }
+    for (const BenchResult& r : std::as_const(results)) {
+        const double filesPerSecond = r.files / qMax(1e-9, r.seconds);
+        const double objectsPerSecond = r.objects / qMax(1e-9, r.seconds);
+        const double allocationsPerFile = double(r.allocations) / qMax<qint64>(1, r.files);
+        if (cli.isSet(csvOption)) {
+            out << QString("%1,%2,%3,%4,%5,%6,%7\n")
+                       .arg(r.name).arg(r.backend).arg(r.threads)
+                       .arg(r.seconds, 0, 'f', 4)
+                       .arg(filesPerSecond, 0, 'f', 1)
+                       .arg(objectsPerSecond, 0, 'f', 1)
+                       .arg(allocationsPerFile, 0, 'f', 1);
+        } else {
+            out << QString("%1 %2 %3 %4 %5 %6\n")
+                       .arg(r.name, -10).arg(r.backend, -8).arg(r.threads, 8)
+                       .arg(filesPerSecond, 12, 'f', 0)
+                       .arg(objectsPerSecond, 12, 'f', 0)
+                       .arg(allocationsPerFile, 12, 'f', 1);
+        }
+    }
+    err << "内存分配统计来源：" << ALLOCATION_SOURCE << "\n";
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include "vocgenerator.h"
+#include <QDir>
+#include <QFile>
+#include <QDebug>
+#include <random>
+
+namespace {
+
+enum class Malformation
+{
+    None,
+    Truncated,    // 文件被截断，XML 不完整
+    WrongRoot,    // 根元素不是 <annotation>
+    InvalidBox,   // xmax < xmin
+    MissingBox    // 没有 <bndbox>
+};
+
+QByteArray makeAnnotation(std::mt19937& rng, const VocGenerator::Options& options,
+                          const QString& fileName, int objectCount, Malformation malformation)
+{
+    std::uniform_int_distribution<int> labelDist(0, options.labelCount - 1);
+    std::uniform_int_distribution<int> sizeDist(320, 1920);
+
+    const int width = sizeDist(rng);
+    const int height = sizeDist(rng);
+
+    QByteArray xml;
+    xml.reserve(512 + objectCount * 256);
+    const char *root = malformation == Malformation::WrongRoot ? "dataset" : "annotation";
+    xml += "<";
+    xml += root;
+    xml += ">\n";
+    xml += "\t<folder>images</folder>\n";
+    xml += "\t<filename>" + fileName.toUtf8() + ".jpg</filename>\n";
+    xml += "\t<size>\n";
+    xml += "\t\t<width>" + QByteArray::number(width) + "</width>\n";
+    xml += "\t\t<height>" + QByteArray::number(height) + "</height>\n";
+    xml += "\t\t<depth>3</depth>\n";
+    xml += "\t</size>\n";
+    xml += "\t<segmented>0</segmented>\n";
+
+    for (int i = 0; i < objectCount; ++i) {
+        std::uniform_int_distribution<int> xDist(0, width - 2);
+        std::uniform_int_distribution<int> yDist(0, height - 2);
+        const int xmin = xDist(rng);
+        const int ymin = yDist(rng);
+        std::uniform_int_distribution<int> wDist(1, width - 1 - xmin);
+        std::uniform_int_distribution<int> hDist(1, height - 1 - ymin);
+        int xmax = xmin + wDist(rng);
+        const int ymax = ymin + hDist(rng);
+        if (malformation == Malformation::InvalidBox && i == 0) {
+            xmax = xmin - 1;
+        }
+
+        xml += "\t<object>\n";
+        xml += "\t\t<name>class_" + QByteArray::number(labelDist(rng)).rightJustified(4, '0') + "</name>\n";
+        xml += "\t\t<pose>Unspecified</pose>\n";
+        xml += "\t\t<truncated>0</truncated>\n";
+        xml += "\t\t<difficult>0</difficult>\n";
+        if (!(malformation == Malformation::MissingBox && i == 0)) {
+            xml += "\t\t<bndbox>\n";
+            xml += "\t\t\t<xmin>" + QByteArray::number(xmin) + "</xmin>\n";
+            xml += "\t\t\t<ymin>" + QByteArray::number(ymin) + "</ymin>\n";
+            xml += "\t\t\t<xmax>" + QByteArray::number(xmax) + "</xmax>\n";
+            xml += "\t\t\t<ymax>" + QByteArray::number(ymax) + "</ymax>\n";
+            xml += "\t\t</bndbox>\n";
+        }
+        xml += "\t</object>\n";
+    }
+    xml += "</";
+    xml += root;
+    xml += ">\n";
+
+    if (malformation == Malformation::Truncated) {
+        xml.truncate(xml.size() * 2 / 3);
+    }
+    return xml;
+}
+
+} // namespace
+
+VocGenerator::Summary VocGenerator::generate(const QString& rootDir, const Options& options)
+{
+    Summary summary;
+    std::mt19937 rng(options.seed);
+    std::uniform_int_distribution<int> objectDist(options.minObjects, qMax(options.minObjects, options.maxObjects));
+    std::uniform_real_distribution<double> malformedDist(0.0, 1.0);
+    std::uniform_int_distribution<int> kindDist(1, 4);
+
+    QDir root(rootDir);
+    summary.files.reserve(options.fileCount);
+    for (int i = 0; i < options.fileCount; ++i) {
+        const QString subDir = QString("part_%1").arg(i / qMax(1, options.filesPerDirectory), 4, 10, QChar('0'));
+        if (i % qMax(1, options.filesPerDirectory) == 0 && !root.mkpath(subDir)) {
+            qWarning() << "Error: Cannot create directory" << root.filePath(subDir);
+            return Summary();
+        }
+
+        Malformation malformation = Malformation::None;
+        if (malformedDist(rng) < options.malformedRate) {
+            malformation = static_cast<Malformation>(kindDist(rng));
+            summary.malformedFiles++;
+        }
+
+        const QString fileName = QString("%1").arg(i, 8, 10, QChar('0'));
+        const int objectCount = objectDist(rng);
+        const QByteArray xml = makeAnnotation(rng, options, fileName, objectCount, malformation);
+
+        const QString filePath = root.filePath(subDir + "/" + fileName + ".xml");
+        QFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(xml) != xml.size()) {
+            qWarning() << "Error: Cannot write" << filePath << file.errorString();
+            return Summary();
+        }
+        summary.files.append(filePath);
+        summary.objects += objectCount;
+    }
+    return summary;
+}
@@ -0,0 +1,33 @@
+#ifndef VOCGENERATOR_H
+#define VOCGENERATOR_H
+
+#include <QString>
+#include <QVector>
+
+// 生成用于基准测试的 VOC 标注目录，相同的参数和种子总是生成完全相同的文件
+class VocGenerator
+{
+public:
+    struct Options
+    {
+        int fileCount = 10000;        // 文件数
+        int minObjects = 1;           // 每个文件的 object 数在 [minObjects, maxObjects] 内均匀分布
+        int maxObjects = 20;
+        int labelCount = 20;          // 标签词表大小，标签名为 class_0000 ...
+        double malformedRate = 0.0;   // 有问题的文件比例：截断、根元素错误、坐标无效、缺少 bndbox
+        int filesPerDirectory = 1000; // 每个子目录的文件数，模拟按相机/站点分目录的数据集
+        quint32 seed = 12345;
+    };
+
+    struct Summary
+    {
+        QVector<QString> files; // 生成的文件路径，按生成顺序
+        qint64 objects = 0;     // 写入的 object 总数（包括无效的）
+        int malformedFiles = 0;
+    };
+
+    // 在 rootDir 下生成数据集，返回生成的文件列表；失败时 files 为空
+    static Summary generate(const QString& rootDir, const Options& options);
+};
+
+#endif // VOCGENERATOR_H
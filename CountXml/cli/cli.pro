@@ -0,0 +1,55 @@
+QT       += core xml concurrent
+QT       -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = CountXmlCli
+
+# 命令行版本：复用 CountXml 的解析和统计代码，不依赖 Qt Widgets
+INCLUDEPATH += ..
+
+SOURCES += \
+    main.cpp \
+    ../annotationquery.cpp \
+    ../annotationreader.cpp \
+    ../annotationstore.cpp \
+    ../cocoreader.cpp \
+    ../datasetsample.cpp \
+    ../directorystats.cpp \
+    ../geometrystats.cpp \
+    ../histogram.cpp \
+    ../parsecache.cpp \
+    ../parsereport.cpp \
+    ../pathtable.cpp \
+    ../vocfastscanner.cpp \
+    ../vocParser.cpp \
+    ../xmlprocessor.cpp \
+    ../xmlscanner.cpp \
+    ../yoloreader.cpp
+
+HEADERS += \
+    ../annotationquery.h \
+    ../annotationreader.h \
+    ../annotationstore.h \
+    ../cocoreader.h \
+    ../datasetsample.h \
+    ../datasetstats.h \
+    ../directorystats.h \
+    ../geometrystats.h \
+    ../histogram.h \
+    ../parsecache.h \
+    ../parsereport.h \
+    ../pathtable.h \
+    ../vocfastscanner.h \
+    ../vocParser.h \
+    ../xmlprocessor.h \
+    ../xmlscanner.h \
+    ../yoloreader.h
+
+win32: LIBS += -lpsapi
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
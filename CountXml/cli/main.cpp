@@ -0,0 +1,361 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <cstdio>
+
+#include "xmlprocessor.h"
+#include "xmlscanner.h"
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// 命令行版本的 CountXml，用于没有图形界面的数据流水线
+// 用法示例：CountXmlCli --threads 16 --format json -o stats.json /data/voc/train /data/voc/val
+//          CountXmlCli --input-format coco /data/coco/annotations
+//          CountXmlCli --query "has(person) and objects > 25" --query-output crowded.txt /data/voc/train
+
+namespace {
+
+// 进程的峰值内存（字节）
+qint64 peakRssBytes()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return qint64(counters.PeakWorkingSetSize);
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(Q_OS_DARWIN)
+    return qint64(usage.ru_maxrss);        // macOS 单位为字节
+#else
+    return qint64(usage.ru_maxrss) * 1024; // Linux 单位为 KB
+#endif
+#endif
+}
+
+// 几何分布区间在机器可读输出中的键名
+const char* const kAreaKeys[GeometryStats::kAreaBins] = {"small", "medium", "large"};
+const char* const kPositionKeys[GeometryStats::kPositionBins] = {
+    "top-left", "top-center", "top-right",
+    "middle-left", "center", "middle-right",
+    "bottom-left", "bottom-center", "bottom-right"};
+
+QJsonObject geometryToJson(const GeometryStats::Histograms& h)
+{
+    QJsonObject area;
+    for (int i = 0; i < GeometryStats::kAreaBins; ++i) {
+        area[kAreaKeys[i]] = h.area[i];
+    }
+    QJsonObject aspect;
+    for (int i = 0; i < GeometryStats::kAspectBins; ++i) {
+        aspect[GeometryStats::aspectBinLabel(i)] = h.aspect[i];
+    }
+    QJsonObject position;
+    for (int i = 0; i < GeometryStats::kPositionBins; ++i) {
+        position[kPositionKeys[i]] = h.position[i];
+    }
+
+    QJsonObject object;
+    object["boxes"] = h.boxes;
+    object["area"] = area;
+    object["aspect"] = aspect;
+    object["position"] = position;
+    object["positionUnknown"] = h.positionUnknown;
+    return object;
+}
+
+// 一个目录节点及其全部子目录，distribution 为各区间的文件数，与顶层 distribution 的区间一致
+QJsonObject directoryToJson(const DirectoryStats& directories, int index)
+{
+    const DirectoryStats::Node& node = directories.nodes[index];
+    QJsonArray distribution;
+    for (int files : node.distribution) {
+        distribution.append(files);
+    }
+    QJsonObject labels;
+    for (auto it = node.labelCounts.constBegin(); it != node.labelCounts.constEnd(); ++it) {
+        labels[it.key()] = it.value();
+    }
+    QJsonArray children;
+    for (int child : node.children) {
+        children.append(directoryToJson(directories, child));
+    }
+
+    QJsonObject object;
+    object["name"] = node.name;
+    object["files"] = node.files;
+    object["validFiles"] = node.validFiles;
+    object["boxes"] = node.boxes;
+    object["distribution"] = distribution;
+    object["labels"] = labels;
+    object["children"] = children;
+    return object;
+}
+
+// 每个目录节点相对根节点的路径，根节点为 "."
+QStringList directoryKeys(const DirectoryStats& directories)
+{
+    QStringList keys;
+    for (const DirectoryStats::Node& node : directories.nodes) {
+        if (node.parent < 0) {
+            keys << QString(".");
+        } else if (node.parent == 0) {
+            keys << node.name;
+        } else {
+            keys << keys[node.parent] + '/' + node.name;
+        }
+    }
+    return keys;
+}
+
+QByteArray toJson(const DatasetStats& stats, const QVector<int>& distribution, const HistogramSpec& spec)
+{
+    QJsonArray buckets;
+    for (int i = 0; i < spec.binCount(); ++i) {
+        QJsonObject bucket;
+        bucket["range"] = spec.label(i);
+        bucket["min"] = spec.lowerEdges()[i];
+        bucket["files"] = distribution[i];
+        buckets.append(bucket);
+    }
+
+    QJsonObject labels;
+    for (auto it = stats.labelCounts.constBegin(); it != stats.labelCounts.constEnd(); ++it) {
+        labels[it.key()] = it.value();
+    }
+
+    QJsonObject root;
+    root["files"] = int(stats.objectsPerFile.size());
+    root["validFiles"] = stats.validFiles;
+    root["distribution"] = buckets;
+    root["labels"] = labels;
+
+    QJsonObject geometry;
+    geometry["*"] = geometryToJson(stats.geometry.total); // 全部标签
+    for (int i = 0; i < stats.geometry.labels.size(); ++i) {
+        geometry[stats.geometry.labels[i]] = geometryToJson(stats.geometry.perLabel[i]);
+    }
+    root["geometry"] = geometry;
+    if (!stats.directories.isEmpty()) {
+        DirectoryStats directories = stats.directories;
+        directories.rebin(spec, stats.objectsPerFile);
+        root["directories"] = directoryToJson(directories, 0);
+    }
+    root["quality"] = stats.report.toJson();
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+// CSV 为 section,key,value 三列，section 为 summary、distribution、label、geometry、directory 或 quality
+// geometry 的 key 为 "标签/area|aspect|position/区间"，标签为 * 时表示全部标签
+// directory 的 key 为 "相对目录/files|validFiles|boxes"，每个目录的分布和标签个数见 JSON 输出
+// quality 只输出每类问题的次数，样本见 JSON 输出
+QByteArray toCsv(const DatasetStats& stats, const QVector<int>& distribution, const HistogramSpec& spec)
+{
+    auto quoted = [](QString text) -> QString {
+        text.replace('"', "\"\"");
+        return '"' + text + '"';
+    };
+
+    QByteArray csv;
+    QTextStream out(&csv);
+    out << "section,key,value\n";
+    out << "summary,files," << stats.objectsPerFile.size() << "\n";
+    out << "summary,validFiles," << stats.validFiles << "\n";
+    for (int i = 0; i < spec.binCount(); ++i) {
+        out << "distribution," << spec.label(i) << "," << distribution[i] << "\n";
+    }
+    for (auto it = stats.labelCounts.constBegin(); it != stats.labelCounts.constEnd(); ++it) {
+        out << "label," << quoted(it.key()) << "," << it.value() << "\n";
+    }
+    auto writeGeometry = [&](const QString& label, const GeometryStats::Histograms& h) {
+        for (int i = 0; i < GeometryStats::kAreaBins; ++i) {
+            out << "geometry," << quoted(label + "/area/" + kAreaKeys[i]) << "," << h.area[i] << "\n";
+        }
+        for (int i = 0; i < GeometryStats::kAspectBins; ++i) {
+            out << "geometry," << quoted(label + "/aspect/" + GeometryStats::aspectBinLabel(i)) << "," << h.aspect[i] << "\n";
+        }
+        for (int i = 0; i < GeometryStats::kPositionBins; ++i) {
+            out << "geometry," << quoted(label + "/position/" + kPositionKeys[i]) << "," << h.position[i] << "\n";
+        }
+        out << "geometry," << quoted(label + "/position/unknown") << "," << h.positionUnknown << "\n";
+    };
+    writeGeometry("*", stats.geometry.total);
+    for (int i = 0; i < stats.geometry.labels.size(); ++i) {
+        writeGeometry(stats.geometry.labels[i], stats.geometry.perLabel[i]);
+    }
+    const QStringList directoryPaths = directoryKeys(stats.directories);
+    for (int i = 0; i < stats.directories.nodes.size(); ++i) {
+        const DirectoryStats::Node& node = stats.directories.nodes[i];
+        out << "directory," << quoted(directoryPaths[i] + "/files") << "," << node.files << "\n";
+        out << "directory," << quoted(directoryPaths[i] + "/validFiles") << "," << node.validFiles << "\n";
+        out << "directory," << quoted(directoryPaths[i] + "/boxes") << "," << node.boxes << "\n";
+    }
+    for (int i = 0; i < ParseReport::IssueCount; ++i) {
+        const auto issue = ParseReport::Issue(i);
+        if (stats.report.count(issue) > 0) {
+            out << "quality," << ParseReport::issueKey(issue) << "," << stats.report.count(issue) << "\n";
+        }
+    }
+    out.flush();
+    return csv;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("CountXmlCli");
+
+    QCommandLineParser cli;
+    cli.setApplicationDescription("统计 VOC XML、YOLO 或 COCO 标注的标签分布和标签个数");
+    cli.addHelpOption();
+    cli.addPositionalArgument("dirs", "要统计的标注目录（递归查找 *.xml、*.txt 或 *.json）", "<dir> [<dir>...]");
+    QCommandLineOption threadsOption({"t", "threads"}, "解析线程数，0 表示使用 CPU 核心数", "n", "0");
+    QCommandLineOption widthOption("bucket-width", "等宽分布的区间宽度（个/张）", "n", "5");
+    QCommandLineOption countOption("bucket-count", "等宽分布的区间个数，最后一个区间包含所有更大的值", "n", "6");
+    QCommandLineOption binsOption("bins", "分布区间：fixed:宽度:个数、log:底数:个数、quantile:个数 或 edges:1,6,11,...，"
+                                          "设置后忽略 --bucket-width/--bucket-count", "spec");
+    QCommandLineOption formatOption({"f", "format"}, "输出格式：json 或 csv", "format", "json");
+    QCommandLineOption outputOption({"o", "output"}, "输出文件，默认输出到标准输出", "file");
+    QCommandLineOption backendOption("backend", "解析后端：stream、dom 或 fast（内存映射，不规整的文件自动改用 stream）", "backend", "stream");
+    QCommandLineOption cacheOption("cache", "使用的解析缓存文件（默认不使用，只对 voc 有效）", "file");
+    QCommandLineOption inputFormatOption("input-format", "标注格式：voc、yolo 或 coco", "format", "voc");
+    QCommandLineOption queryOption("query", "筛选图片的表达式，例如 \"has(person) and not has(dog)\"、\"minside < 16\"", "expr");
+    QCommandLineOption queryOutputOption("query-output", "把 --query 匹配的图片路径写入这个文件，每行一个", "file");
+    cli.addOptions({threadsOption, widthOption, countOption, binsOption, formatOption, outputOption, backendOption, cacheOption,
+                    inputFormatOption, queryOption, queryOutputOption});
+    cli.process(app);
+
+    QTextStream err(stderr);
+
+    const QStringList dirs = cli.positionalArguments();
+    bool threadsOk = false, widthOk = false, countOk = false;
+    const int threads = cli.value(threadsOption).toInt(&threadsOk);
+    const int bucketWidth = cli.value(widthOption).toInt(&widthOk);
+    const int bucketCount = cli.value(countOption).toInt(&countOk);
+    const QString format = cli.value(formatOption).toLower();
+    const QString backend = cli.value(backendOption).toLower();
+    bool inputFormatOk = false;
+    const AnnotationFormat inputFormat = AnnotationReader::formatFromName(cli.value(inputFormatOption), &inputFormatOk);
+    AnnotationQuery query;
+    if (cli.isSet(queryOption)) {
+        QString queryError;
+        if (!query.parse(cli.value(queryOption), &queryError)) {
+            err << "无法解析 --query：" << queryError << "\n";
+            return 1;
+        }
+        if (!cli.isSet(queryOutputOption)) {
+            err << "--query 需要和 --query-output 一起使用。\n";
+            return 1;
+        }
+    }
+    if (!inputFormatOk || dirs.isEmpty() || !threadsOk || threads < 0 || !widthOk || bucketWidth < 1 || !countOk || bucketCount < 1
+        || (format != "json" && format != "csv") || (backend != "stream" && backend != "dom" && backend != "fast")) {
+        err << "参数错误。\n";
+        cli.showHelp(1);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 复用图形界面的扫描器，直接连接，在当前线程同步执行
+    const auto paths = QSharedPointer<PathTable>::create();
+    QVector<PathId> xmlFiles;
+    XmlScanner scanner(paths);
+    QObject::connect(&scanner, &XmlScanner::batchFound, &scanner,
+                     [&xmlFiles](int, const QVector<PathId>& ids, int) { xmlFiles += ids; },
+                     Qt::DirectConnection);
+    for (const QString& dir : dirs) {
+        scanner.scan(dir, AnnotationReader::nameFilters(inputFormat), AnnotationReader::excludedNames(inputFormat), 0);
+    }
+    const qint64 scanMs = timer.elapsed();
+    if (xmlFiles.isEmpty()) {
+        err << "没有找到标注文件。\n";
+        return 2;
+    }
+
+    XmlProcessor processor;
+    processor.setPathTable(paths);
+    processor.setThreadCount(threads);
+    processor.setInputFormat(inputFormat);
+    if (cli.isSet(cacheOption)) {
+        processor.setCachePath(cli.value(cacheOption));
+    }
+    if (backend == "dom") {
+        processor.setParserBackend(VocParser::Backend::Dom);
+    } else if (backend == "fast") {
+        processor.setParserBackend(VocParser::Backend::Fast);
+    }
+
+    timer.restart();
+    const DatasetStats stats = processor.analyzeDataset(xmlFiles);
+    const qint64 analyzeMs = qMax<qint64>(1, timer.elapsed());
+
+    // 分位数区间依赖统计结果，所以分布在统计完成后按每个文件的标签个数重新分箱
+    HistogramSpec spec = HistogramSpec::fixedWidth(bucketWidth, bucketCount);
+    if (cli.isSet(binsOption)) {
+        bool binsOk = false;
+        spec = HistogramSpec::fromString(cli.value(binsOption), stats.objectsPerFile, &binsOk);
+        if (!binsOk) {
+            err << "无法识别的 --bins：" << cli.value(binsOption) << "\n";
+            return 1;
+        }
+    }
+    const QVector<int> distribution = spec.apply(stats.objectsPerFile);
+    const QByteArray output = format == "csv" ? toCsv(stats, distribution, spec)
+                                              : toJson(stats, distribution, spec);
+
+    if (cli.isSet(outputOption)) {
+        QFile file(cli.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            err << "无法写入输出文件：" << file.fileName() << " " << file.errorString() << "\n";
+            return 3;
+        }
+        file.write(output);
+    } else {
+        fwrite(output.constData(), 1, size_t(output.size()), stdout);
+        fflush(stdout);
+    }
+
+    if (!query.isEmpty() && stats.store && stats.index) {
+        QElapsedTimer queryTimer;
+        queryTimer.start();
+        const QVector<int> matches = query.run(*stats.store, *stats.index);
+        QString writeError;
+        if (!AnnotationQuery::writePathList(cli.value(queryOutputOption), *paths, stats.images, matches, &writeError)) {
+            err << "无法写入 --query-output：" << writeError << "\n";
+            return 3;
+        }
+        err << QString("query: %1 / %2 images matched in %3 ms\n")
+                   .arg(matches.size()).arg(stats.store->fileCount()).arg(queryTimer.elapsed());
+    }
+
+    // 性能数据写到标准错误，方便流水线记录回归
+    const qint64 objects = stats.store ? stats.store->boxCount() : 0;
+    err << QString("files: %1  objects: %2  issues: %8  scan: %3 ms  analyze: %4 ms  "
+                   "throughput: %5 files/s, %6 objects/s  peak RSS: %7 MB\n")
+               .arg(xmlFiles.size())
+               .arg(objects)
+               .arg(scanMs)
+               .arg(analyzeMs)
+               .arg(xmlFiles.size() * 1000.0 / analyzeMs, 0, 'f', 0)
+               .arg(objects * 1000.0 / analyzeMs, 0, 'f', 0)
+               .arg(peakRssBytes() / (1024.0 * 1024.0), 0, 'f', 1)
+               .arg(stats.report.issueCount());
+    return 0;
+}
@@ -0,0 +1,597 @@
+#include "cocoreader.h"
+#include "annotationstore.h"
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr qint64 kReadChunkSize = 1 << 20;  // 每次从文件读取 1 MB
+constexpr int kCheckpointInterval = 4096;   // 每读这么多项检查一次取消并报告进度
+constexpr qint64 kInvalidId = std::numeric_limits<qint64>::min(); // 超出范围的 id，不与任何图片对应
+
+inline bool isJsonSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+void appendUtf8(QByteArray& out, char32_t codePoint)
+{
+    if (codePoint < 0x80) {
+        out.append(char(codePoint));
+    } else if (codePoint < 0x800) {
+        out.append(char(0xC0 | (codePoint >> 6)));
+        out.append(char(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+        out.append(char(0xE0 | (codePoint >> 12)));
+        out.append(char(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.append(char(0x80 | (codePoint & 0x3F)));
+    } else {
+        out.append(char(0xF0 | (codePoint >> 18)));
+        out.append(char(0x80 | ((codePoint >> 12) & 0x3F)));
+        out.append(char(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.append(char(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+} // namespace
+
+// ---------------- JsonStream ----------------
+
+CocoReader::JsonStream::JsonStream(QFile& file) : file_(file)
+{
+}
+
+bool CocoReader::JsonStream::fill()
+{
+    consumed_ += buffer_.size();
+    buffer_.resize(kReadChunkSize);
+    const qint64 n = file_.read(buffer_.data(), kReadChunkSize);
+    buffer_.resize(qMax<qint64>(0, n));
+    pos_ = 0;
+    return !buffer_.isEmpty();
+}
+
+bool CocoReader::JsonStream::take(char& c)
+{
+    if (pos_ >= buffer_.size() && !fill()) {
+        error_ = true;
+        return false;
+    }
+    c = buffer_[pos_++];
+    return true;
+}
+
+char CocoReader::JsonStream::peek()
+{
+    while (true) {
+        if (pos_ >= buffer_.size() && !fill()) {
+            return 0;
+        }
+        const char c = buffer_[pos_];
+        if (!isJsonSpace(c)) {
+            return c;
+        }
+        ++pos_;
+    }
+}
+
+bool CocoReader::JsonStream::expect(char c)
+{
+    if (peek() != c) {
+        error_ = true;
+        return false;
+    }
+    ++pos_;
+    return true;
+}
+
+bool CocoReader::JsonStream::nextItem(char close, bool& first)
+{
+    const char c = peek();
+    if (c == close) {
+        ++pos_;
+        return false;
+    }
+    if (!first) {
+        if (c != ',') {
+            error_ = true;
+            return false;
+        }
+        ++pos_;
+    }
+    first = false;
+    return !error_;
+}
+
+bool CocoReader::JsonStream::readString(QByteArray& out)
+{
+    out.resize(0); // 保留容量
+    if (!expect('"')) {
+        return false;
+    }
+    while (true) {
+        if (pos_ >= buffer_.size() && !fill()) {
+            error_ = true;
+            return false;
+        }
+        // 一次追加到下一个引号或转义符为止的整段内容
+        const char* begin = buffer_.constData() + pos_;
+        const char* end = buffer_.constData() + buffer_.size();
+        const char* p = begin;
+        while (p < end && *p != '"' && *p != '\\') {
+            ++p;
+        }
+        out.append(begin, p - begin);
+        pos_ += p - begin;
+        if (p == end) {
+            continue;
+        }
+
+        char c = 0;
+        take(c);
+        if (c == '"') {
+            return true;
+        }
+        // 转义
+        if (!take(c)) {
+            return false;
+        }
+        switch (c) {
+        case '"': case '\\': case '/': out.append(c); break;
+        case 'b': out.append('\b'); break;
+        case 'f': out.append('\f'); break;
+        case 'n': out.append('\n'); break;
+        case 'r': out.append('\r'); break;
+        case 't': out.append('\t'); break;
+        case 'u': {
+            auto readHex = [this](char32_t& value) {
+                value = 0;
+                for (int i = 0; i < 4; ++i) {
+                    char h = 0;
+                    if (!take(h)) {
+                        return false;
+                    }
+                    const int digit = (h >= '0' && h <= '9') ? h - '0'
+                                      : (h >= 'a' && h <= 'f') ? h - 'a' + 10
+                                      : (h >= 'A' && h <= 'F') ? h - 'A' + 10 : -1;
+                    if (digit < 0) {
+                        error_ = true;
+                        return false;
+                    }
+                    value = (value << 4) | char32_t(digit);
+                }
+                return true;
+            };
+            char32_t codePoint = 0;
+            if (!readHex(codePoint)) {
+                return false;
+            }
+            if (codePoint >= 0xD800 && codePoint <= 0xDBFF) { // 代理对
+                char backslash = 0, u = 0;
+                char32_t low = 0;
+                if (!take(backslash) || !take(u) || backslash != '\\' || u != 'u' || !readHex(low)
+                    || low < 0xDC00 || low > 0xDFFF) {
+                    error_ = true;
+                    return false;
+                }
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+            }
+            appendUtf8(out, codePoint);
+            break;
+        }
+        default:
+            error_ = true;
+            return false;
+        }
+    }
+}
+
+bool CocoReader::JsonStream::readNumber(double& out)
+{
+    const char first = peek();
+    if (first != '-' && (first < '0' || first > '9')) {
+        error_ = true;
+        return false;
+    }
+    QByteArray text;
+    while (true) {
+        if (pos_ >= buffer_.size() && !fill()) {
+            break; // 文件末尾的数字
+        }
+        const char c = buffer_[pos_];
+        if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+            text.append(c);
+            ++pos_;
+        } else {
+            break;
+        }
+    }
+    bool ok = false;
+    out = text.toDouble(&ok);
+    if (!ok) {
+        error_ = true;
+    }
+    return ok;
+}
+
+bool CocoReader::JsonStream::skipValue()
+{
+    const char first = peek();
+    if (first == 0) {
+        error_ = true;
+        return false;
+    }
+    if (first != '{' && first != '[' && first != '"') {
+        // 数字、true、false、null
+        while (true) {
+            if (pos_ >= buffer_.size() && !fill()) {
+                return true;
+            }
+            const char c = buffer_[pos_];
+            if (c == ',' || c == '}' || c == ']' || isJsonSpace(c)) {
+                return true;
+            }
+            ++pos_;
+        }
+    }
+
+    // 字符串、对象、数组：只跟踪嵌套深度和字符串边界（segmentation 等大数组走这里）
+    int depth = 0;
+    bool inString = false;
+    bool escaped = false;
+    while (true) {
+        if (pos_ >= buffer_.size() && !fill()) {
+            error_ = true;
+            return false;
+        }
+        const char* data = buffer_.constData();
+        const qsizetype size = buffer_.size();
+        for (; pos_ < size; ++pos_) {
+            const char c = data[pos_];
+            if (inString) {
+                if (escaped) {
+                    escaped = false;
+                } else if (c == '\\') {
+                    escaped = true;
+                } else if (c == '"') {
+                    inString = false;
+                    if (depth == 0) {
+                        ++pos_;
+                        return true;
+                    }
+                }
+            } else if (c == '"') {
+                inString = true;
+            } else if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0) {
+                    ++pos_;
+                    return true;
+                }
+            }
+        }
+    }
+}
+
+bool CocoReader::JsonStream::readNumberOrSkip(double& out, bool& present)
+{
+    const char first = peek();
+    if (first == '-' || (first >= '0' && first <= '9')) {
+        present = true;
+        return readNumber(out);
+    }
+    present = false;
+    return skipValue();
+}
+
+// ---------------- CocoReader ----------------
+
+int CocoReader::parseInto(const QString& filePath, AnnotationStore& store)
+{
+    Q_UNUSED(filePath);
+    Q_UNUSED(store);
+    return 0;
+}
+
+bool CocoReader::readImages(const QString& filePath, AnnotationStore& store, PathTable& paths,
+                            QVector<PathId>& imageIds, const ReadControl& control)
+{
+    images_.clear();
+    boxes_.clear();
+    categories_.clear();
+    filePath_ = filePath;
+    itemsSinceCheckpoint_ = 0;
+    cancelled_ = false;
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        note(ParseReport::CannotOpen, filePath, file.errorString());
+        return false;
+    }
+    fileSize_ = file.size();
+
+    JsonStream json(file);
+    QByteArray key;
+    bool ok = json.expect('{');
+    bool first = true;
+    while (ok && json.nextItem('}', first)) {
+        ok = json.readString(key) && json.expect(':');
+        if (!ok) {
+            break;
+        }
+        if (key == "images") {
+            ok = readImagesArray(json, control);
+        } else if (key == "annotations") {
+            ok = readAnnotationsArray(json, control);
+        } else if (key == "categories") {
+            ok = readCategoriesArray(json);
+        } else {
+            ok = json.skipValue(); // info、licenses 等
+        }
+    }
+    if (cancelled_) {
+        return false;
+    }
+    if (!ok || json.atError()) {
+        note(ParseReport::MalformedFile, filePath,
+             wantsSample(ParseReport::MalformedFile) ? QString("第 %1 字节附近").arg(json.bytesRead()) : QString());
+        return false;
+    }
+
+    // 按图片分组（计数排序，同一图片内保持原来的顺序），每张图片写入 store 的一个文件
+    QHash<qint64, int> imageIndex;
+    imageIndex.reserve(images_.size());
+    for (int i = 0; i < images_.size(); ++i) {
+        if (images_[i].id != kInvalidId) {
+            imageIndex.insert(images_[i].id, i);
+        }
+    }
+    QVector<int> boxImage(boxes_.size());
+    QVector<int> offsets(images_.size() + 1, 0);
+    for (qsizetype b = 0; b < boxes_.size(); ++b) {
+        const int image = imageIndex.value(boxes_[b].imageId, -1);
+        boxImage[b] = image;
+        if (image >= 0) {
+            ++offsets[image + 1];
+        } else {
+            note(ParseReport::UnknownImage, filePath,
+                 wantsSample(ParseReport::UnknownImage) ? "image_id " + QString::number(boxes_[b].imageId) : QString());
+        }
+    }
+    for (int i = 0; i < images_.size(); ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+    QVector<int> order(offsets.last());
+    {
+        QVector<int> cursor = offsets;
+        for (qsizetype b = 0; b < boxes_.size(); ++b) {
+            if (boxImage[b] >= 0) {
+                order[cursor[boxImage[b]]++] = int(b);
+            }
+        }
+    }
+
+    QHash<qint64, int> labelOfCategory;
+    store.reserveBoxes(store.boxCount() + order.size());
+    QVector<QString> imageNames;
+    imageNames.reserve(images_.size());
+    for (int i = 0; i < images_.size(); ++i) {
+        const ImageInfo& image = images_[i];
+        store.beginFile();
+        store.setImageSize(image.width, image.height);
+        imageNames.append(image.fileName.isEmpty() ? QString::number(image.id) : image.fileName);
+        for (int k = offsets[i]; k < offsets[i + 1]; ++k) {
+            const PendingBox& box = boxes_[order[k]];
+            auto labelIt = labelOfCategory.constFind(box.categoryId);
+            if (labelIt == labelOfCategory.constEnd()) {
+                // 没有出现在 categories 中的类别用类别 id 作为标签名
+                const QString name = categories_.value(box.categoryId, QString::number(box.categoryId));
+                labelIt = labelOfCategory.insert(box.categoryId, store.internLabel(name));
+            }
+            store.addBox(labelIt.value(), box.xmin, box.ymin, box.xmax, box.ymax);
+        }
+    }
+    imageIds += paths.addAll(imageNames); // file_name 是相对路径，同样按目录前缀共享
+
+    if (control.progress) {
+        control.progress(fileSize_, fileSize_, int(images_.size()));
+    }
+    images_ = QVector<ImageInfo>(); // 释放暂存的内容
+    boxes_ = QVector<PendingBox>();
+    categories_.clear();
+    return true;
+}
+
+bool CocoReader::readImagesArray(JsonStream& json, const ReadControl& control)
+{
+    if (!json.expect('[')) {
+        return false;
+    }
+    QByteArray key;
+    QByteArray text;
+    bool first = true;
+    while (json.nextItem(']', first)) {
+        if (!json.expect('{')) {
+            return false;
+        }
+        ImageInfo image;
+        image.id = kInvalidId; // 没有 id 的图片不对应任何标注，不能当作 id 0
+        bool firstField = true;
+        while (json.nextItem('}', firstField)) {
+            if (!json.readString(key) || !json.expect(':')) {
+                return false;
+            }
+            double value = 0;
+            bool present = false;
+            bool ok = true;
+            if (key == "id") {
+                ok = json.readNumberOrSkip(value, present);
+                if (!present || !toInteger(value, image.id)) {
+                    image.id = kInvalidId; // null 或超出范围
+                }
+            } else if (key == "file_name") {
+                text.clear(); // 不是字符串时不能沿用上一张图片的名字，名字为空时按 id 命名
+                ok = json.peek() == '"' ? json.readString(text) : json.skipValue();
+                image.fileName = QString::fromUtf8(text);
+            } else if (key == "width") {
+                ok = json.readNumberOrSkip(value, present);
+                if (!toInteger(value, image.width)) {
+                    image.width = 0; // 未知
+                }
+            } else if (key == "height") {
+                ok = json.readNumberOrSkip(value, present);
+                if (!toInteger(value, image.height)) {
+                    image.height = 0;
+                }
+            } else {
+                ok = json.skipValue();
+            }
+            if (!ok) {
+                return false;
+            }
+        }
+        if (json.atError()) {
+            return false;
+        }
+        images_.append(image);
+        if (!checkpoint(json, control)) {
+            return false;
+        }
+    }
+    return !json.atError();
+}
+
+bool CocoReader::readAnnotationsArray(JsonStream& json, const ReadControl& control)
+{
+    if (!json.expect('[')) {
+        return false;
+    }
+    QByteArray key;
+    bool first = true;
+    while (json.nextItem(']', first)) {
+        if (!json.expect('{')) {
+            return false;
+        }
+        PendingBox box{0, 0, 0, 0, 0, 0};
+        double bbox[4] = {0, 0, 0, 0};
+        int bboxValues = 0;
+        bool firstField = true;
+        while (json.nextItem('}', firstField)) {
+            if (!json.readString(key) || !json.expect(':')) {
+                return false;
+            }
+            double value = 0;
+            bool present = false;
+            bool ok = true;
+            if (key == "image_id") {
+                ok = json.readNumberOrSkip(value, present);
+                if (!toInteger(value, box.imageId)) {
+                    box.imageId = kInvalidId; // 之后按引用了不存在的图片报告
+                }
+            } else if (key == "category_id") {
+                ok = json.readNumberOrSkip(value, present);
+                if (!toInteger(value, box.categoryId)) {
+                    box.categoryId = kInvalidId;
+                }
+            } else if (key == "bbox" && json.peek() == '[') {
+                json.expect('[');
+                bool firstValue = true;
+                while (ok && json.nextItem(']', firstValue)) {
+                    ok = json.readNumberOrSkip(value, present);
+                    if (present && bboxValues < 4) {
+                        bbox[bboxValues++] = value;
+                    }
+                }
+                ok = ok && !json.atError();
+            } else {
+                ok = json.skipValue(); // segmentation、area、iscrowd 等
+            }
+            if (!ok) {
+                return false;
+            }
+        }
+        if (json.atError()) {
+            return false;
+        }
+
+        // bbox 为 [x, y, 宽, 高]，换算成 VOC 的像素坐标，框覆盖 [x, x + 宽) 中的全部像素
+        // 坐标超出 int 范围的框按无效框处理
+        int xEnd = 0;
+        int yEnd = 0;
+        if (bboxValues == 4 && bbox[2] > 0 && bbox[3] > 0
+            && toInteger(std::floor(bbox[0]), box.xmin) && toInteger(std::floor(bbox[1]), box.ymin)
+            && toInteger(std::ceil(bbox[0] + bbox[2]), xEnd) && toInteger(std::ceil(bbox[1] + bbox[3]), yEnd)) {
+            box.xmax = int(qMax<qint64>(box.xmin, qint64(xEnd) - 1));
+            box.ymax = int(qMax<qint64>(box.ymin, qint64(yEnd) - 1));
+            boxes_.append(box);
+        } else {
+            note(ParseReport::InvalidBndbox, filePath_,
+                 wantsSample(ParseReport::InvalidBndbox) ? "image_id " + QString::number(box.imageId) : QString());
+        }
+        if (!checkpoint(json, control)) {
+            return false;
+        }
+    }
+    return !json.atError();
+}
+
+bool CocoReader::readCategoriesArray(JsonStream& json)
+{
+    if (!json.expect('[')) {
+        return false;
+    }
+    QByteArray key;
+    QByteArray name;
+    bool first = true;
+    while (json.nextItem(']', first)) {
+        if (!json.expect('{')) {
+            return false;
+        }
+        double id = 0;
+        bool hasId = false;
+        bool hasName = false;
+        bool firstField = true;
+        while (json.nextItem('}', firstField)) {
+            if (!json.readString(key) || !json.expect(':')) {
+                return false;
+            }
+            bool ok = true;
+            if (key == "id") {
+                ok = json.readNumberOrSkip(id, hasId);
+            } else if (key == "name" && json.peek() == '"') {
+                ok = json.readString(name);
+                hasName = ok;
+            } else {
+                ok = json.skipValue();
+            }
+            if (!ok) {
+                return false;
+            }
+        }
+        if (json.atError()) {
+            return false;
+        }
+        qint64 categoryId = 0;
+        if (hasId && hasName && toInteger(id, categoryId)) {
+            categories_.insert(categoryId, QString::fromUtf8(name));
+        }
+    }
+    return !json.atError();
+}
+
+bool CocoReader::checkpoint(JsonStream& json, const ReadControl& control)
+{
+    if (++itemsSinceCheckpoint_ < kCheckpointInterval) {
+        return true;
+    }
+    itemsSinceCheckpoint_ = 0;
+    if (control.cancel && control.cancel->load()) {
+        cancelled_ = true;
+        return false;
+    }
+    if (control.progress) {
+        control.progress(json.bytesRead(), fileSize_, int(images_.size()));
+    }
+    return true;
+}
@@ -0,0 +1,94 @@
+#ifndef COCOREADER_H
+#define COCOREADER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include "annotationreader.h"
+
+// COCO 格式：一个 instances.json 包含全部图片
+// 文件可能有数 GB，不能整体读入 QJsonDocument：这里按块读取，用一个只向前的 JSON 词法分析器
+// 取出 images / annotations / categories 中需要的字段，segmentation 等其余内容直接跳过
+// annotations 可能排在 images、categories 之前，也不保证按图片分组，
+// 所以先把每个框压缩成定长记录暂存，读完后按图片分组写入 store
+class CocoReader : public AnnotationReader
+{
+public:
+    AnnotationFormat format() const override { return AnnotationFormat::Coco; }
+    bool isPerImage() const override { return false; }
+
+    // COCO 文件包含多张图片，不能按单张图片解析，始终返回 0
+    int parseInto(const QString& filePath, AnnotationStore& store) override;
+    bool readImages(const QString& filePath, AnnotationStore& store, PathTable& paths,
+                    QVector<PathId>& imageIds, const ReadControl& control) override;
+
+private:
+    // 只向前的 JSON 读取器，按需从文件补充缓冲区
+    class JsonStream
+    {
+    public:
+        explicit JsonStream(QFile& file);
+
+        bool atError() const { return error_; }
+        qint64 bytesRead() const { return consumed_ + pos_; }
+
+        // 跳过空白后查看下一个字符，文件结束时返回 0
+        char peek();
+        // 下一个字符必须是 c
+        bool expect(char c);
+        // 对象/数组中的下一项：遇到 close 时消费它并返回 false，遇到 ',' 时消费它
+        bool nextItem(char close, bool& first);
+        bool readString(QByteArray& out);
+        bool readNumber(double& out);
+        // 数字字段：是数字时读取并设置 present，否则（如 null）跳过
+        bool readNumberOrSkip(double& out, bool& present);
+        bool skipValue();
+
+    private:
+        bool fill();
+        bool take(char& c);
+
+        QFile& file_;
+        QByteArray buffer_;
+        qsizetype pos_ = 0;
+        qint64 consumed_ = 0;
+        bool error_ = false;
+    };
+
+    // 暂存的一个框，坐标已换算成 VOC 像素坐标
+    struct PendingBox
+    {
+        qint64 imageId;
+        qint64 categoryId;
+        int xmin;
+        int ymin;
+        int xmax;
+        int ymax;
+    };
+
+    struct ImageInfo
+    {
+        qint64 id = 0;
+        QString fileName;
+        int width = 0;
+        int height = 0;
+    };
+
+    bool readImagesArray(JsonStream& json, const ReadControl& control);
+    bool readAnnotationsArray(JsonStream& json, const ReadControl& control);
+    bool readCategoriesArray(JsonStream& json);
+    // 每读若干项检查一次取消并报告进度，被取消时返回 false
+    bool checkpoint(JsonStream& json, const ReadControl& control);
+
+    qint64 fileSize_ = 0;
+    int itemsSinceCheckpoint_ = 0;
+    bool cancelled_ = false;
+    QString filePath_; // 正在读取的文件，用于数据质量报告
+    QVector<ImageInfo> images_;
+    QVector<PendingBox> boxes_;
+    QHash<qint64, QString> categories_;
+};
+
+#endif // COCOREADER_H
@@ -0,0 +1,200 @@
+#include "datasetsample.h"
+#include "datasetstats.h"
+#include <QHash>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double kZ95 = 1.959964; // 95% 置信区间的正态分位数
+
+// 一个变量在一层中的和与平方和
+struct Moments
+{
+    double sum = 0.0;
+    double sumSquares = 0.0;
+
+    void add(double y)
+    {
+        sum += y;
+        sumSquares += y * y;
+    }
+};
+
+// 各层结果的累加：总数估计与方差
+struct StratifiedTotal
+{
+    double total = 0.0;
+    double variance = 0.0;
+
+    // 抽样时每层至少抽 2 个文件，只有一个样本的层一定整层只有一个文件，有限总体校正 1 - n/N 为 0，方差确实为 0
+    void addStratum(const Moments& m, int stratumSize, int sampled)
+    {
+        const double N = stratumSize;
+        const double n = sampled;
+        total += N * m.sum / n;
+        if (sampled > 1) {
+            const double s2 = qMax(0.0, (m.sumSquares - m.sum * m.sum / n) / (n - 1));
+            variance += N * N * (1.0 - n / N) * s2 / n;
+        }
+    }
+
+    DatasetEstimate::Value value() const { return {total, kZ95 * std::sqrt(variance)}; }
+};
+
+} // namespace
+
+DatasetSample DatasetSample::draw(const QVector<PathId>& allFiles, const PathTable& paths, int sampleSize, bool stratified,
+                                  quint32 seed)
+{
+    DatasetSample sample;
+    const int total = int(allFiles.size());
+    sample.totalFiles = total;
+
+    // 分层：每层为一个目录中的文件下标
+    QVector<QVector<int>> members;
+    if (stratified && sampleSize < total) {
+        QHash<int, int> stratumOfDir;
+        for (int i = 0; i < total; ++i) {
+            const int dir = paths.directory(allFiles[i]);
+            auto it = stratumOfDir.constFind(dir);
+            if (it == stratumOfDir.constEnd()) {
+                it = stratumOfDir.insert(dir, members.size());
+                members.append(QVector<int>());
+            }
+            members[it.value()].append(i);
+        }
+    }
+    if (members.isEmpty() || members.size() > sampleSize / 2) {
+        members = {QVector<int>()};
+        members[0].reserve(total);
+        for (int i = 0; i < total; ++i) {
+            members[0].append(i);
+        }
+    }
+
+    QRandomGenerator rng(seed);
+    const int budget = qMin(sampleSize, total);
+    sample.files.reserve(budget + 2 * members.size());
+    for (int h = 0; h < members.size(); ++h) {
+        QVector<int>& indices = members[h];
+        const int size = int(indices.size());
+        // 每层至少 2 个才能估计层内方差；层数不超过样本数的一半，总数不会超出太多
+        const int wanted = qBound(qMin(2, size), int(std::llround(double(budget) * size / qMax(1, total))), size);
+        // 部分 Fisher-Yates：前 wanted 个即为无放回的随机样本
+        for (int k = 0; k < wanted; ++k) {
+            const int j = k + int(rng.bounded(quint32(size - k)));
+            std::swap(indices[k], indices[j]);
+        }
+        std::sort(indices.begin(), indices.begin() + wanted); // 层内按原顺序读取，对磁盘更友好
+        for (int k = 0; k < wanted; ++k) {
+            sample.files.append(allFiles[indices[k]]);
+            sample.sourceIndex.append(indices[k]);
+            sample.stratumOf.append(h);
+        }
+        sample.stratumSize.append(size);
+        sample.stratumSampled.append(wanted);
+    }
+    return sample;
+}
+
+QVector<PathId> DatasetSample::remainingFiles(const QVector<PathId>& allFiles) const
+{
+    QVector<bool> sampled(allFiles.size(), false);
+    for (int index : sourceIndex) {
+        sampled[index] = true;
+    }
+    QVector<PathId> rest;
+    rest.reserve(allFiles.size() - sourceIndex.size());
+    for (int i = 0; i < allFiles.size(); ++i) {
+        if (!sampled[i]) {
+            rest.append(allFiles[i]);
+        }
+    }
+    return rest;
+}
+
+DatasetEstimate DatasetEstimate::compute(const DatasetSample& sample, const DatasetStats& sampleStats,
+                                         const HistogramSpec& spec)
+{
+    DatasetEstimate estimate;
+    estimate.totalFiles = sample.totalFiles;
+    estimate.sampledFiles = int(sample.files.size());
+    estimate.strata = int(sample.stratumSize.size());
+    estimate.spec = spec;
+
+    const QVector<int>& objectsPerFile = sampleStats.objectsPerFile;
+    const AnnotationStore* store = sampleStats.store.data();
+    if (!store || objectsPerFile.size() != sample.files.size()) {
+        return estimate; // 样本统计不完整（被取消）
+    }
+
+    const int binCount = spec.binCount();
+    const int labelCount = store->labelCount();
+    const int* labelIds = store->labelIds().constData();
+
+    StratifiedTotal validTotal;
+    QVector<StratifiedTotal> binTotals(binCount);
+    QVector<StratifiedTotal> labelTotals(labelCount);
+
+    // 标签很多、层也很多时不能每层清零整个数组，只记录本层/本文件出现过的标签
+    QVector<Moments> labelMoments(labelCount);
+    QVector<int> fileLabelCounts(labelCount, 0);
+    QVector<int> stratumLabels;
+    QVector<int> fileLabels;
+
+    int file = 0;
+    for (int h = 0; h < estimate.strata; ++h) {
+        const int sampled = sample.stratumSampled[h];
+        Moments valid;
+        QVector<Moments> bins(binCount);
+        for (int k = 0; k < sampled; ++k, ++file) {
+            const int objects = objectsPerFile[file];
+            const int bin = objects > 0 ? spec.binOf(objects) : -1;
+            valid.add(objects > 0 ? 1.0 : 0.0);
+            for (int b = 0; b < binCount; ++b) {
+                bins[b].add(b == bin ? 1.0 : 0.0);
+            }
+
+            const qsizetype begin = store->fileBegin(file);
+            const qsizetype end = begin + store->fileBoxCount(file);
+            for (qsizetype box = begin; box < end; ++box) {
+                if (fileLabelCounts[labelIds[box]]++ == 0) {
+                    fileLabels.append(labelIds[box]);
+                }
+            }
+            for (int label : std::as_const(fileLabels)) {
+                if (labelMoments[label].sum == 0.0) {
+                    stratumLabels.append(label);
+                }
+                labelMoments[label].add(fileLabelCounts[label]);
+                fileLabelCounts[label] = 0;
+            }
+            fileLabels.clear();
+        }
+
+        const int size = sample.stratumSize[h];
+        validTotal.addStratum(valid, size, sampled);
+        for (int b = 0; b < binCount; ++b) {
+            binTotals[b].addStratum(bins[b], size, sampled);
+        }
+        // 本层没有出现的标签均值和方差都为 0，不影响结果
+        for (int label : std::as_const(stratumLabels)) {
+            labelTotals[label].addStratum(labelMoments[label], size, sampled);
+            labelMoments[label] = Moments();
+        }
+        stratumLabels.clear();
+    }
+
+    estimate.validFiles = validTotal.value();
+    for (const StratifiedTotal& bin : std::as_const(binTotals)) {
+        estimate.distribution.append(bin.value());
+    }
+    for (int label = 0; label < labelCount; ++label) {
+        if (labelTotals[label].total > 0.0) {
+            estimate.labelCounts.insert(store->labelName(label), labelTotals[label].value());
+        }
+    }
+    return estimate;
+}
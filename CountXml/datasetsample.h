@@ -0,0 +1,60 @@
+#ifndef DATASETSAMPLE_H
+#define DATASETSAMPLE_H
+
+#include <QMap>
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+#include "histogram.h"
+#include "pathtable.h"
+
+struct DatasetStats;
+
+// 抽样预览使用的样本
+// 分层抽样时按文件所在目录分层，每层按文件数成比例分配样本（每层至少 2 个，用于估计层内方差），层内无放回随机抽取；
+// 目录太多（超过样本数的一半）时每层只能抽到一两个文件，改用简单随机抽样
+struct DatasetSample
+{
+    QVector<PathId> files;       // 抽中的文件，按层依次排列
+    QVector<int> sourceIndex;    // 每个抽中文件在原文件列表中的下标
+    QVector<int> stratumOf;      // 每个抽中文件所在的层
+    QVector<int> stratumSize;    // 每层的文件总数 N_h
+    QVector<int> stratumSampled; // 每层抽中的文件数 n_h
+    int totalFiles = 0;
+
+    bool coversAll() const { return files.size() >= totalFiles; }
+
+    // seed 相同时抽到的文件相同，方便复现
+    // 文件所在目录取自 paths
+    static DatasetSample draw(const QVector<PathId>& allFiles, const PathTable& paths, int sampleSize, bool stratified,
+                              quint32 seed);
+    // 没有抽中的文件，保持原来的顺序
+    QVector<PathId> remainingFiles(const QVector<PathId>& allFiles) const;
+};
+
+// 由样本推算的全数据集统计，每个值附带 95% 置信区间的半宽（value ± margin）
+// 使用分层估计：总数 = Σ N_h·均值_h，方差 = Σ N_h²·(1 - n_h/N_h)·s_h²/n_h
+struct DatasetEstimate
+{
+    struct Value
+    {
+        double value = 0.0;
+        double margin = 0.0;
+    };
+
+    int totalFiles = 0;
+    int sampledFiles = 0;
+    int strata = 0;
+    HistogramSpec spec;
+    Value validFiles;
+    QVector<Value> distribution;   // 每个区间的文件数
+    QMap<QString, Value> labelCounts;
+
+    // sampleStats 必须是按 sample.files 的顺序统计的结果（objectsPerFile 与 files 一一对应）
+    static DatasetEstimate compute(const DatasetSample& sample, const DatasetStats& sampleStats,
+                                   const HistogramSpec& spec);
+};
+
+Q_DECLARE_METATYPE(DatasetEstimate)
+
+#endif // DATASETSAMPLE_H
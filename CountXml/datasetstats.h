@@ -0,0 +1,87 @@
+#ifndef DATASETSTATS_H
+#define DATASETSTATS_H
+
+#include <QVector>
+#include <QMap>
+#include <QString>
+#include <QMetaType>
+#include <QSharedPointer>
+#include "annotationstore.h"
+#include "annotationquery.h"
+#include "directorystats.h"
+#include "histogram.h"
+#include "geometrystats.h"
+#include "parsereport.h"
+#include "pathtable.h"
+
+// 一次遍历数据集得到的全部统计结果，"统计标签分布" 和 "统计标签个数" 共用
+struct DatasetStats
+{
+    QVector<int> distribution = QVector<int>(HistogramSpec::defaultSpec().binCount(), 0); // 每张图片的标签个数分布
+    QMap<QString, int> labelCounts;  // 每个标签的框数
+    int validFiles = 0;              // 至少包含一个 object 的文件数
+    QVector<int> objectsPerFile;     // 每张图片的标签个数（与 store 的文件序号一一对应），换区间时据此重新分箱
+    QVector<PathId> images;          // 每张图片在 paths 中的序号：VOC/YOLO 为标注文件路径，COCO 为 file_name
+    QSharedPointer<const PathTable> paths;
+    int sourceFiles = 0;             // 已经完整读取的输入文件数，COCO 中一个文件包含多张图片
+    QSharedPointer<const AnnotationStore> store; // 全部标注的列存储，进度信号中为空
+    QSharedPointer<const AnnotationIndex> index; // store 的标签倒排表，用于筛选图片，进度信号中为空
+    GeometryStats geometry;          // 每个标签的面积/宽高比/位置分布，只在最终结果中计算
+    DirectoryStats directories;      // 按子目录汇总的分布和标签个数，只在最终结果中计算
+    ParseReport report;              // 数据质量问题（命中解析缓存的文件没有问题，见 XmlProcessor::parseWithCache）
+
+    // 第 fileIndex 张图片的名字
+    QString imageName(int fileIndex) const
+    {
+        return paths && fileIndex >= 0 && fileIndex < images.size() ? paths->path(images[fileIndex]) : QString();
+    }
+
+    // 在列存储上计算全部统计结果（不设置 store 指针），分布按 spec 分箱
+    static DatasetStats fromStore(const AnnotationStore& annotations,
+                                  const HistogramSpec& spec = HistogramSpec::defaultSpec())
+    {
+        DatasetStats stats;
+        stats.objectsPerFile = annotations.fileBoxCounts(); // 隐式共享，不复制
+        stats.distribution = spec.apply(stats.objectsPerFile);
+        for (int objectCount : std::as_const(stats.objectsPerFile))
+        {
+            if (objectCount > 0) // 如果文件没有object，则不计入
+            {
+                stats.validFiles++;
+            }
+        }
+        stats.labelCounts = labelCountsOf(annotations);
+        return stats;
+    }
+
+    // 每个标签的框数，只遍历标签，不遍历文件
+    static QMap<QString, int> labelCountsOf(const AnnotationStore& annotations)
+    {
+        QMap<QString, int> labelCounts;
+        const QVector<qint64>& boxCounts = annotations.labelBoxCounts();
+        for (int labelId = 0; labelId < boxCounts.size(); ++labelId)
+        {
+            if (boxCounts[labelId] > 0) // 解析失败回滚的文件可能留下框数为 0 的标签
+            {
+                labelCounts.insert(annotations.labelName(labelId), int(boxCounts[labelId]));
+            }
+        }
+        return labelCounts;
+    }
+};
+
+// 统计过程中的进度
+struct DatasetProgress
+{
+    int filesDone = 0;
+    int totalFiles = 0;
+    double filesPerSecond = 0.0;
+    qint64 bytesDone = 0;  // 多图片格式（COCO）按字节报告进度，bytesTotal 为 0 时按文件数
+    qint64 bytesTotal = 0;
+    DatasetStats partial; // 到目前为止的结果，不含 objectsPerFile
+};
+
+Q_DECLARE_METATYPE(DatasetStats)
+Q_DECLARE_METATYPE(DatasetProgress)
+
+#endif // DATASETSTATS_H
@@ -0,0 +1,288 @@
+#include "datasetwatcher.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <algorithm>
+
+DatasetWatcher::DatasetWatcher(QSharedPointer<PathTable> paths, QObject *parent)
+    : QObject(parent), paths_(std::move(paths))
+{
+    // 子对象随 moveToThread 一起移到后台线程
+    watcher_ = new QFileSystemWatcher(this);
+    debounceTimer_ = new QTimer(this);
+    debounceTimer_->setSingleShot(true);
+    debounceTimer_->setInterval(kDebounceMs);
+    sweepTimer_ = new QTimer(this);
+    sweepTimer_->setInterval(kSweepIntervalMs);
+    sweepStepTimer_ = new QTimer(this);
+    sweepStepTimer_->setSingleShot(true);
+    sweepStepTimer_->setInterval(0); // 先处理排在前面的其他请求
+
+    connect(watcher_, &QFileSystemWatcher::directoryChanged, this, &DatasetWatcher::onDirectoryChanged);
+    connect(watcher_, &QFileSystemWatcher::fileChanged, this, &DatasetWatcher::onFileChanged);
+    connect(debounceTimer_, &QTimer::timeout, this, &DatasetWatcher::processPending);
+    connect(sweepTimer_, &QTimer::timeout, this, &DatasetWatcher::sweep);
+    connect(sweepStepTimer_, &QTimer::timeout, this, &DatasetWatcher::sweepStep);
+}
+
+void DatasetWatcher::setPathTable(const QSharedPointer<PathTable>& paths)
+{
+    stop();
+    paths_ = paths;
+}
+
+void DatasetWatcher::watch(const QString& dir, const QStringList& nameFilters, const QStringList& excludedNames,
+                           const QVector<PathId>& files, int watchId)
+{
+    stop();
+    root_ = dir;
+    nameFilters_ = nameFilters;
+    excludedNames_ = excludedNames;
+    watchId_ = watchId;
+    watchFiles_ = files.size() <= kMaxFileWatches;
+
+    QStringList filePaths;
+    QVector<PathId> fileIds;
+    QSet<PathId> removed; // 扫描之后、开始监视之前就被删掉的文件
+    for (PathId id : files) {
+        const QString path = paths_->path(id);
+        const QFileInfo info(path);
+        if (!info.exists()) {
+            removed.insert(id);
+            continue;
+        }
+        states_.insert(id, {info.size(), info.lastModified().toMSecsSinceEpoch()});
+        filesByDirectory_[info.path()].insert(id);
+        if (watchFiles_) {
+            filePaths << path;
+            fileIds << id;
+        }
+    }
+    if (!filePaths.isEmpty()) {
+        const QStringList failedList = watcher_->addPaths(filePaths);
+        const QSet<QString> failed(failedList.constBegin(), failedList.constEnd());
+        for (int i = 0; i < filePaths.size(); ++i) {
+            if (failed.contains(filePaths[i])) {
+                unwatchedDirs_.insert(QFileInfo(filePaths[i]).path());
+            } else {
+                watchedFiles_.insert(fileIds[i]);
+            }
+        }
+    }
+
+    watchDirectory(root_);
+    QDirIterator it(root_, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        watchDirectory(it.next());
+    }
+    if (!unwatchedDirs_.isEmpty()) {
+        qDebug() << "监视线程:" << unwatchedDirs_.size() << "个目录无法使用文件系统通知，只能等定时检查";
+    }
+    qDebug() << "监视线程: 开始监视" << root_ << "目录数：" << watchedDirs_.size() << "文件数：" << states_.size();
+
+    sweepTimer_->start();
+    emitChanges(QSet<PathId>(), removed);
+}
+
+void DatasetWatcher::stop()
+{
+    debounceTimer_->stop();
+    sweepTimer_->stop();
+    sweepStepTimer_->stop();
+    sweepQueue_.clear();
+    const QStringList watched = watcher_->files() + watcher_->directories();
+    if (!watched.isEmpty()) {
+        watcher_->removePaths(watched);
+    }
+    pendingDirs_.clear();
+    states_.clear();
+    filesByDirectory_.clear();
+    watchedDirs_.clear();
+    unwatchedDirs_.clear();
+    watchedFiles_.clear();
+    root_.clear();
+}
+
+void DatasetWatcher::onDirectoryChanged(const QString& dir)
+{
+    pendingDirs_.insert(dir);
+    debounceTimer_->start(); // 重新计时，连续的通知合并成一批
+}
+
+void DatasetWatcher::onFileChanged(const QString& filePath)
+{
+    // 先取消监视，重新列目录时再加回来（内容没变的文件也加回来）：
+    // 整体替换保存（写临时文件再改名）后原来的监视已经失效
+    watcher_->removePath(filePath);
+    watchedFiles_.remove(paths_->find(filePath));
+    pendingDirs_.insert(QFileInfo(filePath).path());
+    debounceTimer_->start();
+}
+
+void DatasetWatcher::processPending()
+{
+    if (root_.isEmpty()) {
+        return;
+    }
+    QSet<PathId> changed;
+    QSet<PathId> removed;
+    const QSet<QString> dirs = std::exchange(pendingDirs_, QSet<QString>());
+    for (const QString& dir : dirs) {
+        checkDirectory(dir, changed, removed);
+    }
+    emitChanges(changed, removed);
+}
+
+void DatasetWatcher::sweep()
+{
+    if (root_.isEmpty() || !sweepQueue_.isEmpty()) {
+        return; // 上一轮还没检查完
+    }
+    // 逐个监视了文件时只有无法监视的目录可能漏掉变化；否则原地改写没有目录通知，全部目录都要检查
+    const QSet<QString>& dirs = watchFiles_ ? unwatchedDirs_ : watchedDirs_;
+    sweepQueue_ = QStringList(dirs.constBegin(), dirs.constEnd());
+    sweepStep();
+}
+
+void DatasetWatcher::sweepStep()
+{
+    QSet<PathId> changed;
+    QSet<PathId> removed;
+    for (int i = 0; i < kSweepChunkDirs && !sweepQueue_.isEmpty(); ++i) {
+        const QString dir = sweepQueue_.takeLast();
+        if (watchedDirs_.contains(dir)) { // 排队期间可能已随上级目录一起删除
+            checkDirectory(dir, changed, removed);
+        }
+    }
+    emitChanges(changed, removed);
+    if (!sweepQueue_.isEmpty()) {
+        sweepStepTimer_->start();
+    }
+}
+
+void DatasetWatcher::checkDirectory(const QString& dir, QSet<PathId>& changed, QSet<PathId>& removed)
+{
+    if (QFileInfo(dir).isDir()) {
+        rescanDirectory(dir, changed, removed);
+    } else {
+        removeDirectory(dir, removed);
+    }
+}
+
+void DatasetWatcher::rescanDirectory(const QString& dir, QSet<PathId>& changed, QSet<PathId>& removed)
+{
+    QSet<PathId>& known = filesByDirectory_[dir];
+    QSet<PathId> seen;
+    const QFileInfoList entries = QDir(dir).entryInfoList(nameFilters_, QDir::Files | QDir::Readable);
+    for (const QFileInfo& info : entries) {
+        if (!isAnnotation(info.fileName())) {
+            continue;
+        }
+        const PathId id = paths_->add(info.filePath());
+        seen.insert(id);
+        if (watchFiles_ && !watchedFiles_.contains(id)) {
+            watchFile(id, info.filePath(), dir);
+        }
+        const FileState state{info.size(), info.lastModified().toMSecsSinceEpoch()};
+        auto it = states_.find(id);
+        if (it != states_.end() && *it == state) {
+            continue;
+        }
+        states_.insert(id, state);
+        known.insert(id);
+        changed.insert(id);
+        removed.remove(id);
+    }
+
+    for (auto it = known.begin(); it != known.end();) {
+        if (seen.contains(*it)) {
+            ++it;
+            continue;
+        }
+        states_.remove(*it);
+        unwatchFile(*it);
+        changed.remove(*it);
+        removed.insert(*it);
+        it = known.erase(it);
+    }
+
+    // 新出现的子目录（例如整个文件夹拷进来）：加入监视并立即列出其中的文件
+    const QStringList subDirs = QDir(dir).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString& name : subDirs) {
+        const QString subDir = dir + '/' + name;
+        if (!watchedDirs_.contains(subDir)) {
+            watchDirectory(subDir);
+            rescanDirectory(subDir, changed, removed);
+        }
+    }
+}
+
+void DatasetWatcher::removeDirectory(const QString& dir, QSet<PathId>& removed)
+{
+    const QString prefix = dir + '/';
+    for (auto it = filesByDirectory_.begin(); it != filesByDirectory_.end();) {
+        if (it.key() != dir && !it.key().startsWith(prefix)) {
+            ++it;
+            continue;
+        }
+        for (PathId id : std::as_const(it.value())) {
+            states_.remove(id);
+            unwatchFile(id);
+            removed.insert(id);
+        }
+        it = filesByDirectory_.erase(it);
+    }
+    for (QSet<QString>* dirs : {&watchedDirs_, &unwatchedDirs_}) {
+        for (auto it = dirs->begin(); it != dirs->end();) {
+            if (*it == dir || it->startsWith(prefix)) {
+                it = dirs->erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+void DatasetWatcher::watchDirectory(const QString& dir)
+{
+    watchedDirs_.insert(dir);
+    if (!watcher_->addPath(dir)) {
+        unwatchedDirs_.insert(dir); // 无法监视的目录也记下来，定时检查时照样列出
+    }
+}
+
+void DatasetWatcher::watchFile(PathId id, const QString& filePath, const QString& dir)
+{
+    if (watchedFiles_.size() < kMaxFileWatches && watcher_->addPath(filePath)) {
+        watchedFiles_.insert(id);
+    } else {
+        unwatchedDirs_.insert(dir);
+    }
+}
+
+void DatasetWatcher::unwatchFile(PathId id)
+{
+    if (watchedFiles_.remove(id)) {
+        watcher_->removePath(paths_->path(id));
+    }
+}
+
+void DatasetWatcher::emitChanges(const QSet<PathId>& changed, const QSet<PathId>& removed)
+{
+    if (changed.isEmpty() && removed.isEmpty()) {
+        return;
+    }
+    QVector<PathId> changedList(changed.constBegin(), changed.constEnd());
+    QVector<PathId> removedList(removed.constBegin(), removed.constEnd());
+    std::sort(changedList.begin(), changedList.end()); // 按加入路径表的顺序，新文件排在已有文件之后
+    std::sort(removedList.begin(), removedList.end());
+    qDebug() << "监视线程: 变化的文件数：" << changedList.size() << "删除的文件数：" << removedList.size();
+    emit filesChanged(watchId_, changedList, removedList);
+}
+
+bool DatasetWatcher::isAnnotation(const QString& fileName) const
+{
+    return excludedNames_.isEmpty() || !excludedNames_.contains(fileName);
+}
@@ -0,0 +1,94 @@
+#ifndef DATASETWATCHER_H
+#define DATASETWATCHER_H
+
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include "pathtable.h"
+
+// 监视已加载的数据集目录，标注员保存文件后通知界面哪些文件变了
+// 目录用文件系统通知监视（新增、删除、改名）；文件不多时也逐个监视文件本身，原地改写也能立即发现；
+// 无法监视的目录和文件（网络盘、inotify 数量上限）另外定时重新列一遍，比较大小和修改时间；
+// 文件太多不逐个监视时原地改写不会触发目录通知，这时定时检查覆盖全部目录
+// 定时检查每次只列 kSweepChunkDirs 个目录，之间让出线程，不会长时间挡住同一线程上的扫描
+// 收到通知后等 kDebounceMs 没有新通知再处理，同一批变化只发一次 filesChanged
+// 与 XmlScanner 在同一个后台线程中运行，列目录和取文件信息不会卡住界面
+class DatasetWatcher : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr int kDebounceMs = 500;
+    static constexpr int kSweepIntervalMs = 10 * 60 * 1000;
+    static constexpr int kSweepChunkDirs = 64;
+    static constexpr int kMaxFileWatches = 4096; // 文件数不超过这个值时逐个监视文件
+
+    explicit DatasetWatcher(QSharedPointer<PathTable> paths, QObject *parent = nullptr);
+
+public slots:
+    // 开始监视 dir 及其子目录，files 为扫描得到的文件，以它们当前的大小和修改时间为基准
+    // nameFilters、excludedNames 与扫描时相同；watchId 由调用方分配，用来丢弃旧监视发出的通知
+    void watch(const QString& dir, const QStringList& nameFilters, const QStringList& excludedNames,
+               const QVector<PathId>& files, int watchId);
+    void stop();
+    // 换用另一个路径表，同时停止监视（记录的文件序号属于旧表）
+    void setPathTable(const QSharedPointer<PathTable>& paths);
+
+signals:
+    // changed 包含新增和内容变化的文件，removed 为已删除的文件
+    void filesChanged(int watchId, const QVector<PathId>& changed, const QVector<PathId>& removed);
+
+private slots:
+    void onDirectoryChanged(const QString& dir);
+    void onFileChanged(const QString& filePath);
+    void processPending();
+    void sweep();
+    void sweepStep();
+
+private:
+    struct FileState
+    {
+        qint64 size = 0;
+        qint64 mtime = 0;
+        bool operator==(const FileState& other) const { return size == other.size && mtime == other.mtime; }
+    };
+
+    // 重新列出一个目录，和记录的状态比较；新出现的子目录加入监视并一起列出
+    void rescanDirectory(const QString& dir, QSet<PathId>& changed, QSet<PathId>& removed);
+    // 目录还在时重新列出，否则按删除处理
+    void checkDirectory(const QString& dir, QSet<PathId>& changed, QSet<PathId>& removed);
+    // 目录已被删除：其中和其下所有子目录中的文件都算删除
+    void removeDirectory(const QString& dir, QSet<PathId>& removed);
+    void watchDirectory(const QString& dir);
+    // 逐个监视文件；超出上限或监视失败时它所在的目录改由定时检查
+    void watchFile(PathId id, const QString& filePath, const QString& dir);
+    void unwatchFile(PathId id);
+    void emitChanges(const QSet<PathId>& changed, const QSet<PathId>& removed);
+    bool isAnnotation(const QString& fileName) const;
+
+    QSharedPointer<PathTable> paths_;
+    QFileSystemWatcher *watcher_ = nullptr;
+    QTimer *debounceTimer_ = nullptr;
+    QTimer *sweepTimer_ = nullptr;
+    QTimer *sweepStepTimer_ = nullptr;
+
+    QString root_;
+    QStringList nameFilters_;
+    QStringList excludedNames_;
+    int watchId_ = 0;
+    bool watchFiles_ = false;
+
+    QSet<QString> pendingDirs_;
+    QHash<PathId, FileState> states_;
+    QHash<QString, QSet<PathId>> filesByDirectory_; // 目录路径（与监视的路径写法一致）-> 其中的文件
+    QSet<QString> watchedDirs_;
+    QSet<QString> unwatchedDirs_;  // 目录本身或其中的文件无法监视，只能定时检查
+    QSet<PathId> watchedFiles_;
+    QStringList sweepQueue_;       // 本轮定时检查还没列的目录
+};
+
+#endif // DATASETWATCHER_H
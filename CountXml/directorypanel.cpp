@@ -0,0 +1,116 @@
+#include "directorypanel.h"
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QVBoxLayout>
+
+DirectoryPanel::DirectoryPanel(QWidget *parent)
+    : QWidget(parent)
+{
+    QHBoxLayout* layout = new QHBoxLayout(this);
+
+    directoryTree = new QTreeWidget(this);
+    directoryTree->setSelectionMode(QAbstractItemView::SingleSelection);
+    directoryTree->setUniformRowHeights(true);
+    directoryTree->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    layout->addWidget(directoryTree, 3);
+
+    QVBoxLayout* labelLayout = new QVBoxLayout();
+    labelSelected = new QLabel(this);
+    labelSelected->setWordWrap(true);
+    labelCountModel = new LabelCountModel(this);
+    labelTableView = new QTableView(this);
+    labelTableView->setModel(labelCountModel);
+    labelTableView->setSortingEnabled(true);
+    labelTableView->sortByColumn(LabelCountModel::NameColumn, Qt::AscendingOrder);
+    labelTableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    labelTableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    labelLayout->addWidget(labelSelected);
+    labelLayout->addWidget(labelTableView);
+    layout->addLayout(labelLayout, 1);
+
+    connect(directoryTree, &QTreeWidget::itemSelectionChanged, this, &DirectoryPanel::showSelectedDirectory);
+    clear();
+}
+
+void DirectoryPanel::setStats(const DirectoryStats& stats, const HistogramSpec& spec, const QVector<int>& objectsPerFile)
+{
+    stats_ = stats;
+    stats_.rebin(spec, objectsPerFile);
+
+    const QSignalBlocker blocker(directoryTree);
+    directoryTree->clear();
+    items_.clear();
+    items_.reserve(stats_.nodes.size());
+    for (const DirectoryStats::Node& node : std::as_const(stats_.nodes)) {
+        // 父节点总是排在子节点之前，这里父节点的 item 一定已经建好
+        QTreeWidgetItem* item = node.parent >= 0 ? new QTreeWidgetItem(items_[node.parent])
+                                                 : new QTreeWidgetItem(directoryTree);
+        item->setText(NameColumn, node.name);
+        item->setData(NameColumn, Qt::UserRole, int(items_.size())); // 节点序号
+        item->setText(FilesColumn, QString::number(node.files));
+        item->setText(ValidFilesColumn, QString::number(node.validFiles));
+        item->setText(BoxesColumn, QString::number(node.boxes));
+        for (int column = FilesColumn; column <= BoxesColumn; ++column) {
+            item->setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+        }
+        items_.append(item);
+    }
+    updateDistributionColumns(spec);
+
+    if (!items_.isEmpty()) {
+        directoryTree->expandToDepth(0); // 默认展开第一层子目录
+        directoryTree->setCurrentItem(items_[0]);
+    }
+    showSelectedDirectory();
+}
+
+void DirectoryPanel::setHistogramSpec(const HistogramSpec& spec, const QVector<int>& objectsPerFile)
+{
+    if (stats_.isEmpty()) {
+        return;
+    }
+    stats_.rebin(spec, objectsPerFile);
+    updateDistributionColumns(spec);
+}
+
+void DirectoryPanel::updateDistributionColumns(const HistogramSpec& spec)
+{
+    QStringList headers;
+    headers << "目录" << "图片数" << "有效图片" << "框数";
+    for (int i = 0; i < spec.binCount(); ++i) {
+        headers << spec.label(i);
+    }
+    directoryTree->setColumnCount(headers.size());
+    directoryTree->setHeaderLabels(headers);
+
+    for (int n = 0; n < items_.size(); ++n) {
+        const QVector<int>& distribution = stats_.nodes[n].distribution;
+        for (int i = 0; i < distribution.size(); ++i) {
+            items_[n]->setText(FirstBinColumn + i, QString::number(distribution[i]));
+            items_[n]->setTextAlignment(FirstBinColumn + i, Qt::AlignRight | Qt::AlignVCenter);
+        }
+    }
+}
+
+void DirectoryPanel::clear()
+{
+    setStats(DirectoryStats(), HistogramSpec::defaultSpec(), QVector<int>());
+}
+
+void DirectoryPanel::showSelectedDirectory()
+{
+    const QTreeWidgetItem* current = directoryTree->currentItem();
+    const int node = current ? current->data(NameColumn, Qt::UserRole).toInt() : -1;
+    if (node < 0 || node >= stats_.nodes.size()) {
+        labelCountModel->setCounts(QMap<QString, int>());
+        labelSelected->setText(stats_.isEmpty() ? QString("统计完成后可以按目录查看") : QString("选择一个目录"));
+        return;
+    }
+    const DirectoryStats::Node& selected = stats_.nodes[node];
+    labelCountModel->setCounts(selected.labelCounts);
+    labelSelected->setText(QString("%1：%2 张图片，%3 个标签，%4 个框")
+                               .arg(selected.name)
+                               .arg(selected.files)
+                               .arg(selected.labelCounts.size())
+                               .arg(selected.boxes));
+}
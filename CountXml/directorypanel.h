@@ -0,0 +1,50 @@
+#ifndef DIRECTORYPANEL_H
+#define DIRECTORYPANEL_H
+
+#include <QWidget>
+#include <QLabel>
+#include <QTableView>
+#include <QTreeWidget>
+#include "directorystats.h"
+#include "labelcountmodel.h"
+
+// "按目录" 结果面板：子目录树，每行为该目录（含子目录）的图片数、框数和标签个数分布，
+// 选中一个目录后在右侧列出它的标签个数
+class DirectoryPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        NameColumn,
+        FilesColumn,
+        ValidFilesColumn,
+        BoxesColumn,
+        FirstBinColumn // 之后每个分布区间一列
+    };
+
+    explicit DirectoryPanel(QWidget *parent = nullptr);
+
+    // 使用新的统计结果，分布按 spec 重新分箱
+    void setStats(const DirectoryStats& stats, const HistogramSpec& spec, const QVector<int>& objectsPerFile);
+    // 区间变化：只刷新分布列，目录树的展开状态不变
+    void setHistogramSpec(const HistogramSpec& spec, const QVector<int>& objectsPerFile);
+    void clear();
+
+private slots:
+    void showSelectedDirectory();
+
+private:
+    void updateDistributionColumns(const HistogramSpec& spec);
+
+    DirectoryStats stats_;
+    QVector<QTreeWidgetItem*> items_; // 与 stats_.nodes 一一对应
+
+    QTreeWidget *directoryTree = nullptr;
+    QLabel *labelSelected = nullptr;
+    QTableView *labelTableView = nullptr;
+    LabelCountModel *labelCountModel = nullptr;
+};
+
+#endif // DIRECTORYPANEL_H
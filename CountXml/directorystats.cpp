@@ -0,0 +1,234 @@
+#include "directorystats.h"
+#include "annotationstore.h"
+#include <QHash>
+#include <QVarLengthArray>
+#include <algorithm>
+
+namespace {
+
+// 按路径表的目录建的完整树，汇总后再裁剪出公共目录以下的部分
+struct TreeNode
+{
+    int directory = PathTable::kRootDirectory;
+    int parent = -1;
+    QVector<int> children;
+    int files = 0;
+    int validFiles = 0;
+    qint64 boxes = 0;
+    QHash<int, qint64> labelBoxes; // store 的标签序号 -> 框数，目录下通常只有少数标签
+};
+
+} // namespace
+
+DirectoryStats DirectoryStats::compute(const AnnotationStore& store, const PathTable& paths,
+                                       const QVector<PathId>& images, const HistogramSpec& spec)
+{
+    DirectoryStats result;
+    const int fileCount = qMin(store.fileCount(), int(images.size()));
+    if (fileCount == 0) {
+        return result;
+    }
+
+    // 父节点总是先于子节点建立，所以倒序遍历即可自底向上汇总
+    QVector<TreeNode> tree(1);
+    QHash<int, int> nodeOfDirectory;
+    nodeOfDirectory.insert(PathTable::kRootDirectory, 0);
+    auto nodeFor = [&](int directory) {
+        QVarLengthArray<int, 32> missing;
+        int parentNode = 0;
+        for (int d = directory;; d = paths.parentDirectory(d)) {
+            auto it = nodeOfDirectory.constFind(d);
+            if (it != nodeOfDirectory.constEnd()) {
+                parentNode = it.value();
+                break;
+            }
+            missing.append(d);
+        }
+        for (qsizetype i = missing.size() - 1; i >= 0; --i) {
+            const int node = int(tree.size());
+            tree.append(TreeNode());
+            tree[node].directory = missing[i];
+            tree[node].parent = parentNode;
+            tree[parentNode].children.append(node);
+            nodeOfDirectory.insert(missing[i], node);
+            parentNode = node;
+        }
+        return parentNode;
+    };
+
+    const QVector<int>& objects = store.fileBoxCounts();
+    const QVector<int>& labelIds = store.labelIds();
+    QVector<int> leafOfFile(fileCount);
+    int lastDirectory = -1;
+    int lastNode = 0;
+    for (int f = 0; f < fileCount; ++f) {
+        const int directory = paths.directory(images[f]);
+        if (directory != lastDirectory) { // 同一目录的图片通常是连续的
+            lastDirectory = directory;
+            lastNode = nodeFor(directory);
+        }
+        leafOfFile[f] = lastNode;
+        TreeNode& node = tree[lastNode];
+        ++node.files;
+        if (objects[f] > 0) {
+            ++node.validFiles;
+        }
+        node.boxes += objects[f];
+        const qsizetype begin = store.fileBegin(f);
+        for (qsizetype b = begin; b < begin + objects[f]; ++b) {
+            ++node.labelBoxes[labelIds[b]];
+        }
+    }
+
+    for (qsizetype i = tree.size() - 1; i > 0; --i) {
+        TreeNode& parent = tree[tree[i].parent];
+        parent.files += tree[i].files;
+        parent.validFiles += tree[i].validFiles;
+        parent.boxes += tree[i].boxes;
+        for (auto it = tree[i].labelBoxes.constBegin(); it != tree[i].labelBoxes.constEnd(); ++it) {
+            parent.labelBoxes[it.key()] += it.value();
+        }
+    }
+
+    // 公共目录：向下走到第一个有分叉或者自己有图片的目录
+    int root = 0;
+    while (tree[root].children.size() == 1 && tree[tree[root].children[0]].files == tree[root].files) {
+        root = tree[root].children[0];
+    }
+
+    // 前序遍历输出，子目录按名字排序
+    QVector<int> outputIndex(tree.size(), -1);
+    QVector<int> stack{root};
+    while (!stack.isEmpty()) {
+        const int t = stack.takeLast();
+        const TreeNode& from = tree[t];
+        Node node;
+        if (t == root) {
+            node.name = paths.directoryPath(from.directory);
+            if (node.name.size() > 1 && node.name.endsWith('/')) {
+                node.name.chop(1);
+            }
+            if (node.name.isEmpty()) {
+                node.name = "."; // 相对路径（如 COCO 的 file_name）没有公共目录
+            }
+        } else {
+            node.parent = outputIndex[from.parent];
+            node.name = paths.directoryName(from.directory);
+        }
+        node.files = from.files;
+        node.validFiles = from.validFiles;
+        node.boxes = from.boxes;
+        for (auto it = from.labelBoxes.constBegin(); it != from.labelBoxes.constEnd(); ++it) {
+            node.labelCounts.insert(store.labelName(it.key()), int(it.value()));
+        }
+        outputIndex[t] = int(result.nodes.size());
+        result.nodeOfDirectory.insert(from.directory, outputIndex[t]);
+        if (node.parent >= 0) {
+            result.nodes[node.parent].children.append(outputIndex[t]);
+        }
+        result.nodes.append(std::move(node));
+
+        QVector<int> children = from.children;
+        std::sort(children.begin(), children.end(), [&](int a, int b) {
+            return paths.directoryName(tree[a].directory) > paths.directoryName(tree[b].directory);
+        });
+        stack += children; // 倒序压栈，名字小的先出栈
+    }
+
+    result.nodeOfFile.resize(fileCount);
+    for (int f = 0; f < fileCount; ++f) {
+        result.nodeOfFile[f] = outputIndex[leafOfFile[f]];
+    }
+    result.rebin(spec, objects);
+    return result;
+}
+
+void DirectoryStats::rebin(const HistogramSpec& spec, const QVector<int>& objectsPerFile)
+{
+    for (Node& node : nodes) {
+        node.distribution = QVector<int>(spec.binCount(), 0);
+    }
+    const qsizetype fileCount = qMin(nodeOfFile.size(), objectsPerFile.size());
+    for (qsizetype f = 0; f < fileCount; ++f) {
+        if (objectsPerFile[f] > 0) {
+            ++nodes[nodeOfFile[f]].distribution[spec.binOf(objectsPerFile[f])];
+        }
+    }
+    for (qsizetype i = nodes.size() - 1; i > 0; --i) {
+        QVector<int>& parent = nodes[nodes[i].parent].distribution;
+        for (int b = 0; b < parent.size(); ++b) {
+            parent[b] += nodes[i].distribution[b];
+        }
+    }
+}
+
+void DirectoryStats::adjustFile(const AnnotationStore& store, int file, const HistogramSpec& spec, int sign,
+                                bool countFile)
+{
+    // 先按标签汇总这个文件的框，每一级节点只改一次
+    QMap<QString, int> labels;
+    const qsizetype begin = store.fileBegin(file);
+    const int objects = store.fileBoxCount(file);
+    for (qsizetype b = begin; b < begin + objects; ++b) {
+        ++labels[store.labelName(store.labelIds()[b])];
+    }
+    const int bin = objects > 0 ? spec.binOf(objects) : -1;
+    for (int n = nodeOfFile[file]; n >= 0; n = nodes[n].parent) {
+        Node& node = nodes[n];
+        if (countFile) {
+            node.files += sign;
+        }
+        if (bin >= 0) {
+            node.validFiles += sign;
+            node.distribution[bin] += sign;
+        }
+        node.boxes += sign * objects;
+        for (auto it = labels.constBegin(); it != labels.constEnd(); ++it) {
+            int& count = node.labelCounts[it.key()];
+            count += sign * it.value();
+            if (count <= 0) {
+                node.labelCounts.remove(it.key());
+            }
+        }
+    }
+}
+
+bool DirectoryStats::appendFile(PathId image, const PathTable& paths, const HistogramSpec& spec)
+{
+    QVarLengthArray<int, 32> missing;
+    int parentNode = -1;
+    for (int d = paths.directory(image); d >= 0; d = paths.parentDirectory(d)) {
+        auto it = nodeOfDirectory.constFind(d);
+        if (it != nodeOfDirectory.constEnd()) {
+            parentNode = it.value();
+            break;
+        }
+        missing.append(d);
+    }
+    if (parentNode < 0) {
+        return false;
+    }
+    // 新节点追加在末尾，仍然满足父节点排在子节点之前
+    for (qsizetype i = missing.size() - 1; i >= 0; --i) {
+        const int node = int(nodes.size());
+        Node child;
+        child.parent = parentNode;
+        child.name = paths.directoryName(missing[i]);
+        child.distribution = QVector<int>(spec.binCount(), 0);
+        QVector<int>& siblings = nodes[parentNode].children;
+        const auto pos = std::lower_bound(siblings.begin(), siblings.end(), child.name,
+                                          [this](int c, const QString& name) { return nodes[c].name < name; });
+        siblings.insert(pos - siblings.begin(), node);
+        nodes.append(std::move(child));
+        nodeOfDirectory.insert(missing[i], node);
+        parentNode = node;
+    }
+    nodeOfFile.append(parentNode);
+    return true;
+}
+
+void DirectoryStats::removeFileSwapLast(int file)
+{
+    nodeOfFile[file] = nodeOfFile.last();
+    nodeOfFile.removeLast();
+}
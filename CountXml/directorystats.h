@@ -0,0 +1,52 @@
+#ifndef DIRECTORYSTATS_H
+#define DIRECTORYSTATS_H
+
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include "histogram.h"
+#include "pathtable.h"
+
+class AnnotationStore;
+
+// 按子目录汇总的统计，每个节点包含它下面所有子目录中的图片
+// 根节点是全部图片的公共目录：只有一个子目录、自己又没有图片的上层目录都合并到根节点中
+// 在统计结束时由同一次解析得到的 store 计算，不需要按目录重新统计；文件变化时按单个文件增减
+struct DirectoryStats
+{
+    struct Node
+    {
+        int parent = -1;           // 上一级节点，根节点为 -1
+        QString name;              // 目录名，根节点为完整路径
+        QVector<int> children;     // 按目录名排序
+        int files = 0;
+        int validFiles = 0;        // 至少包含一个 object 的图片数
+        qint64 boxes = 0;
+        QVector<int> distribution; // 每张图片的标签个数分布
+        QMap<QString, int> labelCounts;
+    };
+
+    QVector<Node> nodes;     // nodes[0] 为根节点，父节点总是排在子节点之前
+    QVector<int> nodeOfFile; // 每张图片直接所在的节点，换区间时据此重新分箱
+    QHash<int, int> nodeOfDirectory; // 路径表的目录序号 -> 节点，为新图片定位节点
+
+    bool isEmpty() const { return nodes.isEmpty(); }
+
+    // images 为 store 中每个文件对应的路径序号（DatasetStats::images）
+    static DirectoryStats compute(const AnnotationStore& store, const PathTable& paths,
+                                  const QVector<PathId>& images, const HistogramSpec& spec);
+    // 按新的区间重新计算每个节点的分布，objectsPerFile 与 nodeOfFile 一一对应
+    void rebin(const HistogramSpec& spec, const QVector<int>& objectsPerFile);
+
+    // 增量更新，文件序号与 store 一致：sign 为 -1 时从所在节点及各级父节点减去第 file 个文件的框，
+    // 为 1 时加上；countFile 表示图片数也随之增减（删除或新增文件）
+    void adjustFile(const AnnotationStore& store, int file, const HistogramSpec& spec, int sign, bool countFile);
+    // 为追加到末尾的新图片定位节点，缺少的子目录按名字顺序插入；
+    // 图片不在根节点之下时返回 false，这时只能重新 compute
+    bool appendFile(PathId image, const PathTable& paths, const HistogramSpec& spec);
+    // 与 AnnotationStore::removeFileSwapLast 对应，最后一张图片移到 file 的位置
+    void removeFileSwapLast(int file);
+};
+
+#endif // DIRECTORYSTATS_H
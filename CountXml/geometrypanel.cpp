@@ -0,0 +1,132 @@
+#include "geometrypanel.h"
+#include <QGroupBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QVBoxLayout>
+#include <algorithm>
+
+namespace {
+
+QString percentText(qint64 count, qint64 total)
+{
+    return total > 0 ? QString::number(count * 100.0 / total, 'f', 1) + "%" : QString("-");
+}
+
+QTableWidget* makeHistogramTable(int rows, QWidget* parent)
+{
+    QTableWidget* table = new QTableWidget(rows, 2, parent);
+    table->setHorizontalHeaderLabels(QStringList() << "框数" << "占比");
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    return table;
+}
+
+} // namespace
+
+GeometryPanel::GeometryPanel(QWidget *parent)
+    : QWidget(parent)
+{
+    QVBoxLayout* layout = new QVBoxLayout(this);
+
+    QHBoxLayout* topLayout = new QHBoxLayout();
+    comboLabel = new QComboBox(this);
+    comboLabel->setMinimumWidth(200);
+    labelSummary = new QLabel(this);
+    topLayout->addWidget(new QLabel("标签 : ", this));
+    topLayout->addWidget(comboLabel);
+    topLayout->addWidget(labelSummary);
+    topLayout->addStretch();
+    layout->addLayout(topLayout);
+
+    areaTable = makeHistogramTable(GeometryStats::kAreaBins, this);
+    QStringList areaLabels;
+    for (int i = 0; i < GeometryStats::kAreaBins; ++i) {
+        areaLabels << GeometryStats::areaBinLabel(i);
+    }
+    areaTable->setVerticalHeaderLabels(areaLabels);
+
+    aspectTable = makeHistogramTable(GeometryStats::kAspectBins, this);
+    QStringList aspectLabels;
+    for (int i = 0; i < GeometryStats::kAspectBins; ++i) {
+        aspectLabels << GeometryStats::aspectBinLabel(i);
+    }
+    aspectTable->setVerticalHeaderLabels(aspectLabels);
+
+    positionTable = new QTableWidget(3, 3, this);
+    positionTable->setHorizontalHeaderLabels(QStringList() << "左" << "中" << "右");
+    positionTable->setVerticalHeaderLabels(QStringList() << "上" << "中" << "下");
+    positionTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    positionTable->verticalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    positionTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    QHBoxLayout* tablesLayout = new QHBoxLayout();
+    const QList<QPair<QString, QTableWidget*>> groups = {
+        {"面积 (像素²)", areaTable}, {"宽高比 (宽:高)", aspectTable}, {"框中心位置", positionTable}};
+    for (const auto& group : groups) {
+        QGroupBox* box = new QGroupBox(group.first, this);
+        QVBoxLayout* boxLayout = new QVBoxLayout(box);
+        boxLayout->addWidget(group.second);
+        tablesLayout->addWidget(box);
+    }
+    layout->addLayout(tablesLayout);
+
+    connect(comboLabel, &QComboBox::currentIndexChanged, this, &GeometryPanel::showSelectedLabel);
+    clear();
+}
+
+void GeometryPanel::setStats(const GeometryStats& stats)
+{
+    stats_ = stats;
+
+    // 下拉框第一项为全部标签，其余按名称排序，itemData 为 perLabel 下标
+    QList<QPair<QString, int>> labels;
+    for (int i = 0; i < stats_.labels.size(); ++i) {
+        labels.append({stats_.labels[i], i});
+    }
+    std::sort(labels.begin(), labels.end());
+
+    const QSignalBlocker blocker(comboLabel);
+    comboLabel->clear();
+    comboLabel->addItem("全部标签", -1);
+    for (const auto& label : std::as_const(labels)) {
+        comboLabel->addItem(label.first, label.second);
+    }
+    showSelectedLabel();
+}
+
+void GeometryPanel::clear()
+{
+    setStats(GeometryStats());
+}
+
+void GeometryPanel::showSelectedLabel()
+{
+    const int index = comboLabel->currentData().toInt();
+    const GeometryStats::Histograms& h =
+        index >= 0 && index < stats_.perLabel.size() ? stats_.perLabel[index] : stats_.total;
+
+    labelSummary->setText(QString("框数 : %1    图片宽高未知 : %2").arg(h.boxes).arg(h.positionUnknown));
+    fillHistogramTable(areaTable, h.area.data(), GeometryStats::kAreaBins, h.boxes);
+    fillHistogramTable(aspectTable, h.aspect.data(), GeometryStats::kAspectBins, h.boxes);
+
+    // 位置占比只在宽高已知的框中计算
+    const qint64 positioned = h.boxes - h.positionUnknown;
+    for (int i = 0; i < GeometryStats::kPositionBins; ++i) {
+        QTableWidgetItem* item = new QTableWidgetItem(
+            QString("%1\n%2").arg(h.position[i]).arg(percentText(h.position[i], positioned)));
+        item->setTextAlignment(Qt::AlignCenter);
+        positionTable->setItem(i / 3, i % 3, item);
+    }
+}
+
+void GeometryPanel::fillHistogramTable(QTableWidget* table, const qint64* counts, int binCount, qint64 total)
+{
+    for (int i = 0; i < binCount; ++i) {
+        QTableWidgetItem* countItem = new QTableWidgetItem(QString::number(counts[i]));
+        QTableWidgetItem* percentItem = new QTableWidgetItem(percentText(counts[i], total));
+        countItem->setTextAlignment(Qt::AlignCenter);
+        percentItem->setTextAlignment(Qt::AlignCenter);
+        table->setItem(i, 0, countItem);
+        table->setItem(i, 1, percentItem);
+    }
+}
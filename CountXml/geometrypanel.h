@@ -0,0 +1,37 @@
+#ifndef GEOMETRYPANEL_H
+#define GEOMETRYPANEL_H
+
+#include <QWidget>
+#include <QComboBox>
+#include <QLabel>
+#include <QTableWidget>
+#include "geometrystats.h"
+
+// "框几何分布" 结果面板：按标签查看面积、宽高比和框中心位置的分布
+class GeometryPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit GeometryPanel(QWidget *parent = nullptr);
+
+    void setStats(const GeometryStats& stats);
+    void clear();
+
+private slots:
+    void showSelectedLabel();
+
+private:
+    // 按 (个数, 占比) 两列填充一个分布表
+    void fillHistogramTable(QTableWidget* table, const qint64* counts, int binCount, qint64 total);
+
+    GeometryStats stats_;
+
+    QComboBox *comboLabel = nullptr;
+    QLabel *labelSummary = nullptr;
+    QTableWidget *areaTable = nullptr;
+    QTableWidget *aspectTable = nullptr;
+    QTableWidget *positionTable = nullptr; // 3x3，对应图片的九宫格
+};
+
+#endif // GEOMETRYPANEL_H
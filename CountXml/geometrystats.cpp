@@ -0,0 +1,170 @@
+#include "geometrystats.h"
+#include "annotationstore.h"
+#include <algorithm>
+
+namespace {
+
+// COCO 的面积划分：small < 32*32 <= medium < 96*96 <= large
+constexpr qint64 kSmallArea = 32 * 32;
+constexpr qint64 kMediumArea = 96 * 96;
+
+// 每次处理的框数，临时数组留在 L1/L2 缓存中
+constexpr qsizetype kBlockSize = 4096;
+
+// 扁平计数数组中每个标签占用的位置：面积 | 宽高比 | 位置 | 位置未知
+constexpr int kAspectOffset = GeometryStats::kAreaBins;
+constexpr int kPositionOffset = kAspectOffset + GeometryStats::kAspectBins;
+constexpr int kStride = kPositionOffset + GeometryStats::kPositionBins + 1;
+
+} // namespace
+
+void GeometryStats::Histograms::add(const Histograms& other, int sign)
+{
+    for (int i = 0; i < kAreaBins; ++i) area[i] += sign * other.area[i];
+    for (int i = 0; i < kAspectBins; ++i) aspect[i] += sign * other.aspect[i];
+    for (int i = 0; i < kPositionBins; ++i) position[i] += sign * other.position[i];
+    positionUnknown += sign * other.positionUnknown;
+    boxes += sign * other.boxes;
+}
+
+void GeometryStats::merge(const GeometryStats& other, int sign)
+{
+    for (int i = 0; i < other.labels.size(); ++i) {
+        qsizetype k = labels.indexOf(other.labels[i]);
+        if (k < 0) {
+            k = labels.size();
+            labels.append(other.labels[i]);
+            perLabel.append(Histograms());
+        }
+        perLabel[k].add(other.perLabel[i], sign);
+    }
+    total.add(other.total, sign);
+    for (qsizetype k = labels.size() - 1; k >= 0; --k) {
+        if (perLabel[k].boxes <= 0) { // 与 compute 一致，不保留框数为 0 的标签
+            labels.removeAt(k);
+            perLabel.removeAt(k);
+        }
+    }
+}
+
+GeometryStats GeometryStats::compute(const AnnotationStore& store)
+{
+    if (!store.isCompact()) { // 下面按框数组整段遍历，要求框按文件顺序连续
+        AnnotationStore compacted = store;
+        compacted.compact();
+        return compute(compacted);
+    }
+    GeometryStats stats;
+    const qsizetype boxCount = store.boxCount();
+    const int fileCount = store.fileCount();
+    QVector<qint64> counts(qsizetype(store.labelCount()) * kStride, 0);
+
+    const int* labelIds = store.labelIds().constData();
+    const int* xmin = store.xmin().constData();
+    const int* ymin = store.ymin().constData();
+    const int* xmax = store.xmax().constData();
+    const int* ymax = store.ymax().constData();
+
+    std::array<int, kBlockSize> imageWidth;
+    std::array<int, kBlockSize> imageHeight;
+    std::array<quint8, kBlockSize> areaBin;
+    std::array<quint8, kBlockSize> aspectBin;
+    std::array<quint8, kBlockSize> positionBin;
+
+    int file = 0;
+    for (qsizetype blockBegin = 0; blockBegin < boxCount; blockBegin += kBlockSize) {
+        const qsizetype len = qMin(kBlockSize, boxCount - blockBegin);
+
+        // 1. 展开每个框所属图片的宽高，框按文件顺序连续存放
+        for (qsizetype i = 0; i < len;) {
+            while (file < fileCount && store.fileBegin(file) + store.fileBoxCount(file) <= blockBegin + i) {
+                ++file;
+            }
+            if (file >= fileCount) {
+                std::fill(imageWidth.begin() + i, imageWidth.begin() + len, 0);
+                std::fill(imageHeight.begin() + i, imageHeight.begin() + len, 0);
+                break;
+            }
+            const qsizetype end = qMin(len, store.fileBegin(file) + store.fileBoxCount(file) - blockBegin);
+            std::fill(imageWidth.begin() + i, imageWidth.begin() + end, store.imageWidth(file));
+            std::fill(imageHeight.begin() + i, imageHeight.begin() + end, store.imageHeight(file));
+            i = end;
+        }
+
+        // 2. 计算区间序号，只用比较结果相加，没有分支
+        const int* x0 = xmin + blockBegin;
+        const int* y0 = ymin + blockBegin;
+        const int* x1 = xmax + blockBegin;
+        const int* y1 = ymax + blockBegin;
+        for (qsizetype k = 0; k < len; ++k) {
+            const qint64 w = qint64(x1[k]) - x0[k] + 1;
+            const qint64 h = qint64(y1[k]) - y0[k] + 1;
+            const qint64 area = w * h;
+            areaBin[k] = quint8((area >= kSmallArea) + (area >= kMediumArea));
+            // 宽高比 w:h 的分界为 1:4, 1:2, 4:5, 5:4, 2:1, 4:1
+            aspectBin[k] = quint8((4 * w >= h) + (2 * w >= h) + (5 * w >= 4 * h)
+                                  + (4 * w >= 5 * h) + (w >= 2 * h) + (w >= 4 * h));
+            // 框中心的两倍，框覆盖 [xmin, xmax + 1)，与图片宽高的 1/3、2/3 比较
+            const qint64 cx2 = qint64(x0[k]) + x1[k] + 1;
+            const qint64 cy2 = qint64(y0[k]) + y1[k] + 1;
+            const qint64 imageW = imageWidth[k];
+            const qint64 imageH = imageHeight[k];
+            const int col = (3 * cx2 >= 2 * imageW) + (3 * cx2 >= 4 * imageW);
+            const int row = (3 * cy2 >= 2 * imageH) + (3 * cy2 >= 4 * imageH);
+            const bool known = (imageW > 0) & (imageH > 0);
+            positionBin[k] = quint8(known ? row * 3 + col : kPositionBins);
+        }
+
+        // 3. 按标签累加
+        const int* ids = labelIds + blockBegin;
+        for (qsizetype k = 0; k < len; ++k) {
+            qint64* c = counts.data() + qsizetype(ids[k]) * kStride;
+            ++c[areaBin[k]];
+            ++c[kAspectOffset + aspectBin[k]];
+            ++c[kPositionOffset + positionBin[k]];
+        }
+    }
+
+    for (int labelId = 0; labelId < store.labelCount(); ++labelId) {
+        const qint64* c = counts.constData() + qsizetype(labelId) * kStride;
+        Histograms h;
+        for (int i = 0; i < kAreaBins; ++i) {
+            h.area[i] = c[i];
+            h.boxes += c[i];
+        }
+        if (h.boxes == 0) {
+            continue; // 解析失败回滚的文件可能留下框数为 0 的标签
+        }
+        for (int i = 0; i < kAspectBins; ++i) h.aspect[i] = c[kAspectOffset + i];
+        for (int i = 0; i < kPositionBins; ++i) h.position[i] = c[kPositionOffset + i];
+        h.positionUnknown = c[kPositionOffset + kPositionBins];
+
+        stats.labels.append(store.labelName(labelId));
+        stats.perLabel.append(h);
+        stats.total.add(h);
+    }
+    return stats;
+}
+
+QString GeometryStats::areaBinLabel(int index)
+{
+    static const char* const labels[kAreaBins] = {"小 (<32²)", "中 (32²-96²)", "大 (≥96²)"};
+    return index >= 0 && index < kAreaBins ? QString::fromUtf8(labels[index]) : QString();
+}
+
+QString GeometryStats::aspectBinLabel(int index)
+{
+    static const char* const labels[kAspectBins] = {
+        "<1:4", "1:4-1:2", "1:2-4:5", "4:5-5:4", "5:4-2:1", "2:1-4:1", "≥4:1"};
+    return index >= 0 && index < kAspectBins ? QString::fromUtf8(labels[index]) : QString();
+}
+
+QString GeometryStats::positionBinLabel(int index)
+{
+    static const char* const rows[3] = {"上", "中", "下"};
+    static const char* const cols[3] = {"左", "中", "右"};
+    if (index < 0 || index >= kPositionBins) {
+        return QString();
+    }
+    return QString::fromUtf8(rows[index / 3]) + QString::fromUtf8(cols[index % 3]);
+}
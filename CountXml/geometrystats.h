@@ -0,0 +1,46 @@
+#ifndef GEOMETRYSTATS_H
+#define GEOMETRYSTATS_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <array>
+
+class AnnotationStore;
+
+// 每个标签的框几何分布：面积（COCO 的 small/medium/large）、宽高比、框中心在图片中的 3x3 位置
+// 在 AnnotationStore 的连续坐标数组上按块计算，循环体没有分支，编译器可以向量化
+struct GeometryStats
+{
+    static constexpr int kAreaBins = 3;
+    static constexpr int kAspectBins = 7;
+    static constexpr int kPositionBins = 9; // 行优先：0 为左上，8 为右下
+
+    struct Histograms
+    {
+        std::array<qint64, kAreaBins> area{};
+        std::array<qint64, kAspectBins> aspect{};
+        std::array<qint64, kPositionBins> position{};
+        qint64 positionUnknown = 0; // 图片宽高未知的框，不计入位置分布
+        qint64 boxes = 0;
+
+        void add(const Histograms& other, int sign = 1);
+    };
+
+    QStringList labels;          // 与 perLabel 一一对应
+    QVector<Histograms> perLabel;
+    Histograms total;
+
+    bool isEmpty() const { return total.boxes == 0; }
+
+    static GeometryStats compute(const AnnotationStore& store);
+    // 加上（sign 为 1）或减去（sign 为 -1）另一份统计，标签按名字对应；增量更新时只计算变化的文件
+    void merge(const GeometryStats& other, int sign);
+
+    // 区间的文字说明
+    static QString areaBinLabel(int index);
+    static QString aspectBinLabel(int index);
+    static QString positionBinLabel(int index);
+};
+
+#endif // GEOMETRYSTATS_H
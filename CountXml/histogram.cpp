@@ -0,0 +1,159 @@
+#include "histogram.h"
+#include <QStringList>
+#include <algorithm>
+#include <cmath>
+
+HistogramSpec::HistogramSpec(Mode mode, QVector<int> lowerEdges)
+    : mode_(mode), lowerEdges_(std::move(lowerEdges))
+{
+    // 保证下界从 1 开始并严格递增
+    if (lowerEdges_.isEmpty() || lowerEdges_.first() != 1) {
+        lowerEdges_.prepend(1);
+    }
+    std::sort(lowerEdges_.begin(), lowerEdges_.end());
+    lowerEdges_.erase(std::unique(lowerEdges_.begin(), lowerEdges_.end()), lowerEdges_.end());
+    while (!lowerEdges_.isEmpty() && lowerEdges_.first() < 1) {
+        lowerEdges_.removeFirst();
+    }
+    if (lowerEdges_.isEmpty()) {
+        lowerEdges_.append(1);
+    }
+}
+
+HistogramSpec HistogramSpec::fixedWidth(int width, int binCount)
+{
+    width = qMax(1, width);
+    binCount = qMax(1, binCount);
+    QVector<int> edges;
+    edges.reserve(binCount);
+    for (int i = 0; i < binCount; ++i) {
+        edges.append(i * width + 1);
+    }
+    HistogramSpec spec(Mode::FixedWidth, edges);
+    spec.fixedWidth_ = width;
+    return spec;
+}
+
+HistogramSpec HistogramSpec::logScale(int base, int binCount)
+{
+    base = qMax(2, base);
+    binCount = qMax(1, binCount);
+    QVector<int> edges;
+    edges.reserve(binCount);
+    double edge = 1.0;
+    for (int i = 0; i < binCount; ++i) {
+        const int rounded = int(std::lround(edge));
+        edges.append(edges.isEmpty() ? 1 : qMax(edges.last() + 1, rounded));
+        edge *= base;
+    }
+    return HistogramSpec(Mode::LogScale, edges);
+}
+
+HistogramSpec HistogramSpec::quantile(const QVector<int>& objectsPerFile, int binCount)
+{
+    binCount = qMax(1, binCount);
+
+    // 标签个数的取值范围很小，用计数代替排序
+    int maxCount = 0;
+    for (int objectCount : objectsPerFile) {
+        maxCount = qMax(maxCount, objectCount);
+    }
+    QVector<qint64> frequency(maxCount + 1, 0);
+    qint64 total = 0;
+    for (int objectCount : objectsPerFile) {
+        if (objectCount > 0) {
+            frequency[objectCount] += 1;
+            total += 1;
+        }
+    }
+
+    QVector<int> edges{1};
+    qint64 cumulative = 0;
+    int q = 1;
+    for (int value = 1; value <= maxCount && q < binCount; ++value) {
+        cumulative += frequency[value];
+        // 第 q 个分位点落在 value 上时，下一个区间从 value + 1 开始
+        while (q < binCount && cumulative * binCount >= q * total) {
+            if (value + 1 > edges.last() && value < maxCount) {
+                edges.append(value + 1);
+            }
+            ++q;
+        }
+    }
+    return HistogramSpec(Mode::Quantile, edges);
+}
+
+HistogramSpec HistogramSpec::fromEdges(const QVector<int>& lowerEdges)
+{
+    return HistogramSpec(Mode::Custom, lowerEdges);
+}
+
+HistogramSpec HistogramSpec::fromString(const QString& text, const QVector<int>& objectsPerFile, bool *ok)
+{
+    const QStringList parts = text.trimmed().toLower().split(':');
+    const QString kind = parts.value(0);
+    bool ok1 = false, ok2 = false;
+    *ok = false;
+
+    if (kind == "fixed" && parts.size() == 3) {
+        const int width = parts[1].toInt(&ok1);
+        const int count = parts[2].toInt(&ok2);
+        *ok = ok1 && ok2 && width > 0 && count > 0;
+        return fixedWidth(width, count);
+    }
+    if (kind == "log" && parts.size() == 3) {
+        const int base = parts[1].toInt(&ok1);
+        const int count = parts[2].toInt(&ok2);
+        *ok = ok1 && ok2 && base > 1 && count > 0;
+        return logScale(base, count);
+    }
+    if (kind == "quantile" && parts.size() == 2) {
+        const int count = parts[1].toInt(&ok1);
+        *ok = ok1 && count > 0;
+        return quantile(objectsPerFile, count);
+    }
+    if (kind == "edges" && parts.size() == 2) {
+        QVector<int> edges;
+        *ok = true;
+        for (const QString& value : parts[1].split(',', Qt::SkipEmptyParts)) {
+            edges.append(value.toInt(&ok1));
+            *ok = *ok && ok1 && edges.last() > 0;
+        }
+        *ok = *ok && !edges.isEmpty();
+        return fromEdges(edges);
+    }
+    return defaultSpec();
+}
+
+QString HistogramSpec::label(int index) const
+{
+    const int lower = lowerEdges_.value(index);
+    if (index == lowerEdges_.size() - 1) {
+        return QString("%1+").arg(lower);
+    }
+    const int upper = lowerEdges_[index + 1] - 1;
+    if (upper == lower) {
+        return QString::number(lower);
+    }
+    return QString("%1-%2").arg(lower).arg(upper);
+}
+
+int HistogramSpec::binOf(int objectCount) const
+{
+    if (fixedWidth_ > 0) {
+        return qMin((objectCount - 1) / fixedWidth_, int(lowerEdges_.size()) - 1);
+    }
+    auto it = std::upper_bound(lowerEdges_.constBegin(), lowerEdges_.constEnd(), objectCount);
+    return int(it - lowerEdges_.constBegin()) - 1;
+}
+
+QVector<int> HistogramSpec::apply(const QVector<int>& objectsPerFile) const
+{
+    QVector<int> counts(lowerEdges_.size(), 0);
+    for (int objectCount : objectsPerFile) {
+        if (objectCount > 0) {
+            counts[binOf(objectCount)] += 1;
+        }
+    }
+    return counts;
+}
@@ -0,0 +1,56 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <QString>
+#include <QVector>
+
+// "每张图片的标签个数" 分布的区间定义
+// 区间由升序的下界 lowerEdges 描述：第 i 个区间为 [lowerEdges[i], lowerEdges[i+1] - 1]，
+// 最后一个区间包含所有更大的值；没有 object 的文件不计入任何区间
+class HistogramSpec
+{
+public:
+    enum class Mode
+    {
+        FixedWidth, // 等宽：1-5, 6-10, ...
+        LogScale,   // 对数：1, 2-3, 4-7, ...
+        Quantile,   // 分位数：每个区间的文件数大致相同
+        Custom      // 直接给出下界
+    };
+
+    HistogramSpec() : HistogramSpec(defaultSpec()) {}
+
+    // 原来界面上固定的 6 个区间："1-5" ... "25以上"
+    static HistogramSpec defaultSpec() { return fixedWidth(5, 6); }
+    static HistogramSpec fixedWidth(int width, int binCount);
+    static HistogramSpec logScale(int base, int binCount);
+    // 按已有的每个文件标签个数计算分位数区间，重复的边界会被合并，区间数可能少于 binCount
+    static HistogramSpec quantile(const QVector<int>& objectsPerFile, int binCount);
+    static HistogramSpec fromEdges(const QVector<int>& lowerEdges);
+    // 文字描述，例如 "fixed:5:6"、"log:2:8"、"quantile:10"、"edges:1,6,11,26"
+    // quantile 需要 objectsPerFile；格式错误时 *ok 为 false
+    static HistogramSpec fromString(const QString& text, const QVector<int>& objectsPerFile, bool *ok);
+
+    Mode mode() const { return mode_; }
+    int binCount() const { return lowerEdges_.size(); }
+    const QVector<int>& lowerEdges() const { return lowerEdges_; }
+
+    // 区间的文字说明，例如 "1-5"、"6"、"26+"
+    QString label(int index) const;
+    // objectCount 所在的区间，objectCount 必须大于 0
+    int binOf(int objectCount) const;
+    // 对每个文件的标签个数重新分箱，不需要重新读盘
+    QVector<int> apply(const QVector<int>& objectsPerFile) const;
+
+    bool operator==(const HistogramSpec& other) const { return lowerEdges_ == other.lowerEdges_; }
+    bool operator!=(const HistogramSpec& other) const { return !(*this == other); }
+
+private:
+    HistogramSpec(Mode mode, QVector<int> lowerEdges);
+
+    Mode mode_ = Mode::FixedWidth;
+    QVector<int> lowerEdges_;
+    int fixedWidth_ = 0; // 等宽模式下直接计算区间，不用二分查找
+};
+
+#endif // HISTOGRAM_H
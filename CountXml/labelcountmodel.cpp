@@ -0,0 +1,193 @@
+#include "labelcountmodel.h"
+#include <algorithm>
+#include <functional>
+
+LabelCountModel::LabelCountModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+void LabelCountModel::setCounts(const QMap<QString, int>& counts, const QMap<QString, int>& margins)
+{
+    margins_.clear();
+    if (!margins.isEmpty()) {
+        margins_.reserve(counts.size());
+        for (auto it = counts.constBegin(); it != counts.constEnd(); ++it) {
+            margins_.append(margins.value(it.key()));
+        }
+    }
+
+    bool sameLabels = counts.size() == names_.size();
+    if (sameLabels) {
+        int i = 0;
+        for (auto it = counts.constBegin(); it != counts.constEnd(); ++it, ++i) {
+            if (it.key() != names_[i]) {
+                sameLabels = false;
+                break;
+            }
+        }
+    }
+
+    if (sameLabels) {
+        int i = 0;
+        for (auto it = counts.constBegin(); it != counts.constEnd(); ++it, ++i) {
+            counts_[i] = it.value();
+        }
+        if (sortColumn_ == CountColumn) {
+            resortWithLayoutChange();
+        } else if (!rows_.isEmpty()) {
+            emit dataChanged(index(0, CountColumn), index(rows_.size() - 1, CountColumn), {Qt::DisplayRole});
+        }
+        return;
+    }
+
+    beginResetModel();
+    names_.clear();
+    counts_.clear();
+    names_.reserve(counts.size());
+    counts_.reserve(counts.size());
+    for (auto it = counts.constBegin(); it != counts.constEnd(); ++it) {
+        names_.append(it.key());
+        counts_.append(it.value());
+    }
+    rebuildRows();
+    endResetModel();
+}
+
+void LabelCountModel::setFilter(const QString& text)
+{
+    if (text == filter_) {
+        return;
+    }
+    // 继续输入时新条件比旧条件更严格，只需要在当前可见行中筛选，顺序也不变
+    const bool narrowing = !filter_.isEmpty() && text.contains(filter_, Qt::CaseInsensitive);
+    filter_ = text;
+
+    beginResetModel();
+    if (narrowing) {
+        rows_.erase(std::remove_if(rows_.begin(), rows_.end(),
+                                   [this](int labelIndex) { return !matchesFilter(labelIndex); }),
+                    rows_.end());
+    } else {
+        rebuildRows();
+    }
+    endResetModel();
+}
+
+int LabelCountModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : rows_.size();
+}
+
+int LabelCountModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant LabelCountModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= rows_.size()) {
+        return QVariant();
+    }
+    const int labelIndex = rows_[index.row()];
+    switch (role) {
+    case Qt::DisplayRole:
+        if (index.column() == NameColumn) {
+            return names_[labelIndex];
+        }
+        if (!margins_.isEmpty()) {
+            return QString("≈%1 ± %2").arg(counts_[labelIndex]).arg(margins_[labelIndex]);
+        }
+        return counts_[labelIndex];
+    case Qt::TextAlignmentRole:
+        return int(Qt::AlignCenter);
+    default:
+        return QVariant();
+    }
+}
+
+QVariant LabelCountModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        return section == NameColumn ? QString("标签名称") : QString("个数");
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+void LabelCountModel::sort(int column, Qt::SortOrder order)
+{
+    if (column == sortColumn_ && order == sortOrder_) {
+        return;
+    }
+    sortColumn_ = column;
+    sortOrder_ = order;
+    resortWithLayoutChange();
+}
+
+bool LabelCountModel::matchesFilter(int labelIndex) const
+{
+    return filter_.isEmpty() || names_[labelIndex].contains(filter_, Qt::CaseInsensitive);
+}
+
+void LabelCountModel::rebuildRows()
+{
+    rows_.clear();
+    rows_.reserve(names_.size());
+    for (int i = 0; i < names_.size(); ++i) {
+        if (matchesFilter(i)) {
+            rows_.append(i);
+        }
+    }
+    sortRows();
+}
+
+void LabelCountModel::sortRows()
+{
+    const bool ascending = sortOrder_ == Qt::AscendingOrder;
+    if (sortColumn_ == CountColumn) {
+        // 框数相同的按标签名排列，保证结果稳定
+        std::sort(rows_.begin(), rows_.end(), [this, ascending](int a, int b) {
+            if (counts_[a] != counts_[b]) {
+                return ascending ? counts_[a] < counts_[b] : counts_[a] > counts_[b];
+            }
+            return a < b;
+        });
+    } else {
+        // names_ 本身按名称升序，按下标排即可
+        if (ascending) {
+            std::sort(rows_.begin(), rows_.end());
+        } else {
+            std::sort(rows_.begin(), rows_.end(), std::greater<int>());
+        }
+    }
+}
+
+void LabelCountModel::resortWithLayoutChange()
+{
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+
+    // 视图的选中行等持久索引跟随标签移动
+    const QModelIndexList oldIndexes = persistentIndexList();
+    QVector<int> oldLabels;
+    oldLabels.reserve(oldIndexes.size());
+    for (const QModelIndex& index : oldIndexes) {
+        oldLabels.append(rows_[index.row()]);
+    }
+
+    sortRows();
+
+    if (!oldIndexes.isEmpty()) {
+        QVector<int> rowOfLabel(names_.size(), -1);
+        for (int row = 0; row < rows_.size(); ++row) {
+            rowOfLabel[rows_[row]] = row;
+        }
+        QModelIndexList newIndexes;
+        newIndexes.reserve(oldIndexes.size());
+        for (int i = 0; i < oldIndexes.size(); ++i) {
+            newIndexes.append(index(rowOfLabel[oldLabels[i]], oldIndexes[i].column()));
+        }
+        changePersistentIndexList(oldIndexes, newIndexes);
+    }
+
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
@@ -0,0 +1,61 @@
+#ifndef LABELCOUNTMODEL_H
+#define LABELCOUNTMODEL_H
+
+#include <QAbstractTableModel>
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+// "标签个数" 表格的模型
+// 只保存标签名和框数两列数据，视图按需取可见行，不为每个标签创建 QTableWidgetItem；
+// 排序和过滤只重排行号数组 rows_，不移动数据
+class LabelCountModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        NameColumn,
+        CountColumn,
+        ColumnCount
+    };
+
+    explicit LabelCountModel(QObject *parent = nullptr);
+
+    // 更新全部标签的框数，标签集合不变时（统计后期的进度更新）只刷新数值列
+    // margins 非空时为抽样估计：个数列显示为 "≈个数 ± 半宽"，键与 counts 相同
+    void setCounts(const QMap<QString, int>& counts, const QMap<QString, int>& margins = QMap<QString, int>());
+    // 标签名包含 text（不区分大小写）的行才显示；在上一次过滤的基础上继续输入时只筛选当前可见行
+    void setFilter(const QString& text);
+    QString filter() const { return filter_; }
+
+    int totalLabels() const { return names_.size(); }
+    int visibleLabels() const { return rows_.size(); }
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+private:
+    bool matchesFilter(int labelIndex) const;
+    // 按当前过滤条件从全部标签重新生成 rows_ 并排序（不发信号）
+    void rebuildRows();
+    // 按当前排序列重排 rows_（不发信号）
+    void sortRows();
+    // 重排可见行并通知视图，持久索引跟随标签移动
+    void resortWithLayoutChange();
+
+    QVector<QString> names_; // 按标签名升序，与 QMap 的遍历顺序一致
+    QVector<int> counts_;
+    QVector<int> margins_;   // 为空表示精确值，否则与 counts_ 一一对应
+    QVector<int> rows_;      // 可见行对应的标签下标，按当前排序
+
+    QString filter_;
+    int sortColumn_ = NameColumn;
+    Qt::SortOrder sortOrder_ = Qt::AscendingOrder;
+};
+
+#endif // LABELCOUNTMODEL_H
@@ -4,6 +4,9 @@
 #include <QDirIterator>
 #include <QDebug>        // 用于 qDebug 输出
 #include <QMessageBox>   // 用于用户反馈
+#include <QStatusBar>
+#include <QRandomGenerator>
+#include <algorithm>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -16,18 +19,29 @@ MainWindow::MainWindow(QWidget *parent)
     setWindowIcon(QIcon(":/count.ico"));
 
     // --- 线程和工作者设置 ---
+    qRegisterMetaType<QSharedPointer<PathTable>>("QSharedPointer<PathTable>");
+    paths_ = QSharedPointer<PathTable>::create(); // 扫描和统计共用的路径表
+
     workerThread_ = new QThread(this); // 父对象设为 this，以便在 MainWindow 析构时自动清理（如果MainWindow是堆分配的）
     xmlProcessor_ = new XmlProcessor(); // 不设置父对象，因为它将被移动到线程
+    xmlProcessor_->setPathTable(paths_);
     xmlProcessor_->moveToThread(workerThread_); // 将工作者对象移动到新线程
 
     // 连接 MainWindow 的信号到 XmlProcessor 的槽 (用于触发工作)
     // Qt::QueuedConnection 是跨线程连接的默认方式，确保槽函数在接收者所在线程执行
-    connect(this, &MainWindow::requestXmlDistributionProcessing, xmlProcessor_, &XmlProcessor::processXmlDistribution);
-    connect(this, &MainWindow::requestXmlBoxCountProcessing, xmlProcessor_, &XmlProcessor::processXmlBoxCounts);
+    // 两个统计按钮共用一次解析，结果缓存在 stats_ 中
+    connect(this, &MainWindow::requestDatasetProcessing, xmlProcessor_, &XmlProcessor::processDataset);
+    connect(this, &MainWindow::requestCachePath, xmlProcessor_, &XmlProcessor::setCachePath);
+    connect(this, &MainWindow::requestPathTable, xmlProcessor_, &XmlProcessor::setPathTable);
+    connect(this, &MainWindow::requestDatasetPreview, xmlProcessor_, &XmlProcessor::processDatasetPreview);
+    connect(this, &MainWindow::requestFileUpdate, xmlProcessor_, &XmlProcessor::updateFiles);
 
     // 连接 XmlProcessor 的信号到 MainWindow 的槽 (用于UI更新)
-    connect(xmlProcessor_, &XmlProcessor::distributionProcessingFinished, this, &MainWindow::updateDistributionTable);
-    connect(xmlProcessor_, &XmlProcessor::boxCountProcessingFinished, this, &MainWindow::updateBoxCountTable);
+    connect(xmlProcessor_, &XmlProcessor::datasetProcessingFinished, this, &MainWindow::onDatasetProcessed);
+    connect(xmlProcessor_, &XmlProcessor::datasetUpdated, this, &MainWindow::onDatasetUpdated);
+    connect(xmlProcessor_, &XmlProcessor::progressUpdated, this, &MainWindow::onProgressUpdated);
+    connect(xmlProcessor_, &XmlProcessor::previewReady, this, &MainWindow::onPreviewReady);
+    connect(xmlProcessor_, &XmlProcessor::processingCancelled, this, &MainWindow::onProcessingCancelled);
     connect(xmlProcessor_, &XmlProcessor::processingStarted, this, &MainWindow::onProcessingStarted);
     connect(xmlProcessor_, &XmlProcessor::processingFinished, this, &MainWindow::onProcessingFinished);
 
@@ -36,6 +50,26 @@ MainWindow::MainWindow(QWidget *parent)
 
     workerThread_->start(); // 启动工作线程的事件循环
 
+    // --- 目录扫描线程 ---
+    // 扫描放在单独的线程里，NFS 等慢速目录不会卡住界面，也不会阻塞统计线程
+    scanThread_ = new QThread(this);
+    xmlScanner_ = new XmlScanner(paths_);
+    xmlScanner_->moveToThread(scanThread_);
+    connect(this, &MainWindow::requestPathTable, xmlScanner_, &XmlScanner::setPathTable);
+    connect(this, &MainWindow::requestScan, xmlScanner_, &XmlScanner::scan);
+    connect(xmlScanner_, &XmlScanner::batchFound, this, &MainWindow::onScanBatch);
+    connect(xmlScanner_, &XmlScanner::scanFinished, this, &MainWindow::onScanFinished);
+    connect(scanThread_, &QThread::finished, xmlScanner_, &QObject::deleteLater);
+
+    datasetWatcher_ = new DatasetWatcher(paths_);
+    datasetWatcher_->moveToThread(scanThread_);
+    connect(this, &MainWindow::requestPathTable, datasetWatcher_, &DatasetWatcher::setPathTable);
+    connect(this, &MainWindow::requestWatch, datasetWatcher_, &DatasetWatcher::watch);
+    connect(this, &MainWindow::requestStopWatch, datasetWatcher_, &DatasetWatcher::stop);
+    connect(datasetWatcher_, &DatasetWatcher::filesChanged, this, &MainWindow::onWatchedFilesChanged);
+    connect(scanThread_, &QThread::finished, datasetWatcher_, &QObject::deleteLater);
+    scanThread_->start();
+
     connect_all(); // 连接按钮的点击事件等
 }
 
@@ -47,60 +81,229 @@ void MainWindow::setupUi() {
 
     buttonLayout  = new QHBoxLayout();
     btnLoad       = new QPushButton("xml路径", centralWidget);
+    btnCancelScan = new QPushButton("取消扫描", centralWidget);
     btnAnalyze    = new QPushButton("统计标签分布", centralWidget);
     btnAnalyzeBox = new QPushButton("统计标签个数", centralWidget);
+    btnStopAnalyze = new QPushButton("停止统计", centralWidget);
+
+    spinThreads   = new QSpinBox(centralWidget);
+    spinThreads->setRange(0, 256);
+    spinThreads->setValue(0);
+    spinThreads->setPrefix("线程数: ");
+    spinThreads->setSpecialValueText("线程数: 自动"); // 0 表示使用 CPU 核心数
+    spinThreads->setToolTip("解析XML使用的线程数，1 为串行");
+
+    checkWatch    = new QCheckBox("监视目录变化", centralWidget);
+    checkWatch->setToolTip("扫描完成后监视目录，标注文件新增、修改或删除时只重新解析这些文件并更新结果（COCO 不支持）");
+
+    comboFormat   = new QComboBox(centralWidget);
+    comboFormat->addItem("VOC XML", int(AnnotationFormat::Voc));
+    comboFormat->addItem("YOLO txt", int(AnnotationFormat::Yolo));
+    comboFormat->addItem("COCO JSON", int(AnnotationFormat::Coco));
+    comboFormat->setToolTip("标注格式，切换后重新扫描当前目录");
 
     buttonLayout->addItem(space);
+    buttonLayout->addWidget(comboFormat);
     buttonLayout->addWidget(btnLoad);
+    buttonLayout->addWidget(btnCancelScan);
     buttonLayout->addItem(space);
     buttonLayout->addWidget(btnAnalyze);
     buttonLayout->addItem(space);
     buttonLayout->addWidget(btnAnalyzeBox);
+    buttonLayout->addWidget(btnStopAnalyze);
     buttonLayout->addItem(space);
+    buttonLayout->addWidget(spinThreads);
+    buttonLayout->addWidget(checkWatch);
+    buttonLayout->addStretch();
     mainLayout->addLayout(buttonLayout);
 
     labelDir = new QLabel("当前选择目录 : ", centralWidget);
     mainLayout->addWidget(labelDir);
 
-    tabelWidget = new QTableWidget(6, 3, centralWidget);
+    histogramLayout = new QHBoxLayout();
+    comboBinMode  = new QComboBox(centralWidget);
+    comboBinMode->addItem("等宽区间", int(HistogramSpec::Mode::FixedWidth));
+    comboBinMode->addItem("对数区间", int(HistogramSpec::Mode::LogScale));
+    comboBinMode->addItem("分位数区间", int(HistogramSpec::Mode::Quantile));
+    spinBinParam  = new QSpinBox(centralWidget);
+    spinBinParam->setRange(1, 1000);
+    spinBinParam->setValue(5);
+    spinBinParam->setPrefix("宽度: ");
+    spinBinCount  = new QSpinBox(centralWidget);
+    spinBinCount->setRange(1, 100);
+    spinBinCount->setValue(6);
+    spinBinCount->setPrefix("区间数: ");
+    histogramLayout->addWidget(new QLabel("标签个数分布 : ", centralWidget));
+    histogramLayout->addWidget(comboBinMode);
+    histogramLayout->addWidget(spinBinParam);
+    histogramLayout->addWidget(spinBinCount);
+    histogramLayout->addStretch();
+    mainLayout->addLayout(histogramLayout);
+
+    previewLayout = new QHBoxLayout();
+    spinSampleSize = new QSpinBox(centralWidget);
+    spinSampleSize->setRange(100, 1000000);
+    spinSampleSize->setSingleStep(1000);
+    spinSampleSize->setValue(20000);
+    spinSampleSize->setPrefix("样本数: ");
+    checkStratified = new QCheckBox("按目录分层", centralWidget);
+    checkStratified->setChecked(true);
+    checkRefine = new QCheckBox("预览后继续精确统计", centralWidget);
+    checkRefine->setChecked(true);
+    btnPreview = new QPushButton("抽样预览", centralWidget);
+    btnPreview->setToolTip("只解析随机抽取的一部分文件，估计分布和标签个数（± 为 95% 置信区间）");
+    previewLayout->addWidget(new QLabel("抽样预览 : ", centralWidget));
+    previewLayout->addWidget(spinSampleSize);
+    previewLayout->addWidget(checkStratified);
+    previewLayout->addWidget(checkRefine);
+    previewLayout->addWidget(btnPreview);
+    previewLayout->addStretch();
+    mainLayout->addLayout(previewLayout);
+
+    tabelWidget = new QTableWidget(0, 3, centralWidget);
     tabelWidget->setHorizontalHeaderLabels(QStringList() << "标签个数（个/张）" << "有效数量（张数）" << "总数");
-
-    totalItem = new QTableWidgetItem("0");
-    totalItem->setTextAlignment(Qt::AlignCenter);
-    tabelWidget->setItem(0, 2, totalItem);
-    tabelWidget->setSpan(0, 2, 6, 1); // 总数跨越6行1列
-
-    // 初始化表格内容
-    QStringList labels = {"1-5", "6-10", "11-15", "16-20", "21-25", "25以上"};
-    for (int i = 0; i < 6; ++i) {
-        tabelWidget->setItem(i, 0, new QTableWidgetItem(labels[i]));
-        tabelWidget->setItem(i, 1, new QTableWidgetItem("0"));
-        tabelWidget->item(i,0)->setTextAlignment(Qt::AlignCenter); // (可选) 文本居中
-        tabelWidget->item(i,1)->setTextAlignment(Qt::AlignCenter); // (可选) 文本居中
-    }
     tabelWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch); // 列宽自适应
-
-    labelTabelWidget = new QTableWidget(0, 2, centralWidget); // 初始行数为0，动态添加
-    labelTabelWidget->setHorizontalHeaderLabels(QStringList() << "标签名称" << "个数");
-    labelTabelWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    rebuildDistributionTable(); // 初始化表格内容
+
+    labelCountPage = new QWidget(centralWidget);
+    QVBoxLayout *labelCountLayout = new QVBoxLayout(labelCountPage);
+    QHBoxLayout *labelFilterLayout = new QHBoxLayout();
+    labelFilterEdit = new QLineEdit(labelCountPage);
+    labelFilterEdit->setPlaceholderText("按标签名称过滤");
+    labelFilterEdit->setClearButtonEnabled(true);
+    labelCountSummary = new QLabel(labelCountPage);
+    labelFilterLayout->addWidget(labelFilterEdit);
+    labelFilterLayout->addWidget(labelCountSummary);
+    labelCountLayout->addLayout(labelFilterLayout);
+
+    labelCountModel = new LabelCountModel(this);
+    labelTableView = new QTableView(labelCountPage);
+    labelTableView->setModel(labelCountModel);
+    labelTableView->setSortingEnabled(true); // 点击表头排序，由模型只重排行号
+    labelTableView->sortByColumn(LabelCountModel::NameColumn, Qt::AscendingOrder);
+    labelTableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    labelTableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    // 行高固定，视图不用逐行计算大小
+    labelTableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    labelCountLayout->addWidget(labelTableView);
+    updateLabelCountSummary();
+
+    directoryPanel = new DirectoryPanel(centralWidget);
+    geometryPanel = new GeometryPanel(centralWidget);
+    qualityPanel = new QualityPanel(centralWidget);
+    queryPanel = new QueryPanel(centralWidget);
 
     mainLayout->addWidget(tabelWidget);
-    mainLayout->addWidget(labelTabelWidget);
+    resultTabs = new QTabWidget(centralWidget);
+    resultTabs->addTab(labelCountPage, "标签个数");
+    resultTabs->addTab(directoryPanel, "按目录");
+    resultTabs->addTab(geometryPanel, "框几何分布");
+    resultTabs->addTab(qualityPanel, "数据质量");
+    resultTabs->addTab(queryPanel, "筛选图片");
+    mainLayout->addWidget(resultTabs);
 
     centralWidget->setLayout(mainLayout);
     this->setCentralWidget(centralWidget);
 
+    progressBar = new QProgressBar(this);
+    progressBar->setMaximumWidth(240);
+    progressBar->setVisible(false);
+    statusBar()->addPermanentWidget(progressBar);
+
     // 初始时禁用分析按钮，因为尚未加载XML
     btnAnalyze->setEnabled(false);
     btnAnalyzeBox->setEnabled(false);
+    btnCancelScan->setEnabled(false);
+    btnStopAnalyze->setEnabled(false);
 }
 
 
 void MainWindow::connect_all()
 {
     connect(btnLoad, &QPushButton::clicked, this, &MainWindow::handleLoadXml);
+    connect(btnCancelScan, &QPushButton::clicked, this, &MainWindow::handleCancelScan);
+    connect(btnStopAnalyze, &QPushButton::clicked, this, &MainWindow::handleStopAnalyze);
+    connect(comboBinMode, &QComboBox::currentIndexChanged, this, [this]() {
+        // 切换模式时调整参数框的含义，参数框改值时屏蔽信号，最后统一重新分箱一次
+        const auto mode = HistogramSpec::Mode(comboBinMode->currentData().toInt());
+        const QSignalBlocker blocker(spinBinParam);
+        spinBinParam->setVisible(mode != HistogramSpec::Mode::Quantile);
+        if (mode == HistogramSpec::Mode::LogScale) {
+            spinBinParam->setRange(2, 10);
+            spinBinParam->setValue(2);
+            spinBinParam->setPrefix("底数: ");
+        } else {
+            spinBinParam->setRange(1, 1000);
+            spinBinParam->setValue(5);
+            spinBinParam->setPrefix("宽度: ");
+        }
+        applyHistogramSpec();
+    });
+    connect(spinBinParam, &QSpinBox::valueChanged, this, &MainWindow::applyHistogramSpec);
+    connect(spinBinCount, &QSpinBox::valueChanged, this, &MainWindow::applyHistogramSpec);
+    connect(labelFilterEdit, &QLineEdit::textChanged, this, [this](const QString& text) {
+        labelCountModel->setFilter(text);
+        updateLabelCountSummary();
+    });
+    connect(comboFormat, &QComboBox::currentIndexChanged, this, &MainWindow::handleFormatChanged);
     connect(btnAnalyze, &QPushButton::clicked, this, &MainWindow::handleAnalyzeDistribution);
     connect(btnAnalyzeBox, &QPushButton::clicked, this, &MainWindow::handleAnalyzeBoxCounts);
+    connect(btnPreview, &QPushButton::clicked, this, &MainWindow::handlePreview);
+    connect(checkWatch, &QCheckBox::toggled, this, &MainWindow::handleWatchToggled);
+    // setThreadCount 是线程安全的，直接调用即可，下一次统计时生效
+    connect(spinThreads, &QSpinBox::valueChanged, this, [this](int value) {
+        xmlProcessor_->setThreadCount(value);
+    });
+}
+
+void MainWindow::rebuildDistributionTable()
+{
+    const int rows = histogramSpec_.binCount();
+    tabelWidget->clearSpans();
+    tabelWidget->setRowCount(0);
+    tabelWidget->setRowCount(rows);
+
+    for (int i = 0; i < rows; ++i) {
+        tabelWidget->setItem(i, 0, new QTableWidgetItem(histogramSpec_.label(i)));
+        tabelWidget->setItem(i, 1, new QTableWidgetItem("0"));
+        tabelWidget->item(i,0)->setTextAlignment(Qt::AlignCenter); // (可选) 文本居中
+        tabelWidget->item(i,1)->setTextAlignment(Qt::AlignCenter); // (可选) 文本居中
+    }
+
+    totalItem = new QTableWidgetItem("0");
+    totalItem->setTextAlignment(Qt::AlignCenter);
+    tabelWidget->setItem(0, 2, totalItem);
+    if (rows > 1) {
+        tabelWidget->setSpan(0, 2, rows, 1); // 总数跨越所有区间行
+    }
+}
+
+void MainWindow::applyHistogramSpec()
+{
+    const auto mode = HistogramSpec::Mode(comboBinMode->currentData().toInt());
+    const int binCount = spinBinCount->value();
+    switch (mode) {
+    case HistogramSpec::Mode::LogScale:
+        histogramSpec_ = HistogramSpec::logScale(spinBinParam->value(), binCount);
+        break;
+    case HistogramSpec::Mode::Quantile:
+        // 分位数依赖已有结果，还没有统计时先用等宽区间
+        histogramSpec_ = stats_.objectsPerFile.isEmpty()
+                             ? HistogramSpec::fixedWidth(5, binCount)
+                             : HistogramSpec::quantile(stats_.objectsPerFile, binCount);
+        break;
+    default:
+        histogramSpec_ = HistogramSpec::fixedWidth(spinBinParam->value(), binCount);
+        break;
+    }
+    xmlProcessor_->setHistogramSpec(histogramSpec_); // 之后的进度和结果也按新区间统计
+
+    rebuildDistributionTable();
+    if (!stats_.objectsPerFile.isEmpty()) {
+        stats_.distribution = histogramSpec_.apply(stats_.objectsPerFile);
+        updateDistributionTable(stats_.distribution, stats_.validFiles);
+        directoryPanel->setHistogramSpec(histogramSpec_, stats_.objectsPerFile);
+    }
 }
 
 void MainWindow::handleLoadXml()
@@ -116,40 +319,216 @@ void MainWindow::handleLoadXml()
     }
 
     labelDir->setText("当前选择目录 : " + xml_dir_);
+    // 解析缓存放在数据集目录下，重复统计时只解析新增或修改过的文件
+    emit requestCachePath(ParseCache::defaultCachePath(xml_dir_));
+    startScan();
+}
+
+void MainWindow::handleFormatChanged()
+{
+    // 已经排队的增量更新可能还没开始，setInputFormat 是原子的，可以直接从界面线程设置
+    const auto format = AnnotationFormat(comboFormat->currentData().toInt());
+    xmlProcessor_->setInputFormat(format);
+    checkWatch->setEnabled(format != AnnotationFormat::Coco); // COCO 整个数据集在一个文件里，没法只更新一部分
+    if (!xml_dir_.isEmpty()) {
+        startScan(); // 不同格式对应不同的文件
+    }
+}
+
+void MainWindow::startScan()
+{
+    if (scanning_) {
+        xmlScanner_->cancel(scanId_); // 取消上一次还没结束的扫描，它后续发来的批次会因编号不符被丢弃
+    }
+    stopWatch(); // 扫描完成后按新的文件列表重新开始监视
 
     xml_list_.clear(); // 清除之前的结果
+    statsValid_ = false;
+    stats_ = DatasetStats(); // 旧目录的结果不再参与重新分箱
+    directoryPanel->clear();
+    geometryPanel->clear();
+    qualityPanel->clear();
+    queryPanel->clear();
+    resultTabs->setTabText(resultTabs->indexOf(qualityPanel), "数据质量");
+
+    // 每次扫描换一个新的路径表，旧目录和旧格式的路径随旧结果一起释放
+    // 三个工作对象按排队顺序换表：正在进行的扫描或统计仍使用旧表，结束后才切换
+    paths_ = QSharedPointer<PathTable>::create();
+    emit requestPathTable(paths_);
+
+    const auto format = AnnotationFormat(comboFormat->currentData().toInt());
+    scanning_ = true;
+    ++scanId_;
+    btnCancelScan->setEnabled(true);
+    updateAnalyzeButtons();
+    updateScanStatus();
+    emit requestScan(xml_dir_, AnnotationReader::nameFilters(format), AnnotationReader::excludedNames(format), scanId_);
+}
 
-    QStringList nameFilters;
-    nameFilters << "*.xml";
-    QDirIterator it(xml_dir_,
-                    nameFilters,
-                    QDir::Files | QDir::Readable, // 只查找文件，可读
-                    QDirIterator::Subdirectories); // 包含子目录
+void MainWindow::handleCancelScan()
+{
+    if (scanning_) {
+        xmlScanner_->cancel(scanId_);
+    }
+}
 
-    while (it.hasNext()) {
-        QString filePath = it.next();
-        xml_list_.push_back(filePath);
+void MainWindow::onScanBatch(int scanId, const QVector<PathId>& paths, int totalFound)
+{
+    Q_UNUSED(totalFound);
+    if (scanId != scanId_) {
+        return; // 已被取消的旧扫描
     }
+    xml_list_ += paths;
+    statsValid_ = false; // 文件列表变了，之前的统计结果不再完整
+    updateScanStatus();
+    updateAnalyzeButtons(); // 收到第一批后就可以开始统计
+}
 
-    if (xml_list_.isEmpty()) {
-        QMessageBox::information(this, "提示", "选择的文件夹中没有找到XML文件。");
-        btnAnalyze->setEnabled(false);
-        btnAnalyzeBox->setEnabled(false);
+void MainWindow::onScanFinished(int scanId, int totalFound, bool cancelled)
+{
+    if (scanId != scanId_) {
+        return;
+    }
+    qDebug() << "主线程: 目录扫描结束，文件数：" << totalFound << (cancelled ? "(已取消)" : "");
+    scanning_ = false;
+    btnCancelScan->setEnabled(false);
+    updateScanStatus();
+    updateAnalyzeButtons();
+
+    if (xml_list_.isEmpty() && !cancelled) {
+        QMessageBox::information(this, "提示", "选择的文件夹中没有找到 " + comboFormat->currentText() + " 标注文件。");
+    }
+    if (!cancelled) {
+        startWatch(); // 扫描被取消时文件列表不完整，不作为监视的基准
+    }
+}
+
+void MainWindow::handleWatchToggled(bool checked)
+{
+    if (checked) {
+        startWatch();
+    } else {
+        stopWatch();
+    }
+}
+
+void MainWindow::startWatch()
+{
+    const auto format = AnnotationFormat(comboFormat->currentData().toInt());
+    if (!checkWatch->isChecked() || watching_ || scanning_ || xml_dir_.isEmpty() || format == AnnotationFormat::Coco) {
+        return;
+    }
+    watching_ = true;
+    ++watchId_;
+    emit requestWatch(xml_dir_, AnnotationReader::nameFilters(format), AnnotationReader::excludedNames(format),
+                      xml_list_, watchId_);
+}
+
+void MainWindow::stopWatch()
+{
+    if (!watching_) {
+        return;
+    }
+    watching_ = false;
+    ++watchId_; // 已经在路上的通知会因编号不符被丢弃
+    pendingChanged_.clear();
+    pendingRemoved_.clear();
+    emit requestStopWatch();
+}
+
+void MainWindow::onWatchedFilesChanged(int watchId, const QVector<PathId>& changed, const QVector<PathId>& removed)
+{
+    if (watchId != watchId_) {
+        return;
+    }
+    // 文件列表与目录保持一致：删除的去掉，新出现的追加到末尾
+    if (!removed.isEmpty()) {
+        const QSet<PathId> removedSet(removed.constBegin(), removed.constEnd());
+        xml_list_.removeIf([&removedSet](PathId id) { return removedSet.contains(id); });
+    }
+    if (!changed.isEmpty()) {
+        const QSet<PathId> listed(xml_list_.constBegin(), xml_list_.constEnd());
+        for (PathId id : changed) {
+            if (!listed.contains(id)) {
+                xml_list_.append(id);
+            }
+        }
+    }
+
+    for (PathId id : changed) {
+        pendingChanged_.insert(id);
+        pendingRemoved_.remove(id);
+    }
+    for (PathId id : removed) {
+        pendingRemoved_.insert(id);
+        pendingChanged_.remove(id);
+    }
+    statsValid_ = false; // 增量更新完成后在 onDatasetUpdated 中恢复
+    statusBar()->showMessage(QString("目录有变化：%1 个文件新增或修改，%2 个文件删除，共 %3 个标注文件。")
+                             .arg(changed.size()).arg(removed.size()).arg(xml_list_.size()));
+    updateAnalyzeButtons();
+    flushWatchedChanges();
+}
+
+void MainWindow::flushWatchedChanges()
+{
+    if (processing_ || !stats_.store || (pendingChanged_.isEmpty() && pendingRemoved_.isEmpty())) {
+        return; // 还没有统计结果时不用更新，之后的完整统计会读到最新的文件
+    }
+    QVector<PathId> changed(pendingChanged_.constBegin(), pendingChanged_.constEnd());
+    QVector<PathId> removed(pendingRemoved_.constBegin(), pendingRemoved_.constEnd());
+    std::sort(changed.begin(), changed.end()); // 新文件按加入路径表的顺序追加，与 xml_list_ 一致
+    std::sort(removed.begin(), removed.end());
+    pendingChanged_.clear();
+    pendingRemoved_.clear();
+    // 工作线程原地修改 store 和倒排表，界面先放开对它们的引用，onDatasetUpdated 中再拿回更新后的结果
+    stats_.store.reset();
+    stats_.index.reset();
+    queryPanel->clear();
+    emit requestFileUpdate(changed, removed);
+}
+
+void MainWindow::onDatasetUpdated(const DatasetStats& stats, int changedFiles, int removedFiles)
+{
+    onDatasetProcessed(stats);
+    if (statsValid_) {
+        statusBar()->showMessage(QString("已重新解析 %1 个文件、移除 %2 个文件，共 %3 个标注文件，有效图片 %4 张。")
+                                 .arg(changedFiles).arg(removedFiles)
+                                 .arg(stats_.sourceFiles).arg(stats_.validFiles));
+    }
+}
+
+void MainWindow::updateScanStatus()
+{
+    if (scanning_) {
+        statusBar()->showMessage(QString("正在扫描，已找到 %1 个标注文件……").arg(xml_list_.size()));
+    } else if (!xml_list_.isEmpty()) {
+        statusBar()->showMessage(QString("加载了 %1 个标注文件。").arg(xml_list_.size()));
     } else {
-        QMessageBox::information(this, "提示", QString("加载了 %1 个XML文件。").arg(xml_list_.size()));
-        btnAnalyze->setEnabled(true); // 加载成功后启用分析按钮
-        btnAnalyzeBox->setEnabled(true);
+        statusBar()->clearMessage();
     }
 }
 
+void MainWindow::updateAnalyzeButtons()
+{
+    bool canAnalyze = !xml_list_.isEmpty() && !processing_;
+    btnAnalyze->setEnabled(canAnalyze);
+    btnAnalyzeBox->setEnabled(canAnalyze);
+    btnPreview->setEnabled(canAnalyze);
+}
+
 void MainWindow::handleAnalyzeDistribution()
 {
     if (xml_list_.isEmpty()) {
         QMessageBox::warning(this, "警告", "请先加载XML文件。");
         return;
     }
-    qDebug() << "主线程: 请求处理XML分布，文件数：" << xml_list_.size();
-    emit requestXmlDistributionProcessing(xml_list_);
+    if (statsValid_) {
+        updateDistributionTable(stats_.distribution, stats_.validFiles); // 已统计过，不再读盘
+        return;
+    }
+    qDebug() << "主线程: 请求统计数据集，文件数：" << xml_list_.size();
+    emit requestDatasetProcessing(xml_list_);
 }
 
 void MainWindow::handleAnalyzeBoxCounts()
@@ -158,19 +537,135 @@ void MainWindow::handleAnalyzeBoxCounts()
         QMessageBox::warning(this, "警告", "请先加载XML文件。");
         return;
     }
-    qDebug() << "主线程: 请求处理XML标签个数，文件数：" << xml_list_.size();
-    emit requestXmlBoxCountProcessing(xml_list_);
+    if (statsValid_) {
+        updateBoxCountTable(stats_.labelCounts); // 已统计过，不再读盘
+        return;
+    }
+    qDebug() << "主线程: 请求统计数据集，文件数：" << xml_list_.size();
+    emit requestDatasetProcessing(xml_list_);
+}
+
+void MainWindow::handlePreview()
+{
+    if (xml_list_.isEmpty()) {
+        QMessageBox::warning(this, "警告", "请先加载XML文件。");
+        return;
+    }
+    qDebug() << "主线程: 请求抽样预览，文件数：" << xml_list_.size() << "样本数：" << spinSampleSize->value();
+    previewRefine_ = checkRefine->isChecked(); // 预览结果按请求时的选择处理
+    emit requestDatasetPreview(xml_list_, spinSampleSize->value(), checkStratified->isChecked(),
+                               previewRefine_, QRandomGenerator::global()->generate());
+}
+
+void MainWindow::handleStopAnalyze()
+{
+    // 工作线程正忙，不能通过排队的信号通知，直接设置取消标志
+    xmlProcessor_->requestCancel();
+    btnStopAnalyze->setEnabled(false);
+}
+
+void MainWindow::onProgressUpdated(const DatasetProgress& progress)
+{
+    if (refining_) {
+        // 表格保持抽样预览的估计值，直到精确结果出来
+        progressBar->setRange(0, progress.totalFiles);
+        progressBar->setValue(progress.filesDone);
+        statusBar()->showMessage(QString("抽样预览已显示，正在精确统计其余 %1 个文件：已处理 %2 个，%3 个/秒")
+                                 .arg(progress.totalFiles).arg(progress.filesDone)
+                                 .arg(progress.filesPerSecond, 0, 'f', 0));
+        return;
+    }
+    if (progress.bytesTotal > 0) {
+        // COCO 只有一个很大的文件，按字节显示千分比
+        progressBar->setRange(0, 1000);
+        progressBar->setValue(int(progress.bytesDone * 1000 / progress.bytesTotal));
+        statusBar()->showMessage(QString("已读取 %1 / %2 MB，%3 张图片/秒")
+                                 .arg(progress.bytesDone / (1024 * 1024))
+                                 .arg(progress.bytesTotal / (1024 * 1024))
+                                 .arg(progress.filesPerSecond, 0, 'f', 0));
+    } else {
+        progressBar->setRange(0, progress.totalFiles);
+        progressBar->setValue(progress.filesDone);
+        statusBar()->showMessage(QString("已处理 %1 / %2 个文件，%3 个/秒")
+                                 .arg(progress.filesDone)
+                                 .arg(progress.totalFiles)
+                                 .arg(progress.filesPerSecond, 0, 'f', 0));
+    }
+    updateDistributionTable(progress.partial.distribution, progress.partial.validFiles);
+    updateBoxCountTable(progress.partial.labelCounts);
+}
+
+void MainWindow::onPreviewReady(const DatasetEstimate& estimate)
+{
+    refining_ = previewRefine_;
+    statsValid_ = false;
+
+    // 估计值按预览开始时的区间分箱，区间已被修改时只更新标签个数
+    if (estimate.spec == histogramSpec_ && estimate.distribution.size() == tabelWidget->rowCount()) {
+        for (int i = 0; i < estimate.distribution.size(); ++i) {
+            const DatasetEstimate::Value& bin = estimate.distribution[i];
+            tabelWidget->item(i, 1)->setText(QString("≈%1 ± %2").arg(qRound64(bin.value)).arg(qRound64(bin.margin)));
+        }
+        totalItem->setText(QString("≈%1 ± %2")
+                           .arg(qRound64(estimate.validFiles.value)).arg(qRound64(estimate.validFiles.margin)));
+    }
+
+    QMap<QString, int> counts;
+    QMap<QString, int> margins;
+    for (auto it = estimate.labelCounts.constBegin(); it != estimate.labelCounts.constEnd(); ++it) {
+        counts.insert(it.key(), int(qRound64(it.value().value)));
+        margins.insert(it.key(), int(qRound64(it.value().margin)));
+    }
+    labelCountModel->setCounts(counts, margins);
+    updateLabelCountSummary();
+
+    statusBar()->showMessage(QString("抽样预览：样本 %1 / %2 个文件（%3 层），± 为 95% 置信区间%4")
+                             .arg(estimate.sampledFiles).arg(estimate.totalFiles).arg(estimate.strata)
+                             .arg(refining_ ? "，正在后台精确统计……" : "。"));
+}
+
+void MainWindow::onProcessingCancelled(int filesDone, int totalFiles)
+{
+    refining_ = false;
+    // 表格中保留最后一次进度的部分结果
+    statsValid_ = false;
+    statusBar()->showMessage(QString("统计已停止，已处理 %1 / %2 个文件，表格为部分结果。")
+                             .arg(filesDone).arg(totalFiles));
+}
+
+void MainWindow::onDatasetProcessed(const DatasetStats& stats)
+{
+    refining_ = false;
+    stats_ = stats;
+    // 扫描过程中开始的统计只覆盖当时已找到的文件，之后再点按钮会重新统计
+    statsValid_ = !scanning_ && stats_.sourceFiles == xml_list_.size();
+    if (!statsValid_) {
+        statusBar()->showMessage(QString("统计结果基于已找到的前 %1 个标注文件，扫描完成后可重新统计。")
+                                 .arg(stats_.sourceFiles));
+    } else {
+        statusBar()->showMessage(QString("统计完成，共 %1 个标注文件、%2 张图片，有效图片 %3 张。")
+                                 .arg(stats_.sourceFiles).arg(stats_.objectsPerFile.size()).arg(stats_.validFiles));
+    }
+    applyHistogramSpec(); // 按当前区间分箱（分位数区间需要根据新结果重新计算）
+    updateBoxCountTable(stats_.labelCounts);
+    directoryPanel->setStats(stats_.directories, histogramSpec_, stats_.objectsPerFile);
+    geometryPanel->setStats(stats_.geometry);
+    qualityPanel->setReport(stats_.report, stats_.sourceFiles);
+    queryPanel->setStats(stats_);
+    resultTabs->setTabText(resultTabs->indexOf(qualityPanel),
+                           stats_.report.isEmpty() ? QString("数据质量")
+                                                   : QString("数据质量 (%1)").arg(stats_.report.issueCount()));
 }
 
 
 void MainWindow::updateDistributionTable(const QVector<int>& counts, int totalFilesProcessed)
 {
-    if (counts.size() != 6) {
-        qWarning() << "收到的分布表计数值大小异常:" << counts.size();
+    if (counts.size() != tabelWidget->rowCount()) {
+        qWarning() << "收到的分布表计数值大小异常:" << counts.size(); // 区间在统计过程中被修改
         return;
     }
 
-    for(int i = 0; i < 6; i++)
+    for(int i = 0; i < counts.size(); i++)
     {
         // 确保 item(i,1) 存在
         if (tabelWidget->item(i, 1)) {
@@ -189,43 +684,57 @@ void MainWindow::updateDistributionTable(const QVector<int>& counts, int totalFi
 
 void MainWindow::updateBoxCountTable(const QMap<QString, int>& boxMap)
 {
-    labelTabelWidget->setRowCount(0); // 清除之前的条目
+    labelCountModel->setCounts(boxMap);
+    updateLabelCountSummary();
+}
 
-    for (QMap<QString, int>::const_iterator it = boxMap.constBegin(); it != boxMap.constEnd(); ++it) {
-        int new_row = labelTabelWidget->rowCount();
-        labelTabelWidget->insertRow(new_row);
-        QTableWidgetItem* keyItem = new QTableWidgetItem(it.key());
-        QTableWidgetItem* valueItem = new QTableWidgetItem(QString::number(it.value()));
-        keyItem->setTextAlignment(Qt::AlignCenter);
-        valueItem->setTextAlignment(Qt::AlignCenter);
-        labelTabelWidget->setItem(new_row, 0, keyItem);
-        labelTabelWidget->setItem(new_row, 1, valueItem);
-    }
-    if (boxMap.isEmpty()) {
-        // 如果没有标签，可以考虑显示一个提示，或者保持表格为空
-        labelTabelWidget->insertRow(0);
-        labelTabelWidget->setItem(0, 0, new QTableWidgetItem("没有找到标签"));
-        labelTabelWidget->setSpan(0,0,1,2); // 跨列显示
+void MainWindow::updateLabelCountSummary()
+{
+    if (labelCountModel->totalLabels() == 0) {
+        labelCountSummary->setText("没有找到标签");
+    } else if (labelCountModel->filter().isEmpty()) {
+        labelCountSummary->setText(QString("共 %1 个标签").arg(labelCountModel->totalLabels()));
+    } else {
+        labelCountSummary->setText(QString("显示 %1 / 共 %2 个标签")
+                                   .arg(labelCountModel->visibleLabels()).arg(labelCountModel->totalLabels()));
     }
 }
 
 void MainWindow::onProcessingStarted() {
-    btnAnalyze->setEnabled(false);
-    btnAnalyzeBox->setEnabled(false);
+    processing_ = true;
+    updateAnalyzeButtons();
     btnLoad->setEnabled(false); // 处理期间也禁用加载按钮
+    comboFormat->setEnabled(false);
+    checkRefine->setEnabled(false); // 已发出的预览请求按发出时的选择执行
+    btnStopAnalyze->setEnabled(true);
+    progressBar->setValue(0);
+    progressBar->setVisible(true);
 }
 
 void MainWindow::onProcessingFinished() {
     // 根据XML是否已加载来重新启用分析按钮
-    bool xmlsLoaded = !xml_list_.isEmpty();
-    btnAnalyze->setEnabled(xmlsLoaded);
-    btnAnalyzeBox->setEnabled(xmlsLoaded);
+    processing_ = false;
+    refining_ = false;
+    updateAnalyzeButtons();
     btnLoad->setEnabled(true); // 加载按钮总是可以重新启用
+    comboFormat->setEnabled(true);
+    checkRefine->setEnabled(true);
+    btnStopAnalyze->setEnabled(false);
+    progressBar->setVisible(false);
+    flushWatchedChanges(); // 统计期间积累的文件变化
 }
 
 
 MainWindow::~MainWindow()
 {
+    if (xmlProcessor_) {
+        xmlProcessor_->requestCancel(); // 让正在进行的统计尽快结束，避免析构时等待
+    }
+    if (scanThread_ && scanThread_->isRunning()) {
+        xmlScanner_->cancel(scanId_); // 让正在进行的扫描尽快返回
+        scanThread_->quit();
+        scanThread_->wait();
+    }
     if (workerThread_ && workerThread_->isRunning()) {
         workerThread_->quit(); // 请求线程的事件循环退出
         if (!workerThread_->wait(5000)) { // 等待最多5秒
@@ -4,12 +4,25 @@
 #include <QMainWindow>
 #include <QVBoxLayout>
 #include <QPushButton>
-// #include <QLineEdit> // 如果不再需要，可以移除
+#include <QLineEdit>
+#include <QTableView>
 #include <QFileDialog>
 #include <QTableWidget>
 #include <QLabel>
+#include <QSpinBox>
+#include <QProgressBar>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QTabWidget>
 #include <QThread>        // 添加 QThread 头文件
 #include "xmlprocessor.h" // 添加 XmlProcessor 头文件
+#include "xmlscanner.h"
+#include "datasetwatcher.h"
+#include "directorypanel.h"
+#include "geometrypanel.h"
+#include "qualitypanel.h"
+#include "querypanel.h"
+#include "labelcountmodel.h"
 
 // 如果 vocParser.h 的完整定义在这里不是必需的，可以前向声明
 // class VocParser; // 如果 XmlProcessor 完全处理它，则不需要
@@ -29,45 +42,135 @@ private:
     QSpacerItem *space = nullptr;
 
     QPushButton *btnLoad    = nullptr;
+    QPushButton *btnCancelScan = nullptr;
     QPushButton *btnAnalyze = nullptr;
     QPushButton *btnAnalyzeBox = nullptr;
+    QPushButton *btnStopAnalyze = nullptr;
+    QSpinBox    *spinThreads = nullptr;
+    QCheckBox   *checkWatch = nullptr;  // 扫描完成后监视目录，文件保存后自动增量更新结果
+    QComboBox   *comboFormat = nullptr; // 标注格式：VOC / YOLO / COCO
 
     QLabel *labelDir = nullptr;
 
+    // 分布区间设置
+    QHBoxLayout *histogramLayout = nullptr;
+    QComboBox *comboBinMode = nullptr;   // 等宽 / 对数 / 分位数
+    QSpinBox *spinBinParam = nullptr;    // 等宽时为区间宽度，对数时为底数
+    QSpinBox *spinBinCount = nullptr;
+
+    // 抽样预览设置
+    QHBoxLayout *previewLayout = nullptr;
+    QSpinBox *spinSampleSize = nullptr;
+    QCheckBox *checkStratified = nullptr; // 按目录分层
+    QCheckBox *checkRefine = nullptr;     // 预览后继续精确统计
+    QPushButton *btnPreview = nullptr;
+
     QTableWidget *tabelWidget = nullptr;
     QTableWidgetItem *totalItem = nullptr;
 
-    QTableWidget *labelTabelWidget = nullptr;
+    // 标签个数表：模型只保存数据，视图只绘制可见行，标签很多时也不卡
+    QWidget *labelCountPage = nullptr;
+    QLineEdit *labelFilterEdit = nullptr;
+    QLabel *labelCountSummary = nullptr;
+    QTableView *labelTableView = nullptr;
+    LabelCountModel *labelCountModel = nullptr;
+    GeometryPanel *geometryPanel = nullptr;
+    DirectoryPanel *directoryPanel = nullptr;
+    QualityPanel *qualityPanel = nullptr;
+    QueryPanel *queryPanel = nullptr;
+    QTabWidget *resultTabs = nullptr; // 标签个数 / 按目录 / 框几何分布 / 数据质量 / 筛选图片
+
+    QProgressBar *progressBar = nullptr; // 状态栏中的统计进度
 
 private:
     void setupUi();
     void connect_all();
 
+    // 根据 histogramSpec_ 重建分布表的行（区间说明、计数清零、总数跨行）
+    void rebuildDistributionTable();
+
 
 private slots:
     // 处理按钮点击的槽函数
     void handleLoadXml();
+    void handleCancelScan();
+    void handleFormatChanged();
     void handleAnalyzeDistribution();
     void handleAnalyzeBoxCounts();
+    void handleStopAnalyze();
+    void handlePreview();
+    // 区间设置变化：重新生成区间，已有统计结果直接重新分箱，不读盘
+    void applyHistogramSpec();
 
     // 更新UI的槽函数，由工作线程的信号触发
     void updateDistributionTable(const QVector<int>& counts, int totalFilesProcessed);
     void updateBoxCountTable(const QMap<QString, int>& boxMap);
+    void updateLabelCountSummary();
+    void onDatasetProcessed(const DatasetStats& stats); // 一次统计结果同时填充两张表
+    void onProgressUpdated(const DatasetProgress& progress); // 统计过程中实时刷新两张表
+    void onPreviewReady(const DatasetEstimate& estimate);    // 用估计值和置信区间填充两张表
+    void onProcessingCancelled(int filesDone, int totalFiles);
     void onProcessingStarted();  // 用于禁用按钮
     void onProcessingFinished(); // 用于重新启用按钮
 
+    // 后台目录扫描的结果
+    void onScanBatch(int scanId, const QVector<PathId>& paths, int totalFound);
+    void onScanFinished(int scanId, int totalFound, bool cancelled);
+
+    // 监视模式：目录中的标注文件有变化
+    void handleWatchToggled(bool checked);
+    void onWatchedFilesChanged(int watchId, const QVector<PathId>& changed, const QVector<PathId>& removed);
+    void onDatasetUpdated(const DatasetStats& stats, int changedFiles, int removedFiles);
+
 private:
     QString xml_dir_;
-    QVector<QString> xml_list_;
+    QVector<PathId> xml_list_;  // 序号指向 paths_
+    QSharedPointer<PathTable> paths_; // 扫描线程写入，统计线程和界面读取；每次扫描换一个新表，旧路径不会越积越多
+
+    DatasetStats stats_;       // 最近一次统计结果
+    HistogramSpec histogramSpec_; // 当前分布表使用的区间
+    bool statsValid_ = false;  // stats_ 是否对应当前的 xml_list_
+
+    bool scanning_ = false;    // 后台扫描是否仍在进行
+    bool processing_ = false;  // 工作线程是否正在统计
+    bool refining_ = false;    // 抽样预览已显示，后台正在精确统计其余文件，进度不刷新表格
+    bool previewRefine_ = false; // 最近一次预览请求是否要求继续精确统计
+    int scanId_ = 0;           // 当前扫描的编号，旧扫描的批次会被丢弃
+    int watchId_ = 0;          // 当前监视的编号，停止监视后收到的通知会被丢弃
+    bool watching_ = false;
+    QSet<PathId> pendingChanged_; // 还没交给工作线程增量更新的变化，工作线程空闲时一次发出
+    QSet<PathId> pendingRemoved_;
 
     // VocParser parser_; // VocParser 实例将移至工作者线程
 
     QThread *workerThread_ = nullptr;         // 添加工作线程指针
     XmlProcessor *xmlProcessor_ = nullptr; // 添加工作者对象指针
 
+    QThread *scanThread_ = nullptr;   // 目录扫描线程，和统计线程分开，扫描时也可以统计
+    XmlScanner *xmlScanner_ = nullptr;
+    DatasetWatcher *datasetWatcher_ = nullptr; // 与扫描共用一个线程
+
+    void updateScanStatus();
+    void updateAnalyzeButtons();
+    // 取消正在进行的扫描，清空文件列表和结果，按当前格式重新扫描 xml_dir_
+    void startScan();
+    // 按当前格式监视 xml_dir_，以 xml_list_ 为基准；未勾选监视、仍在扫描或 COCO 格式时不监视
+    void startWatch();
+    void stopWatch();
+    // 把积累的变化交给工作线程；正在统计时等 onProcessingFinished 再发
+    void flushWatchedChanges();
+
 signals: // 用于触发工作者槽函数的信号
-    void requestXmlDistributionProcessing(const QVector<QString>& xmlFiles);
-    void requestXmlBoxCountProcessing(const QVector<QString>& xmlFiles);
+    void requestDatasetProcessing(const QVector<PathId>& xmlFiles);
+    void requestDatasetPreview(const QVector<PathId>& xmlFiles, int sampleSize, bool stratified, bool refine,
+                               quint32 seed);
+    void requestCachePath(const QString& cachePath);
+    void requestPathTable(const QSharedPointer<PathTable>& paths);
+    void requestScan(const QString& dir, const QStringList& nameFilters, const QStringList& excludedNames, int scanId);
+    void requestWatch(const QString& dir, const QStringList& nameFilters, const QStringList& excludedNames,
+                      const QVector<PathId>& files, int watchId);
+    void requestStopWatch();
+    void requestFileUpdate(const QVector<PathId>& changed, const QVector<PathId>& removed);
 
 };
 
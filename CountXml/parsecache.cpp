@@ -0,0 +1,161 @@
+#include "parsecache.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+
+namespace {
+
+constexpr quint32 kCacheMagic = 0x43584331; // "CXC1"
+constexpr quint32 kCacheVersion = 3; // 3: 增加图片宽高
+// 一个条目至少占的字节数：路径长度 4 + 大小和修改时间 16 + 图片宽高 8 + 对象数 4
+constexpr qint64 kMinEntryBytes = 32;
+
+} // namespace
+
+QString ParseCache::defaultCachePath(const QString& datasetDir)
+{
+    return QDir(datasetDir).filePath(".countxml_cache");
+}
+
+bool ParseCache::load(const QString& cacheFile)
+{
+    clear();
+
+    QFile file(cacheFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false; // 第一次运行时没有缓存，属于正常情况
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_15);
+
+    quint32 magic = 0, version = 0;
+    in >> magic >> version;
+    if (magic != kCacheMagic || version != kCacheVersion) {
+        qWarning() << "Warning: Ignoring incompatible parse cache:" << cacheFile;
+        return false;
+    }
+
+    in >> labels_;
+    for (int i = 0; i < labels_.size(); ++i) {
+        labelIds_.insert(labels_[i], i);
+    }
+
+    quint32 entryCount = 0;
+    in >> entryCount;
+    // 条目数来自文件，损坏时可能很大；按剩余字节数能容纳的条目数封顶后再预留
+    entries_.reserve(qsizetype(std::min<qint64>(entryCount, file.bytesAvailable() / kMinEntryBytes)));
+    for (quint32 i = 0; i < entryCount && in.status() == QDataStream::Ok; ++i) {
+        QByteArray path;
+        Entry entry;
+        in >> path >> entry.size >> entry.mtime >> entry.imageWidth >> entry.imageHeight >> entry.data;
+        entries_.insert(QString::fromUtf8(path), std::move(entry));
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "Warning: Parse cache is truncated, ignoring it:" << cacheFile;
+        clear();
+        return false;
+    }
+    return true;
+}
+
+bool ParseCache::save(const QString& cacheFile) const
+{
+    QSaveFile file(cacheFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Warning: Cannot write parse cache:" << cacheFile << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_15);
+    out << kCacheMagic << kCacheVersion;
+    out << labels_;
+    out << quint32(entries_.size());
+    for (auto it = entries_.constBegin(); it != entries_.constEnd(); ++it) {
+        const Entry& entry = it.value();
+        out << it.key().toUtf8() << entry.size << entry.mtime
+            << entry.imageWidth << entry.imageHeight << entry.data;
+    }
+    return file.commit();
+}
+
+bool ParseCache::lookupInto(const QString& filePath, qint64 size, qint64 mtime,
+                            AnnotationStore& store, QVector<int>& labelRemap) const
+{
+    auto it = entries_.constFind(filePath);
+    if (it == entries_.constEnd() || it->size != size || it->mtime != mtime) {
+        return false;
+    }
+
+    store.setImageSize(it->imageWidth, it->imageHeight);
+    if (labelRemap.size() < labels_.size()) {
+        labelRemap.resize(labels_.size(), -1);
+    }
+    const QVector<qint32>& data = it->data;
+    for (int i = 0; i + kValuesPerObject <= data.size(); i += kValuesPerObject) {
+        if (data[i] < 0 || data[i] >= labels_.size()) {
+            continue; // 损坏的条目
+        }
+        int& labelId = labelRemap[data[i]];
+        if (labelId < 0) {
+            labelId = store.internLabel(labels_[data[i]]);
+        }
+        store.addBox(labelId, data[i + 1], data[i + 2], data[i + 3], data[i + 4]);
+    }
+    return true;
+}
+
+void ParseCache::insert(const Record& record, const AnnotationStore& store)
+{
+    Entry entry;
+    entry.size = record.size;
+    entry.mtime = record.mtime;
+    entry.imageWidth = store.imageWidth(record.fileIndex);
+    entry.imageHeight = store.imageHeight(record.fileIndex);
+
+    const qsizetype begin = store.fileBegin(record.fileIndex);
+    const qsizetype end = begin + store.fileBoxCount(record.fileIndex);
+    entry.data.reserve((end - begin) * kValuesPerObject);
+    for (qsizetype b = begin; b < end; ++b) {
+        const QString name = store.labelName(store.labelIds()[b]);
+        auto labelIt = labelIds_.constFind(name);
+        if (labelIt == labelIds_.constEnd()) {
+            labelIt = labelIds_.insert(name, labels_.size());
+            labels_.append(name);
+        }
+        entry.data << labelIt.value()
+                   << store.xmin()[b] << store.ymin()[b] << store.xmax()[b] << store.ymax()[b];
+    }
+    entries_.insert(record.filePath, std::move(entry));
+}
+
+void ParseCache::pruneMissing(const QVector<PathId>& seenFiles, const PathTable& paths)
+{
+    if (entries_.size() <= seenFiles.size()) {
+        return; // 每个条目都来自本次统计用到的文件
+    }
+    QVector<bool> seen(paths.size(), false);
+    for (PathId id : seenFiles) {
+        seen[id] = true;
+    }
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        const PathId id = paths.find(it.key());
+        if ((id >= 0 && id < seen.size() && seen[id]) || QFileInfo::exists(it.key())) {
+            ++it;
+        } else {
+            it = entries_.erase(it);
+        }
+    }
+}
+
+void ParseCache::clear()
+{
+    labels_.clear();
+    labelIds_.clear();
+    entries_.clear();
+}
@@ -0,0 +1,68 @@
+#ifndef PARSECACHE_H
+#define PARSECACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QVector>
+#include "vocParser.h"
+#include "annotationstore.h"
+#include "pathtable.h"
+
+// 保存在数据集目录下的解析缓存
+// 以 文件路径 + 文件大小 + 修改时间 为键保存每个文件解析出的对象和图片宽高，
+// 标签名在缓存内只存一份，每个对象只占 5 个整数 (标签序号, xmin, ymin, xmax, ymax)
+class ParseCache
+{
+public:
+    // 一个没有命中缓存的文件，工作线程先各自收集，统计结束后再从合并好的 store 写入缓存
+    struct Record
+    {
+        QString filePath;
+        qint64 size = 0;
+        qint64 mtime = 0;
+        int fileIndex = 0; // 在 AnnotationStore 中的文件序号
+    };
+
+    // 缓存文件名，放在所选数据集目录的根下
+    static QString defaultCachePath(const QString& datasetDir);
+
+    // 读取缓存文件，文件不存在或格式不对时缓存为空并返回 false
+    bool load(const QString& cacheFile);
+    // 写回缓存文件（先写临时文件再替换）
+    bool save(const QString& cacheFile) const;
+
+    // 大小和修改时间都一致才算命中，命中时把对象和图片宽高写入 store 当前的文件中
+    // labelRemap 是调用方持有的 缓存标签序号 -> store 标签序号 映射，按需填充
+    // 只读，可以在多个工作线程中同时调用（每个线程使用自己的 store 和 labelRemap）
+    bool lookupInto(const QString& filePath, qint64 size, qint64 mtime,
+                    AnnotationStore& store, QVector<int>& labelRemap) const;
+
+    // 写入或覆盖一个文件的解析结果（取自 store 中 record.fileIndex 对应的框），只能在单线程中调用
+    void insert(const Record& record, const AnnotationStore& store);
+    // 去掉已被删除的文件的缓存
+    // seenFiles 是本次统计用到的文件，一定存在；其余条目需要检查磁盘，
+    // 这样扫描尚未结束时的部分统计不会把还没扫到的文件从缓存中删掉
+    void pruneMissing(const QVector<PathId>& seenFiles, const PathTable& paths);
+
+    void clear();
+    int size() const { return entries_.size(); }
+
+private:
+    struct Entry
+    {
+        qint64 size = 0;
+        qint64 mtime = 0;
+        qint32 imageWidth = 0;
+        qint32 imageHeight = 0;
+        QVector<qint32> data; // 每个对象 5 个值：标签序号, xmin, ymin, xmax, ymax
+    };
+
+    static constexpr int kValuesPerObject = 5;
+
+    QStringList labels_;
+    QHash<QString, qint32> labelIds_;
+    QHash<QString, Entry> entries_;
+};
+
+#endif // PARSECACHE_H
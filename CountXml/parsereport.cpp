@@ -0,0 +1,110 @@
+#include "parsereport.h"
+#include <QJsonArray>
+#include <QTextStream>
+
+void ParseReport::merge(const ParseReport& other)
+{
+    for (int i = 0; i < IssueCount; ++i) {
+        counts_[i] += other.counts_[i];
+        const QVector<Sample>& from = other.samples_[i];
+        QVector<Sample>& into = samples_[i];
+        for (int s = 0; s < from.size() && into.size() < kMaxSamples; ++s) {
+            into.append(from[s]);
+        }
+    }
+}
+
+void ParseReport::clear()
+{
+    counts_.fill(0);
+    for (QVector<Sample>& samples : samples_) {
+        samples.clear();
+    }
+}
+
+qint64 ParseReport::issueCount() const
+{
+    qint64 total = 0;
+    for (qint64 count : counts_) {
+        total += count;
+    }
+    return total;
+}
+
+QString ParseReport::issueLabel(Issue issue)
+{
+    switch (issue) {
+    case CannotOpen:    return "无法打开的文件";
+    case MalformedFile: return "格式错误的文件";
+    case WrongRoot:     return "根元素不是 annotation 的文件";
+    case MissingName:   return "缺少 name 的对象";
+    case MissingBndbox: return "缺少 bndbox 的对象";
+    case InvalidBndbox: return "坐标无效的框";
+    case InvalidLine:   return "无法识别的 YOLO 行";
+    case UnknownImage:  return "图片不存在的 COCO 标注";
+    case IssueCount:    break;
+    }
+    return QString();
+}
+
+QString ParseReport::issueKey(Issue issue)
+{
+    switch (issue) {
+    case CannotOpen:    return "cannotOpen";
+    case MalformedFile: return "malformedFile";
+    case WrongRoot:     return "wrongRoot";
+    case MissingName:   return "missingName";
+    case MissingBndbox: return "missingBndbox";
+    case InvalidBndbox: return "invalidBndbox";
+    case InvalidLine:   return "invalidLine";
+    case UnknownImage:  return "unknownImage";
+    case IssueCount:    break;
+    }
+    return QString();
+}
+
+QJsonObject ParseReport::toJson() const
+{
+    QJsonObject root;
+    for (int i = 0; i < IssueCount; ++i) {
+        if (counts_[i] == 0) {
+            continue;
+        }
+        QJsonArray samples;
+        for (const Sample& sample : samples_[i]) {
+            QJsonObject item;
+            item["file"] = sample.filePath;
+            item["detail"] = sample.detail;
+            samples.append(item);
+        }
+        QJsonObject entry;
+        entry["count"] = counts_[i];
+        entry["samples"] = samples;
+        root[issueKey(Issue(i))] = entry;
+    }
+    return root;
+}
+
+QByteArray ParseReport::toCsv() const
+{
+    auto quoted = [](QString text) -> QString {
+        text.replace('"', "\"\"");
+        return '"' + text + '"';
+    };
+
+    QByteArray csv;
+    QTextStream out(&csv);
+    out << "issue,count,file,detail\n";
+    for (int i = 0; i < IssueCount; ++i) {
+        if (counts_[i] == 0) {
+            continue;
+        }
+        const QString key = issueKey(Issue(i));
+        out << key << "," << counts_[i] << ",,\n";
+        for (const Sample& sample : samples_[i]) {
+            out << key << ",," << quoted(sample.filePath) << "," << quoted(sample.detail) << "\n";
+        }
+    }
+    out.flush();
+    return csv;
+}
@@ -0,0 +1,74 @@
+#ifndef PARSEREPORT_H
+#define PARSEREPORT_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+#include <array>
+
+// 解析过程中发现的数据质量问题
+// 每类问题只累加计数，并保留前 kMaxSamples 个样本（文件和说明），不逐条输出日志，
+// 脏数据很多时也不会因为格式化和输出日志拖慢解析
+// 每个工作任务使用自己的报告，按块的顺序合并，结果与串行解析一致
+class ParseReport
+{
+public:
+    enum Issue
+    {
+        CannotOpen,    // 文件无法打开
+        MalformedFile, // XML/JSON 格式错误，整个文件不计入
+        WrongRoot,     // 根元素不是 <annotation>，整个文件不计入
+        MissingName,   // 对象没有 <name>
+        MissingBndbox, // 对象没有 <bndbox>
+        InvalidBndbox, // 坐标无效：xmax < xmin、ymax < ymin 或宽高为 0
+        InvalidLine,   // YOLO 中无法识别的行
+        UnknownImage,  // COCO 中引用了不存在的图片的标注
+        IssueCount
+    };
+
+    static constexpr int kMaxSamples = 20; // 每类问题保留的样本数
+
+    struct Sample
+    {
+        QString filePath;
+        QString detail; // 对象名、行号或错误原因
+    };
+
+    // 记录一次问题，样本已满时只计数
+    void add(Issue issue, const QString& filePath, const QString& detail = QString())
+    {
+        ++counts_[issue];
+        if (samples_[issue].size() < kMaxSamples) {
+            samples_[issue].append({filePath, detail});
+        }
+    }
+    // 样本已满时调用方不必再格式化 detail
+    bool wantsSample(Issue issue) const { return samples_[issue].size() < kMaxSamples; }
+
+    // 把 other 追加到后面，样本仍然最多保留 kMaxSamples 个
+    void merge(const ParseReport& other);
+    void clear();
+
+    qint64 count(Issue issue) const { return counts_[issue]; }
+    const QVector<Sample>& samples(Issue issue) const { return samples_[issue]; }
+    // 全部问题的次数
+    qint64 issueCount() const;
+    bool isEmpty() const { return issueCount() == 0; }
+
+    // 界面上显示的说明，例如 "缺少 bndbox 的对象"
+    static QString issueLabel(Issue issue);
+    // 导出时使用的英文键，例如 "missingBndbox"
+    static QString issueKey(Issue issue);
+
+    // {"missingBndbox": {"count": 3, "samples": [{"file": ..., "detail": ...}]}, ...}，只包含出现过的问题
+    QJsonObject toJson() const;
+    // issue,count,file,detail 四列，每类问题一行汇总（file 为空），之后是它的样本
+    QByteArray toCsv() const;
+
+private:
+    std::array<qint64, IssueCount> counts_{};
+    std::array<QVector<Sample>, IssueCount> samples_;
+};
+
+#endif // PARSEREPORT_H
@@ -0,0 +1,89 @@
+#ifndef PATHTABLE_H
+#define PATHTABLE_H
+
+#include <QHash>
+#include <QMetaType>
+#include <QReadWriteLock>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+// 路径在 PathTable 中的序号
+using PathId = int;
+
+// 紧凑的路径表：目录按前缀树存储（每个目录只记父目录和一段目录名），目录名和文件名去重后只存一份
+// 几百万个文件位于同一个很深的前缀下时，每个路径只占两个整数加一个共享的文件名，
+// 而不是各自一份完整的 UTF-16 字符串；需要时再拼出完整路径
+// 同一路径多次 add 得到同一个序号，序号一旦分配就不会失效（clear 之前），可以放在信号中跨线程传递
+// 一个线程 add 的同时其他线程可以读取（扫描线程写入，界面和统计线程读取）
+class PathTable
+{
+public:
+    static constexpr int kRootDirectory = 0; // 空前缀，相对路径直接挂在它下面
+
+    PathTable();
+
+    PathId add(const QString& path);
+    // 一次加锁添加一批路径
+    QVector<PathId> addAll(const QVector<QString>& paths);
+
+    // 删除全部路径，之前分配的序号全部失效
+    void clear();
+
+    // 已加入的路径的序号，没有时返回 -1，不修改路径表
+    PathId find(const QString& path) const;
+
+    QString path(PathId id) const;
+    // 一次加锁取出一批路径，多个线程同时读取时不必每个文件争一次锁
+    QVector<QString> paths(QVector<PathId>::const_iterator begin, QVector<PathId>::const_iterator end) const;
+    QString fileName(PathId id) const;
+    // 文件所在目录的序号，同一目录下的文件相同
+    int directory(PathId id) const;
+    // 目录的完整路径，以 '/' 结尾，根目录为空字符串
+    QString directoryPath(int directory) const;
+    // 上一级目录的序号，根目录返回 -1
+    int parentDirectory(int directory) const;
+    // 目录自己的名字（路径的最后一段）
+    QString directoryName(int directory) const;
+
+    int size() const;
+    int directoryCount() const;
+
+private:
+    struct Directory
+    {
+        int parent;
+        int name; // names_ 中的序号
+    };
+    struct Entry
+    {
+        int directory;
+        int name;
+    };
+
+    static quint64 key(int a, int b) { return (quint64(quint32(a)) << 32) | quint32(b); }
+
+    // 以下函数要求调用方已持有锁
+    PathId addLocked(const QString& path);
+    int internName(const QString& name);
+    int directoryForLocked(const QString& dirPath);
+    int findDirectoryLocked(QStringView dirPath) const;
+    void appendDirectoryPath(int directory, QString& out) const;
+    QString pathLocked(PathId id) const;
+
+    mutable QReadWriteLock lock_;
+    QVector<QString> names_;             // 目录名和文件名共用的字符串池
+    QHash<QString, int> nameIds_;        // 与 names_ 隐式共享字符串数据
+    QVector<Directory> directories_;
+    QHash<quint64, int> childDirectories_; // (父目录, 目录名) -> 目录序号
+    QVector<Entry> entries_;
+    QHash<quint64, PathId> entryIds_;    // (目录, 文件名) -> 路径序号
+    // 扫描时同一目录的文件连续出现，记住上一个目录可以跳过逐段查找
+    QString lastDirectoryPath_;
+    int lastDirectory_ = kRootDirectory;
+};
+
+// 重新扫描时换用新的路径表，通过排队的信号交给各个线程
+Q_DECLARE_METATYPE(QSharedPointer<PathTable>)
+
+#endif // PATHTABLE_H
@@ -0,0 +1,116 @@
+#include "qualitypanel.h"
+#include <QFile>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QJsonDocument>
+#include <QMessageBox>
+#include <QVBoxLayout>
+
+QualityPanel::QualityPanel(QWidget *parent)
+    : QWidget(parent)
+{
+    QVBoxLayout* layout = new QVBoxLayout(this);
+
+    QHBoxLayout* topLayout = new QHBoxLayout();
+    labelSummary = new QLabel(this);
+    btnExport = new QPushButton("导出报告", this);
+    topLayout->addWidget(labelSummary);
+    topLayout->addStretch();
+    topLayout->addWidget(btnExport);
+    layout->addLayout(topLayout);
+
+    issueTable = new QTableWidget(0, 2, this);
+    issueTable->setHorizontalHeaderLabels(QStringList() << "问题" << "次数");
+    issueTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    issueTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    issueTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    issueTable->setSelectionMode(QAbstractItemView::SingleSelection);
+
+    sampleTable = new QTableWidget(0, 2, this);
+    sampleTable->setHorizontalHeaderLabels(QStringList() << "文件" << "说明");
+    sampleTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    sampleTable->horizontalHeader()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
+    sampleTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    QHBoxLayout* tablesLayout = new QHBoxLayout();
+    tablesLayout->addWidget(issueTable, 1);
+    tablesLayout->addWidget(sampleTable, 2);
+    layout->addLayout(tablesLayout);
+
+    connect(issueTable, &QTableWidget::itemSelectionChanged, this, &QualityPanel::showSelectedSamples);
+    connect(btnExport, &QPushButton::clicked, this, &QualityPanel::exportReport);
+    clear();
+}
+
+void QualityPanel::setReport(const ParseReport& report, int fileCount)
+{
+    report_ = report;
+
+    const QSignalBlocker blocker(issueTable);
+    issueTable->setRowCount(0);
+    for (int i = 0; i < ParseReport::IssueCount; ++i) {
+        const auto issue = ParseReport::Issue(i);
+        if (report_.count(issue) == 0) {
+            continue;
+        }
+        const int row = issueTable->rowCount();
+        issueTable->insertRow(row);
+        QTableWidgetItem* nameItem = new QTableWidgetItem(ParseReport::issueLabel(issue));
+        nameItem->setData(Qt::UserRole, i);
+        QTableWidgetItem* countItem = new QTableWidgetItem(QString::number(report_.count(issue)));
+        countItem->setTextAlignment(Qt::AlignCenter);
+        issueTable->setItem(row, 0, nameItem);
+        issueTable->setItem(row, 1, countItem);
+    }
+
+    if (report_.isEmpty()) {
+        labelSummary->setText(fileCount > 0 ? QString("%1 个文件中没有发现问题").arg(fileCount) : QString("尚未统计"));
+    } else {
+        labelSummary->setText(QString("%1 个文件中共发现 %2 处问题，每类最多保留 %3 个样本")
+                              .arg(fileCount).arg(report_.issueCount()).arg(ParseReport::kMaxSamples));
+    }
+    btnExport->setEnabled(!report_.isEmpty());
+    if (issueTable->rowCount() > 0) {
+        issueTable->selectRow(0);
+    }
+    showSelectedSamples();
+}
+
+void QualityPanel::clear()
+{
+    setReport(ParseReport(), 0);
+}
+
+void QualityPanel::showSelectedSamples()
+{
+    sampleTable->setRowCount(0);
+    const int row = issueTable->currentRow();
+    if (row < 0 || !issueTable->item(row, 0)) {
+        return;
+    }
+    const auto issue = ParseReport::Issue(issueTable->item(row, 0)->data(Qt::UserRole).toInt());
+    const QVector<ParseReport::Sample>& samples = report_.samples(issue);
+    sampleTable->setRowCount(samples.size());
+    for (int i = 0; i < samples.size(); ++i) {
+        sampleTable->setItem(i, 0, new QTableWidgetItem(samples[i].filePath));
+        sampleTable->setItem(i, 1, new QTableWidgetItem(samples[i].detail));
+    }
+}
+
+void QualityPanel::exportReport()
+{
+    QString selectedFilter;
+    const QString path = QFileDialog::getSaveFileName(this, "导出数据质量报告", "quality_report.csv",
+                                                      "CSV 文件 (*.csv);;JSON 文件 (*.json)", &selectedFilter);
+    if (path.isEmpty()) {
+        return;
+    }
+    const bool json = path.endsWith(".json", Qt::CaseInsensitive) || selectedFilter.contains("json");
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QMessageBox::warning(this, "警告", "无法写入文件：" + file.errorString());
+        return;
+    }
+    file.write(json ? QJsonDocument(report_.toJson()).toJson(QJsonDocument::Indented) : report_.toCsv());
+}
@@ -0,0 +1,35 @@
+#ifndef QUALITYPANEL_H
+#define QUALITYPANEL_H
+
+#include <QWidget>
+#include <QLabel>
+#include <QPushButton>
+#include <QTableWidget>
+#include "parsereport.h"
+
+// "数据质量" 结果面板：每类问题的次数，选中一类后显示它的样本，可以导出为 CSV 或 JSON
+class QualityPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit QualityPanel(QWidget *parent = nullptr);
+
+    // fileCount 为本次统计的文件数，只用于摘要
+    void setReport(const ParseReport& report, int fileCount);
+    void clear();
+
+private slots:
+    void showSelectedSamples();
+    void exportReport();
+
+private:
+    ParseReport report_;
+
+    QLabel *labelSummary = nullptr;
+    QPushButton *btnExport = nullptr;
+    QTableWidget *issueTable = nullptr;  // 问题, 次数；只列出出现过的问题
+    QTableWidget *sampleTable = nullptr; // 文件, 说明
+};
+
+#endif // QUALITYPANEL_H
@@ -0,0 +1,102 @@
+#include "querypanel.h"
+#include <QElapsedTimer>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QMessageBox>
+#include <QVBoxLayout>
+
+QueryPanel::QueryPanel(QWidget *parent)
+    : QWidget(parent)
+{
+    QVBoxLayout* layout = new QVBoxLayout(this);
+
+    QHBoxLayout* queryLayout = new QHBoxLayout();
+    queryEdit = new QLineEdit(this);
+    queryEdit->setPlaceholderText("例如：objects > 25、has(person) and not has(dog)、minside < 16");
+    queryEdit->setToolTip("条件：objects / width / height / count(标签) / minside[(标签)] / maxside[(标签)] 与 < <= > >= = != 比较，"
+                          "has(标签)；\n用 and / or / not 和括号组合，标签名含空格时用双引号括起来");
+    btnRun = new QPushButton("筛选", this);
+    btnExport = new QPushButton("导出路径列表", this);
+    queryLayout->addWidget(queryEdit);
+    queryLayout->addWidget(btnRun);
+    queryLayout->addWidget(btnExport);
+    layout->addLayout(queryLayout);
+
+    labelResult = new QLabel(this);
+    layout->addWidget(labelResult);
+
+    resultList = new QListWidget(this);
+    resultList->setUniformItemSizes(true);
+    layout->addWidget(resultList);
+
+    connect(queryEdit, &QLineEdit::returnPressed, this, &QueryPanel::runQuery);
+    connect(btnRun, &QPushButton::clicked, this, &QueryPanel::runQuery);
+    connect(btnExport, &QPushButton::clicked, this, &QueryPanel::exportPathList);
+    clear();
+}
+
+void QueryPanel::setStats(const DatasetStats& stats)
+{
+    store_ = stats.store;
+    index_ = stats.index;
+    paths_ = stats.paths;
+    images_ = stats.images;
+    matches_.clear();
+    resultList->clear();
+    const bool ready = store_ && index_ && paths_;
+    btnRun->setEnabled(ready);
+    btnExport->setEnabled(false);
+    labelResult->setText(ready ? QString("共 %1 张图片，输入条件后按回车筛选").arg(store_->fileCount())
+                               : QString("统计完成后可以筛选图片"));
+}
+
+void QueryPanel::clear()
+{
+    setStats(DatasetStats());
+}
+
+void QueryPanel::runQuery()
+{
+    if (!store_ || !index_ || !paths_) {
+        return;
+    }
+    AnnotationQuery query;
+    QString error;
+    if (!query.parse(queryEdit->text(), &error)) {
+        labelResult->setText("表达式错误，" + error);
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    matches_ = query.run(*store_, *index_);
+    const qint64 ms = timer.elapsed();
+
+    resultList->clear();
+    const int listed = qMin<qsizetype>(matches_.size(), kMaxListed);
+    QStringList lines;
+    lines.reserve(listed);
+    for (int i = 0; i < listed; ++i) {
+        lines << paths_->path(images_[matches_[i]]);
+    }
+    resultList->addItems(lines);
+
+    QString text = QString("匹配 %1 / %2 张图片，用时 %3 ms").arg(matches_.size()).arg(store_->fileCount()).arg(ms);
+    if (matches_.size() > listed) {
+        text += QString("，列表只显示前 %1 张").arg(listed);
+    }
+    labelResult->setText(text);
+    btnExport->setEnabled(!matches_.isEmpty());
+}
+
+void QueryPanel::exportPathList()
+{
+    const QString path = QFileDialog::getSaveFileName(this, "导出路径列表", "filtered.txt", "文本文件 (*.txt)");
+    if (path.isEmpty()) {
+        return;
+    }
+    QString error;
+    if (!AnnotationQuery::writePathList(path, *paths_, images_, matches_, &error)) {
+        QMessageBox::warning(this, "警告", "无法写入文件：" + error);
+    }
+}
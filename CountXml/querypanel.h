@@ -0,0 +1,44 @@
+#ifndef QUERYPANEL_H
+#define QUERYPANEL_H
+
+#include <QWidget>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QPushButton>
+#include <QSharedPointer>
+#include "datasetstats.h"
+
+// "筛选图片" 结果面板：输入筛选表达式（语法见 AnnotationQuery），列出匹配的图片并导出为路径列表
+class QueryPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kMaxListed = 1000; // 列表中最多显示的图片数，导出不受限制
+
+    explicit QueryPanel(QWidget *parent = nullptr);
+
+    // 使用新的统计结果，之前的筛选结果清空
+    void setStats(const DatasetStats& stats);
+    void clear();
+
+private slots:
+    void runQuery();
+    void exportPathList();
+
+private:
+    QSharedPointer<const AnnotationStore> store_;
+    QSharedPointer<const AnnotationIndex> index_;
+    QSharedPointer<const PathTable> paths_;
+    QVector<PathId> images_;
+    QVector<int> matches_; // 最近一次筛选结果（文件序号）
+
+    QLineEdit *queryEdit = nullptr;
+    QPushButton *btnRun = nullptr;
+    QPushButton *btnExport = nullptr;
+    QLabel *labelResult = nullptr;
+    QListWidget *resultList = nullptr;
+};
+
+#endif // QUERYPANEL_H
@@ -1,14 +1,156 @@
 #include "vocParser.h"
+#include "annotationstore.h"
+
+namespace {
+
+// 流式解析的输出：追加到 QList<VocObject>
+struct ListSink
+{
+    QList<VocObject>& objectsList;
+    void add(const VocObject& obj) { objectsList.append(obj); }
+    void addUtf8(const char* name, int length, int xmin, int ymin, int xmax, int ymax)
+    {
+        objectsList.append({QString::fromUtf8(name, length), QRect(xmin, ymin, xmax - xmin + 1, ymax - ymin + 1)});
+    }
+    void setImageSize(int, int) {}
+};
+
+// 流式解析的输出：直接写入列存储，不保留 VocObject
+struct StoreSink
+{
+    AnnotationStore& store;
+    int added = 0;
+    void add(const VocObject& obj)
+    {
+        store.addBox(store.internLabel(obj.name),
+                     obj.bndbox.left(), obj.bndbox.top(), obj.bndbox.right(), obj.bndbox.bottom());
+        ++added;
+    }
+    void addUtf8(const char* name, int length, int xmin, int ymin, int xmax, int ymax)
+    {
+        store.addBox(store.internLabelUtf8(name, length), xmin, ymin, xmax, ymax);
+        ++added;
+    }
+    void setImageSize(int width, int height) { store.setImageSize(width, height); }
+};
+
+} // namespace
 
 
 QList<VocObject> VocParser::parseObjects(const QString& filePath)
 {
     QList<VocObject> objectsList;
+    ListSink sink{objectsList};
+    pendingIssues_.clear();
+    if (backend_ == Backend::Fast && parseFast(filePath, sink)) {
+        return objectsList;
+    }
+    const bool ok = backend_ == Backend::Dom ? parseDom(filePath, sink) : parseStream(filePath, sink);
+    if (!ok) {
+        return QList<VocObject>(); // 返回空列表
+    }
+    commitIssues(filePath);
+    return objectsList;
+}
+
+int VocParser::parseInto(const QString& filePath, AnnotationStore& store)
+{
+    StoreSink sink{store};
+    pendingIssues_.clear();
+    if (backend_ == Backend::Fast && parseFast(filePath, sink)) {
+        return sink.added;
+    }
+    const bool ok = backend_ == Backend::Dom ? parseDom(filePath, sink) : parseStream(filePath, sink);
+    if (!ok) {
+        store.rollbackFile(); // 和 DOM 一样，格式错误的文件不计入任何对象，也不记对象级的问题
+        return 0;
+    }
+    commitIssues(filePath);
+    return sink.added;
+}
+
+QRect VocParser::makeBndbox(int xmin, int ymin, int xmax, int ymax)
+{
+    if (xmax < xmin || ymax < ymin) { // 基本的有效性检查
+        return QRect(); // 设置为无效矩形
+    }
+    // QRect 构造函数是 (left, top, width, height)
+    return QRect(xmin, ymin, xmax - xmin + 1, ymax - ymin + 1);
+}
 
+bool VocParser::acceptObject(const VocObject& obj, bool hasBndbox)
+{
+    // 只有当 name 和 bndbox 都有效时才添加，有效对象不做任何额外的工作
+    if (!obj.name.isEmpty() && obj.bndbox.isValid() && obj.bndbox.width() > 0 && obj.bndbox.height() > 0) {
+        return true;
+    }
+    if (!report_) {
+        return false;
+    }
+    if (obj.name.isEmpty()) {
+        pendingIssues_.append({ParseReport::MissingName, QString()});
+    } else if (!hasBndbox) {
+        pendingIssues_.append({ParseReport::MissingBndbox, obj.name});
+    } else {
+        pendingIssues_.append({ParseReport::InvalidBndbox, obj.name});
+    }
+    return false;
+}
+
+void VocParser::commitIssues(const QString& filePath)
+{
+    for (const PendingIssue& pending : std::as_const(pendingIssues_)) {
+        note(pending.issue, filePath, pending.detail);
+    }
+    pendingIssues_.clear();
+}
+
+void VocParser::noteMalformed(const QString& filePath, const QString& reason, qint64 line, qint64 column)
+{
+    if (!report_) {
+        return;
+    }
+    report_->add(ParseReport::MalformedFile, filePath,
+                 report_->wantsSample(ParseReport::MalformedFile)
+                     ? QString("第 %1 行第 %2 列：%3").arg(line).arg(column).arg(reason) : QString());
+}
+
+template <typename Sink>
+bool VocParser::parseFast(const QString& filePath, Sink& sink)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false; // 由通用解析器报告错误
+    }
+
+    const char* data = nullptr;
+    qint64 size = file.size();
+    const uchar* mapped = size > 0 ? file.map(0, size) : nullptr;
+    if (mapped) {
+        data = reinterpret_cast<const char*>(mapped);
+    } else {
+        readBuffer_ = file.readAll();
+        data = readBuffer_.constData();
+        size = readBuffer_.size();
+    }
+
+    if (!fastScanner_.scan(data, size)) {
+        return false;
+    }
+    sink.setImageSize(fastScanner_.imageWidth(), fastScanner_.imageHeight());
+    for (const VocFastScanner::Box& box : fastScanner_.boxes()) {
+        sink.addUtf8(box.name, box.nameLength, box.xmin, box.ymin, box.xmax, box.ymax);
+    }
+    return true; // file 析构时解除映射，此后 boxes 中的名字指针失效
+}
+
+template <typename Sink>
+bool VocParser::parseDom(const QString& filePath, Sink& sink)
+{
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qWarning() << "Error: Cannot open XML file:" << filePath << file.errorString();
-        return objectsList; // 返回空列表
+        note(ParseReport::CannotOpen, filePath, file.errorString());
+        return false;
     }
 
     QDomDocument doc;
@@ -16,17 +158,21 @@ QList<VocObject> VocParser::parseObjects(const QString& filePath)
     int errorLine, errorColumn;
     if (!doc.setContent(&file, &errorMsg, &errorLine, &errorColumn))
     {
-        qWarning() << "Error: Failed to parse XML file:" << filePath
-                   << "Reason:" << errorMsg << "at line" << errorLine << "column" << errorColumn;
+        noteMalformed(filePath, errorMsg, errorLine, errorColumn);
         file.close();
-        return objectsList; // 返回空列表
+        return false;
     }
     file.close();
 
     QDomElement root = doc.documentElement(); // <annotation>
     if (root.tagName() != "annotation") {
-        qWarning() << "Error: XML root element is not <annotation> in file:" << filePath;
-        return objectsList; // 返回空列表
+        note(ParseReport::WrongRoot, filePath, root.tagName());
+        return false;
+    }
+
+    QDomElement sizeElement = root.firstChildElement("size");
+    if (!sizeElement.isNull()) {
+        sink.setImageSize((int)getElementFloat(sizeElement, "width"), (int)getElementFloat(sizeElement, "height"));
     }
 
     QDomNodeList objectNodes = root.elementsByTagName("object");
@@ -43,28 +189,146 @@ QList<VocObject> VocParser::parseObjects(const QString& filePath)
             int ymin = (int)getElementFloat(bndboxElement, "ymin");
             int xmax = (int)getElementFloat(bndboxElement, "xmax");
             int ymax = (int)getElementFloat(bndboxElement, "ymax");
+            obj.bndbox = makeBndbox(xmin, ymin, xmax, ymax);
+        } else {
+            obj.bndbox = QRect(); // 无效矩形
+        }
+
+        if (acceptObject(obj, !bndboxElement.isNull())) {
+            sink.add(obj);
+        }
+    }
+
+    return true;
+}
+
+template <typename Sink>
+bool VocParser::parseStream(const QString& filePath, Sink& sink)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        note(ParseReport::CannotOpen, filePath, file.errorString());
+        return false;
+    }
 
-            if (xmax < xmin || ymax < ymin) { // 基本的有效性检查
-                qWarning() << "Warning: Invalid bndbox coordinates (xmax < xmin or ymax < ymin) in" << filePath << "for object" << obj.name;
-                obj.bndbox = QRect(); // 设置为无效矩形
+    QXmlStreamReader reader(&file);
+    if (reader.readNextStartElement()) {
+        if (reader.name() != QLatin1String("annotation")) {
+            note(ParseReport::WrongRoot, filePath, reader.name().toString());
+            return false;
+        }
+        // <annotation> 的直接子元素中取图片宽高，其余和 scanForObjects 相同
+        while (reader.readNextStartElement()) {
+            if (reader.name() == QLatin1String("object")) {
+                readObject(reader, filePath, sink);
+            } else if (reader.name() == QLatin1String("size")) {
+                int width = 0, height = 0;
+                readImageSize(reader, width, height);
+                sink.setImageSize(width, height);
             } else {
-                // QRect 构造函数是 (left, top, width, height)
-                obj.bndbox = QRect(xmin, ymin, xmax - xmin + 1, ymax - ymin + 1);
+                scanForObjects(reader, filePath, sink);
             }
+        }
+    }
+
+    // 读完剩余内容，保证和 DOM 一样只接受格式完整的文件
+    while (!reader.atEnd()) {
+        reader.readNext();
+    }
+    if (reader.hasError()) {
+        noteMalformed(filePath, reader.errorString(), reader.lineNumber(), reader.columnNumber());
+        return false;
+    }
+
+    return true;
+}
+
+template <typename Sink>
+void VocParser::scanForObjects(QXmlStreamReader& reader, const QString& filePath, Sink& sink)
+{
+    while (reader.readNextStartElement()) {
+        if (reader.name() == QLatin1String("object")) {
+            readObject(reader, filePath, sink);
         } else {
-            qWarning() << "Warning: <bndbox> not found for an object named '" << obj.name << "' in" << filePath;
-            obj.bndbox = QRect(); // 无效矩形
+            scanForObjects(reader, filePath, sink);
         }
+    }
+}
+
+template <typename Sink>
+void VocParser::readObject(QXmlStreamReader& reader, const QString& filePath, Sink& sink)
+{
+    VocObject obj;
+    bool hasName = false;
+    bool hasBndbox = false;
+    int xmin = 0, ymin = 0, xmax = 0, ymax = 0;
+    QList<VocObject> nestedObjects; // 嵌套的 <object> 在 DOM 先序遍历中排在外层之后
+    ListSink nestedSink{nestedObjects};
 
-        // 只有当 name 和 bndbox 都有效时才添加 (可选，根据需求)
-        if (!obj.name.isEmpty() && obj.bndbox.isValid() && obj.bndbox.width() > 0 && obj.bndbox.height() > 0) {
-            objectsList.append(obj);
-        } else if (!obj.name.isEmpty()) {
-            // 如果name有效但bndbox无效，你可能还是想记录这个物体，只是框是无效的
-            // objectsList.append(obj); // 取决于你的需求
-            qWarning() << "Warning: Object '" << obj.name << "' in" << filePath << " has an invalid or missing bndbox.";
+    while (reader.readNextStartElement()) {
+        if (!hasName && reader.name() == QLatin1String("name")) {
+            obj.name = reader.readElementText(QXmlStreamReader::IncludeChildElements).trimmed();
+            hasName = true;
+        } else if (!hasBndbox && reader.name() == QLatin1String("bndbox")) {
+            readBndbox(reader, xmin, ymin, xmax, ymax);
+            hasBndbox = true;
+        } else if (reader.name() == QLatin1String("object")) {
+            readObject(reader, filePath, nestedSink);
+        } else {
+            scanForObjects(reader, filePath, nestedSink);
         }
     }
+    if (reader.hasError()) {
+        return; // 由 parseStream 统一报告
+    }
 
-    return objectsList;
+    if (hasBndbox) {
+        obj.bndbox = makeBndbox(xmin, ymin, xmax, ymax);
+    }
+    if (acceptObject(obj, hasBndbox)) {
+        sink.add(obj);
+    }
+    for (const VocObject& nested : std::as_const(nestedObjects)) {
+        sink.add(nested);
+    }
+}
+
+void VocParser::readBndbox(QXmlStreamReader& reader, int& xmin, int& ymin, int& xmax, int& ymax)
+{
+    bool hasXmin = false, hasYmin = false, hasXmax = false, hasYmax = false;
+    while (reader.readNextStartElement()) {
+        const QStringView tag = reader.name();
+        if (!hasXmin && tag == QLatin1String("xmin")) {
+            xmin = (int)toFloatOrZero(reader.readElementText(QXmlStreamReader::IncludeChildElements));
+            hasXmin = true;
+        } else if (!hasYmin && tag == QLatin1String("ymin")) {
+            ymin = (int)toFloatOrZero(reader.readElementText(QXmlStreamReader::IncludeChildElements));
+            hasYmin = true;
+        } else if (!hasXmax && tag == QLatin1String("xmax")) {
+            xmax = (int)toFloatOrZero(reader.readElementText(QXmlStreamReader::IncludeChildElements));
+            hasXmax = true;
+        } else if (!hasYmax && tag == QLatin1String("ymax")) {
+            ymax = (int)toFloatOrZero(reader.readElementText(QXmlStreamReader::IncludeChildElements));
+            hasYmax = true;
+        } else {
+            reader.skipCurrentElement();
+        }
+    }
+}
+
+void VocParser::readImageSize(QXmlStreamReader& reader, int& width, int& height)
+{
+    bool hasWidth = false, hasHeight = false;
+    while (reader.readNextStartElement()) {
+        const QStringView tag = reader.name();
+        if (!hasWidth && tag == QLatin1String("width")) {
+            width = (int)toFloatOrZero(reader.readElementText(QXmlStreamReader::IncludeChildElements));
+            hasWidth = true;
+        } else if (!hasHeight && tag == QLatin1String("height")) {
+            height = (int)toFloatOrZero(reader.readElementText(QXmlStreamReader::IncludeChildElements));
+            hasHeight = true;
+        } else {
+            reader.skipCurrentElement();
+        }
+    }
 }
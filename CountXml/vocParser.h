@@ -3,9 +3,15 @@
 
 #include <QString>
 #include <QDomDocument>
+#include <QXmlStreamReader>
 #include <QFile>
 #include <QDebug>
 #include <QRect>
+#include <QVector>
+#include "vocfastscanner.h"
+#include "parsereport.h"
+
+class AnnotationStore;
 
 struct VocObject
 {
@@ -16,11 +22,84 @@ struct VocObject
 class VocParser
 {
 public:
+    // 解析后端：Stream 为单次前向的 QXmlStreamReader 拉取解析，不构建 DOM 树；
+    // Dom 为原来的 QDomDocument 实现，保留用于对比和排查问题；
+    // Fast 把文件映射到内存后直接扫描字节（见 VocFastScanner），不符合常见形态的文件自动改用 Stream
+    enum class Backend
+    {
+        Stream,
+        Dom,
+        Fast
+    };
+
     VocParser(){}
+    explicit VocParser(Backend backend) : backend_(backend) {}
+
+    void setBackend(Backend backend) { backend_ = backend; }
+    Backend backend() const { return backend_; }
+    // 之后发现的数据质量问题记到 report 中，为空时不记录
+    void setReport(ParseReport* report) { report_ = report; }
 
     QList<VocObject> parseObjects(const QString& filePath);
+    // 把有效的对象和 <size> 中的图片宽高直接写入 store 当前的文件中（调用方先 beginFile），返回追加的对象数
+    // 文件无法读取或格式错误时不追加任何对象
+    int parseInto(const QString& filePath, AnnotationStore& store);
 
 private:
+    // 内存映射 + 字节扫描，文件不符合预期形态时返回 false 且不向 sink 输出任何内容
+    template <typename Sink>
+    bool parseFast(const QString& filePath, Sink& sink);
+    // DOM 解析整个文件，每个有效对象交给 sink.add，返回文件是否格式正确
+    template <typename Sink>
+    bool parseDom(const QString& filePath, Sink& sink);
+    // 流式解析整个文件，每个有效对象交给 sink.add，返回文件是否格式正确
+    template <typename Sink>
+    bool parseStream(const QString& filePath, Sink& sink);
+
+    // 流式解析：在当前元素内查找 <object>（任意深度，顺序与 elementsByTagName 一致）
+    template <typename Sink>
+    void scanForObjects(QXmlStreamReader& reader, const QString& filePath, Sink& sink);
+    // 流式解析：读取一个 <object> 元素（reader 位于其 StartElement）
+    template <typename Sink>
+    void readObject(QXmlStreamReader& reader, const QString& filePath, Sink& sink);
+    // 流式解析：读取 <bndbox> 下的四个坐标，缺失或无法转换的坐标按 0 处理
+    void readBndbox(QXmlStreamReader& reader, int& xmin, int& ymin, int& xmax, int& ymax);
+    // 流式解析：读取 <size> 下的 width/height，缺失或无法转换时按 0（未知）处理
+    void readImageSize(QXmlStreamReader& reader, int& width, int& height);
+    // 和 DOM 实现一致：对文本 trim 后转 float，转换失败按 0 处理
+    static float toFloatOrZero(const QString& text)
+    {
+        bool ok;
+        float value = text.trimmed().toFloat(&ok);
+        return ok ? value : 0;
+    }
+
+    // 有效性检查，两个后端共用；无效的对象先暂存，文件解析成功后由 commitIssues 记到 report_ 中
+    static QRect makeBndbox(int xmin, int ymin, int xmax, int ymax);
+    bool acceptObject(const VocObject& obj, bool hasBndbox);
+    // 流式解析边读边检查对象，读到后面才可能发现文件格式错误；格式错误的文件整体回滚，
+    // 只记 MalformedFile，与 DOM 后端的统计一致
+    void commitIssues(const QString& filePath);
+    void note(ParseReport::Issue issue, const QString& filePath, const QString& detail = QString())
+    {
+        if (report_) {
+            report_->add(issue, filePath, detail);
+        }
+    }
+    // 文件级错误的说明，只在需要样本时才格式化
+    void noteMalformed(const QString& filePath, const QString& reason, qint64 line, qint64 column);
+
+    Backend backend_ = Backend::Stream;
+    ParseReport* report_ = nullptr;
+    struct PendingIssue
+    {
+        ParseReport::Issue issue;
+        QString detail;
+    };
+    QVector<PendingIssue> pendingIssues_; // 当前文件中无效的对象
+    VocFastScanner fastScanner_;
+    QByteArray readBuffer_; // 无法映射文件时（如空文件、部分网络文件系统）改为整体读入
+
     // 辅助函数，用于获取指定标签名下的文本内容
     QString getElementText(const QDomElement& parentElement, const QString& tagName)
     {
@@ -0,0 +1,585 @@
+#include "vocfastscanner.h"
+#include <QChar>
+#include <QtAlgorithms>
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COUNTXML_FAST_SSE2 1
+#endif
+
+namespace {
+
+constexpr int kMaxDepth = 64;
+constexpr int kMaxIntegerDigits = 9;
+constexpr int kMaxFractionDigits = 6;
+
+// 元素在 VOC 结构中的作用，决定它的子元素和文本如何处理
+enum class Role : quint8
+{
+    Root,       // <annotation>
+    Other,      // 其他元素，其中任意深度的 <object> 仍然有效
+    Skip,       // 通用解析器整体跳过的元素（<bndbox>/<size> 下的未知子元素）
+    Size,       // <annotation> 下的 <size>
+    Dim,        // <size> 下的 <width>/<height>
+    Object,     // <object>
+    InObject,   // <object> 下的其他元素
+    ObjectName, // <object> 下的第一个 <name>
+    Bndbox,     // <object> 下的第一个 <bndbox>
+    Coord       // <bndbox> 下的 xmin/ymin/xmax/ymax
+};
+
+struct Element
+{
+    const char* name;
+    int length;
+    Role role;
+    int field; // Dim/Coord 对应的值下标
+};
+
+inline bool isXmlSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline bool isNameStart(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':';
+}
+
+inline bool isNameChar(char c)
+{
+    return isNameStart(c) || (c >= '0' && c <= '9') || c == '-' || c == '.';
+}
+
+inline bool nameIs(const char* name, int length, const char* literal)
+{
+    const int literalLength = int(std::strlen(literal));
+    return length == literalLength && std::memcmp(name, literal, size_t(length)) == 0;
+}
+
+// 找到下一个需要处理的字节：'<'、'&'、非 ASCII 字节，或除 \t \n \r 之外的控制字符
+const char* findSpecial(const char* p, const char* end)
+{
+#ifdef COUNTXML_FAST_SSE2
+    const __m128i lt = _mm_set1_epi8('<');
+    const __m128i amp = _mm_set1_epi8('&');
+    const __m128i space = _mm_set1_epi8(0x20);
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    while (end - p >= 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        // 有符号比较：小于 0x20 的控制字符和 >= 0x80 的字节（视为负数）都会命中
+        const __m128i allowedControl = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, tab), _mm_cmpeq_epi8(v, lf)),
+                                                    _mm_cmpeq_epi8(v, cr));
+        const __m128i control = _mm_andnot_si128(allowedControl, _mm_cmplt_epi8(v, space));
+        const __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, lt), _mm_cmpeq_epi8(v, amp)), control);
+        const int mask = _mm_movemask_epi8(hit);
+        if (mask != 0) {
+            return p + qCountTrailingZeroBits(quint32(mask));
+        }
+        p += 16;
+    }
+#endif
+    for (; p < end; ++p) {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        if (c == '<' || c == '&' || c >= 0x80 || (c < 0x20 && c != '\t' && c != '\n' && c != '\r')) {
+            return p;
+        }
+    }
+    return end;
+}
+
+// 解码一个 UTF-8 字符，非法编码（过长编码、代理区、超出范围）返回 nullptr
+const char* decodeUtf8(const char* p, const char* end, char32_t& codePoint)
+{
+    const unsigned char c = static_cast<unsigned char>(*p);
+    int length = 0;
+    char32_t min = 0;
+    if (c < 0x80) {
+        codePoint = c;
+        return p + 1;
+    } else if ((c & 0xE0) == 0xC0) {
+        length = 2; codePoint = c & 0x1F; min = 0x80;
+    } else if ((c & 0xF0) == 0xE0) {
+        length = 3; codePoint = c & 0x0F; min = 0x800;
+    } else if ((c & 0xF8) == 0xF0) {
+        length = 4; codePoint = c & 0x07; min = 0x10000;
+    } else {
+        return nullptr;
+    }
+    if (end - p < length) {
+        return nullptr;
+    }
+    for (int i = 1; i < length; ++i) {
+        const unsigned char next = static_cast<unsigned char>(p[i]);
+        if ((next & 0xC0) != 0x80) {
+            return nullptr;
+        }
+        codePoint = (codePoint << 6) | (next & 0x3F);
+    }
+    if (codePoint < min || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+        return nullptr;
+    }
+    return p + length;
+}
+
+// 标签名中首尾的 Unicode 空白（如全角空格）会被通用解析器的 trimmed() 去掉，这里不处理
+bool hasUnicodeSpaceAtEdges(const char* name, int length)
+{
+    const char* end = name + length;
+    char32_t codePoint = 0;
+    if (static_cast<unsigned char>(name[0]) >= 0x80) {
+        if (!decodeUtf8(name, end, codePoint) || QChar::isSpace(codePoint)) {
+            return true;
+        }
+    }
+    if (static_cast<unsigned char>(end[-1]) >= 0x80) {
+        const char* last = end - 1;
+        while (last > name && (static_cast<unsigned char>(*last) & 0xC0) == 0x80) {
+            --last;
+        }
+        if (!decodeUtf8(last, end, codePoint) || QChar::isSpace(codePoint)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 读取元素名，p 移到名字之后，返回名字长度，不是合法的 ASCII 名字时返回 0
+int readName(const char*& p, const char* end)
+{
+    const char* begin = p;
+    if (p >= end || !isNameStart(*p)) {
+        return 0;
+    }
+    while (p < end && isNameChar(*p)) {
+        ++p;
+    }
+    return int(p - begin);
+}
+
+// 跳过开始标签中的属性直到 '>' 或 '/>'，属性值中不允许出现 '<'、'&' 和非 ASCII 字节
+bool skipAttributes(const char*& p, const char* end, bool& selfClosing)
+{
+    while (true) {
+        const char* beforeSpace = p;
+        while (p < end && isXmlSpace(*p)) {
+            ++p;
+        }
+        if (p >= end) {
+            return false;
+        }
+        if (*p == '>') {
+            ++p;
+            selfClosing = false;
+            return true;
+        }
+        if (*p == '/') {
+            if (p + 1 >= end || p[1] != '>') {
+                return false;
+            }
+            p += 2;
+            selfClosing = true;
+            return true;
+        }
+        if (p == beforeSpace || readName(p, end) == 0) {
+            return false; // 属性前必须有空白
+        }
+        while (p < end && isXmlSpace(*p)) {
+            ++p;
+        }
+        if (p >= end || *p != '=') {
+            return false;
+        }
+        ++p;
+        while (p < end && isXmlSpace(*p)) {
+            ++p;
+        }
+        if (p >= end || (*p != '"' && *p != '\'')) {
+            return false;
+        }
+        const char quote = *p++;
+        while (p < end && *p != quote) {
+            const unsigned char c = static_cast<unsigned char>(*p);
+            if (c == '<' || c == '&' || c >= 0x80 || c < 0x20) {
+                return false;
+            }
+            ++p;
+        }
+        if (p >= end) {
+            return false;
+        }
+        ++p;
+    }
+}
+
+// 处理文档开头的 <?xml ...?> 声明，只接受 UTF-8 编码（或不声明编码）
+bool checkDeclaration(const char* begin, const char* end)
+{
+    static const char kEncoding[] = "encoding";
+    const char* found = std::search(begin, end, kEncoding, kEncoding + sizeof(kEncoding) - 1);
+    if (found == end) {
+        return true;
+    }
+    const char* p = found + sizeof(kEncoding) - 1;
+    while (p < end && (isXmlSpace(*p) || *p == '=')) {
+        ++p;
+    }
+    if (p >= end || (*p != '"' && *p != '\'')) {
+        return false;
+    }
+    const char quote = *p++;
+    const char* value = p;
+    while (p < end && *p != quote) {
+        ++p;
+    }
+    const int length = int(p - value);
+    if (length != 5 && length != 4) {
+        return false;
+    }
+    char lower[5];
+    for (int i = 0; i < length; ++i) {
+        lower[i] = char(value[i] | 0x20);
+    }
+    return (length == 5 && std::memcmp(lower, "utf-8", 5) == 0)
+           || (length == 4 && std::memcmp(lower, "utf8", 4) == 0);
+}
+
+// 和通用解析器一致：去掉首尾空白后按 float 转换再截断为 int，空文本为 0
+// 只接受 [+-]数字[.数字] 的简单形式，其余（指数、过长的数字等）返回 false
+bool parseNumber(const char* p, const char* end, int& value)
+{
+    while (p < end && isXmlSpace(*p)) {
+        ++p;
+    }
+    while (end > p && isXmlSpace(end[-1])) {
+        --end;
+    }
+    if (p == end) {
+        value = 0;
+        return true;
+    }
+
+    bool negative = false;
+    if (*p == '+' || *p == '-') {
+        negative = *p == '-';
+        ++p;
+    }
+    qint64 integer = 0;
+    int integerDigits = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        integer = integer * 10 + (*p - '0');
+        ++p;
+        if (++integerDigits > kMaxIntegerDigits) {
+            return false;
+        }
+    }
+    qint64 fraction = 0;
+    int fractionDigits = 0;
+    if (p < end && *p == '.') {
+        ++p;
+        while (p < end && *p >= '0' && *p <= '9') {
+            fraction = fraction * 10 + (*p - '0');
+            ++p;
+            if (++fractionDigits > kMaxFractionDigits) {
+                return false;
+            }
+        }
+    }
+    if (p != end || integerDigits + fractionDigits == 0) {
+        return false;
+    }
+
+    static const double kPow10[kMaxFractionDigits + 1] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6};
+    double number = double(integer) + double(fraction) / kPow10[fractionDigits];
+    if (negative) {
+        number = -number;
+    }
+    value = int(float(number)); // 先舍入到 float，与 QString::toFloat 的结果一致
+    return true;
+}
+
+} // namespace
+
+bool VocFastScanner::scan(const char* data, qsizetype size)
+{
+    boxes_.clear();
+    imageWidth_ = 0;
+    imageHeight_ = 0;
+
+    const char* p = data;
+    const char* const end = data + size;
+    if (size >= 3 && std::memcmp(p, "\xEF\xBB\xBF", 3) == 0) {
+        p += 3; // UTF-8 BOM
+    }
+    const char* const documentStart = p;
+
+    Element stack[kMaxDepth];
+    int depth = 0;
+    bool rootClosed = false;
+    const char* textBegin = nullptr; // 当前文本元素（name/坐标/宽高）的内容起点
+
+    // 当前 <object> 的状态
+    const char* objectName = nullptr;
+    int objectNameLength = 0;
+    bool hasName = false;
+    bool hasBndbox = false;
+    int coords[4] = {0, 0, 0, 0};
+    bool hasCoord[4] = {false, false, false, false};
+
+    // 当前 <size> 的状态
+    int dims[2] = {0, 0};
+    bool hasDim[2] = {false, false};
+
+    while (true) {
+        const char* const special = findSpecial(p, end);
+        if (depth == 0) {
+            for (const char* t = p; t < special; ++t) {
+                if (!isXmlSpace(*t)) {
+                    return false; // 根元素之外只能有空白
+                }
+            }
+        }
+        if (special == end) {
+            break;
+        }
+
+        const unsigned char c = static_cast<unsigned char>(*special);
+        if (c != '<') {
+            char32_t codePoint = 0;
+            if (c < 0x80 || depth == 0) {
+                return false; // 实体引用或非法控制字符
+            }
+            p = decodeUtf8(special, end, codePoint);
+            if (!p) {
+                return false;
+            }
+            continue;
+        }
+
+        p = special + 1;
+        if (p >= end) {
+            return false;
+        }
+
+        if (*p == '?') {
+            // 处理指令只接受出现在根元素之外的；<?xml ...?> 声明只能在文档开头
+            if (depth != 0) {
+                return false;
+            }
+            static const char kClose[] = "?>";
+            const char* close = std::search(p, end, kClose, kClose + 2);
+            if (close == end) {
+                return false;
+            }
+            const char* target = p + 1;
+            const int targetLength = readName(target, close);
+            if (targetLength == 3 && (target[-3] | 0x20) == 'x' && (target[-2] | 0x20) == 'm' && (target[-1] | 0x20) == 'l') {
+                if (special != documentStart || !checkDeclaration(target, close)) {
+                    return false;
+                }
+            }
+            p = close + 2;
+            continue;
+        }
+
+        if (*p == '!') {
+            return false; // 注释、CDATA、DOCTYPE 交给通用解析器
+        }
+
+        if (*p == '/') {
+            ++p;
+            const char* name = p;
+            const int length = readName(p, end);
+            while (p < end && isXmlSpace(*p)) {
+                ++p;
+            }
+            if (length == 0 || p >= end || *p != '>' || depth == 0) {
+                return false;
+            }
+            ++p;
+            const Element& element = stack[depth - 1];
+            if (element.length != length || std::memcmp(element.name, name, size_t(length)) != 0) {
+                return false; // 标签不匹配
+            }
+
+            switch (element.role) {
+            case Role::ObjectName: {
+                const char* nameBegin = textBegin;
+                const char* nameEnd = special;
+                while (nameBegin < nameEnd && isXmlSpace(*nameBegin)) {
+                    ++nameBegin;
+                }
+                while (nameEnd > nameBegin && isXmlSpace(nameEnd[-1])) {
+                    --nameEnd;
+                }
+                objectName = nameBegin;
+                objectNameLength = int(nameEnd - nameBegin);
+                if (objectNameLength > 0 && hasUnicodeSpaceAtEdges(objectName, objectNameLength)) {
+                    return false;
+                }
+                break;
+            }
+            case Role::Coord:
+                if (!parseNumber(textBegin, special, coords[element.field])) {
+                    return false;
+                }
+                break;
+            case Role::Dim:
+                if (!parseNumber(textBegin, special, dims[element.field])) {
+                    return false;
+                }
+                break;
+            case Role::Size:
+                // 与通用解析器一致：每个 <size> 都会覆盖之前的宽高，缺失的值为 0
+                imageWidth_ = hasDim[0] ? dims[0] : 0;
+                imageHeight_ = hasDim[1] ? dims[1] : 0;
+                break;
+            case Role::Object:
+                // 无效的对象需要输出警告，交给通用解析器
+                if (objectNameLength == 0 || !hasBndbox || coords[2] < coords[0] || coords[3] < coords[1]) {
+                    return false;
+                }
+                boxes_.append({objectName, objectNameLength, coords[0], coords[1], coords[2], coords[3]});
+                break;
+            default:
+                break;
+            }
+
+            --depth;
+            if (depth == 0) {
+                rootClosed = true;
+            }
+            continue;
+        }
+
+        // 开始标签
+        const char* name = p;
+        const int length = readName(p, end);
+        bool selfClosing = false;
+        if (length == 0 || rootClosed || !skipAttributes(p, end, selfClosing)) {
+            return false;
+        }
+
+        Role role = Role::Other;
+        int field = 0;
+        if (depth == 0) {
+            if (!nameIs(name, length, "annotation")) {
+                return false; // 根元素不对，由通用解析器报告
+            }
+            role = Role::Root;
+        } else {
+            switch (stack[depth - 1].role) {
+            case Role::Root:
+            case Role::Other:
+                if (nameIs(name, length, "object")) {
+                    role = Role::Object;
+                } else if (stack[depth - 1].role == Role::Root && nameIs(name, length, "size")) {
+                    role = Role::Size;
+                } else {
+                    role = Role::Other;
+                }
+                break;
+            case Role::Skip:
+                role = Role::Skip;
+                break;
+            case Role::Size:
+                if (!hasDim[0] && nameIs(name, length, "width")) {
+                    role = Role::Dim;
+                    field = 0;
+                } else if (!hasDim[1] && nameIs(name, length, "height")) {
+                    role = Role::Dim;
+                    field = 1;
+                } else {
+                    role = Role::Skip;
+                }
+                break;
+            case Role::Object:
+                if (!hasName && nameIs(name, length, "name")) {
+                    role = Role::ObjectName;
+                } else if (!hasBndbox && nameIs(name, length, "bndbox")) {
+                    role = Role::Bndbox;
+                } else if (nameIs(name, length, "object")) {
+                    return false; // 嵌套的 <object>
+                } else {
+                    role = Role::InObject;
+                }
+                break;
+            case Role::InObject:
+                if (nameIs(name, length, "object")) {
+                    return false;
+                }
+                role = Role::InObject;
+                break;
+            case Role::Bndbox: {
+                static const char* const kCoordNames[4] = {"xmin", "ymin", "xmax", "ymax"};
+                role = Role::Skip;
+                for (int i = 0; i < 4; ++i) {
+                    if (!hasCoord[i] && nameIs(name, length, kCoordNames[i])) {
+                        role = Role::Coord;
+                        field = i;
+                        break;
+                    }
+                }
+                break;
+            }
+            case Role::ObjectName:
+            case Role::Coord:
+            case Role::Dim:
+                return false; // 文本元素中嵌套子元素
+            }
+        }
+
+        if (selfClosing) {
+            if (role == Role::Other || role == Role::Skip || role == Role::InObject) {
+                continue;
+            }
+            return false;
+        }
+        if (depth == kMaxDepth) {
+            return false;
+        }
+
+        switch (role) {
+        case Role::Object:
+            objectName = nullptr;
+            objectNameLength = 0;
+            hasName = false;
+            hasBndbox = false;
+            for (int i = 0; i < 4; ++i) {
+                coords[i] = 0;
+                hasCoord[i] = false;
+            }
+            break;
+        case Role::ObjectName:
+            hasName = true;
+            textBegin = p;
+            break;
+        case Role::Bndbox:
+            hasBndbox = true;
+            break;
+        case Role::Coord:
+            hasCoord[field] = true;
+            textBegin = p;
+            break;
+        case Role::Size:
+            for (int i = 0; i < 2; ++i) {
+                dims[i] = 0;
+                hasDim[i] = false;
+            }
+            break;
+        case Role::Dim:
+            hasDim[field] = true;
+            textBegin = p;
+            break;
+        default:
+            break;
+        }
+        stack[depth++] = {name, length, role, field};
+    }
+
+    return rootClosed;
+}
@@ -0,0 +1,37 @@
+#ifndef VOCFASTSCANNER_H
+#define VOCFASTSCANNER_H
+
+#include <QVector>
+
+// 直接在文件字节上解析 VOC 标注，不解码成 QString，也不建立 XML 树
+// 用 SIMD 一次检查 16 个字节，跳过 '<' 之间的文本；坐标直接从字节转换
+// 只处理常见的 UTF-8 VOC 文件：遇到注释、CDATA、DOCTYPE、实体、非 UTF-8 编码、
+// 嵌套 <object>、无效的框或无法直接转换的数字时返回 false，由调用方改用通用解析器，
+// 这样警告输出和边界情况的结果都与通用解析器一致
+class VocFastScanner
+{
+public:
+    struct Box
+    {
+        const char* name; // 指向输入数据，已去掉首尾空白
+        int nameLength;
+        int xmin;
+        int ymin;
+        int xmax;
+        int ymax;
+    };
+
+    // 成功时 boxes() 为文档顺序的全部有效对象，imageWidth/imageHeight 来自 <size>（没有时为 0）
+    bool scan(const char* data, qsizetype size);
+
+    const QVector<Box>& boxes() const { return boxes_; }
+    int imageWidth() const { return imageWidth_; }
+    int imageHeight() const { return imageHeight_; }
+
+private:
+    QVector<Box> boxes_; // 在多个文件之间复用容量
+    int imageWidth_ = 0;
+    int imageHeight_ = 0;
+};
+
+#endif // VOCFASTSCANNER_H
@@ -1,54 +1,648 @@
 #include "xmlprocessor.h"
 #include <QDebug>
 #include <QThread> // 用于调试输出当前线程ID
+#include <QFuture>
+#include <QtConcurrent>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QSet>
+#include <algorithm>
+#include <functional>
 
-XmlProcessor::XmlProcessor(QObject *parent) : QObject(parent)
+namespace {
+
+// 一段文件的解析结果（列存储），以及这段文件中没有命中缓存、需要写回缓存的文件
+struct AnalysisPartial
+{
+    AnnotationStore store;
+    QVector<ParseCache::Record> missed;
+    ParseReport report;
+};
+
+// 进度信号中的部分结果：每次只把新合并进 store 的文件计入分布，整个统计过程中每个文件只分箱一次
+// 统计过程中区间定义变了时从头重新分箱一次
+class ProgressTally
+{
+public:
+    DatasetStats update(const AnnotationStore& store, const HistogramSpec& spec)
+    {
+        if (spec != spec_ || distribution_.isEmpty()) {
+            spec_ = spec;
+            distribution_ = QVector<int>(spec.binCount(), 0);
+            validFiles_ = 0;
+            filesCounted_ = 0;
+        }
+        const QVector<int>& counts = store.fileBoxCounts();
+        for (; filesCounted_ < counts.size(); ++filesCounted_) {
+            const int objectCount = counts[filesCounted_];
+            if (objectCount > 0) {
+                ++validFiles_;
+                ++distribution_[spec_.binOf(objectCount)];
+            }
+        }
+
+        // 不含 objectsPerFile，也不共享 store 的数组，避免继续写入时整体复制
+        DatasetStats stats;
+        stats.distribution = distribution_;
+        stats.validFiles = validFiles_;
+        stats.labelCounts = DatasetStats::labelCountsOf(store);
+        return stats;
+    }
+
+private:
+    HistogramSpec spec_;
+    QVector<int> distribution_;
+    int validFiles_ = 0;
+    int filesCounted_ = 0; // store 中前 filesCounted_ 个文件已计入
+};
+
+} // namespace
+
+XmlProcessor::XmlProcessor(QObject *parent) : QObject(parent), paths_(QSharedPointer<PathTable>::create())
+{
+    qRegisterMetaType<DatasetStats>("DatasetStats"); // 跨线程信号需要
+    qRegisterMetaType<DatasetProgress>("DatasetProgress");
+    qRegisterMetaType<DatasetEstimate>("DatasetEstimate");
+}
+
+void XmlProcessor::setThreadCount(int count)
+{
+    threadCount_.store(qMax(0, count));
+}
+
+int XmlProcessor::threadCount() const
+{
+    return threadCount_.load();
+}
+
+void XmlProcessor::setHistogramSpec(const HistogramSpec& spec)
+{
+    QMutexLocker locker(&specMutex_);
+    histogramSpec_ = spec;
+}
+
+HistogramSpec XmlProcessor::histogramSpec() const
+{
+    QMutexLocker locker(&specMutex_);
+    return histogramSpec_;
+}
+
+int XmlProcessor::effectiveThreadCount() const
 {
+    int count = threadCount_.load();
+    if (count <= 0) {
+        count = QThread::idealThreadCount();
+    }
+    return qMax(1, count);
 }
 
-void XmlProcessor::processXmlDistribution(const QVector<QString>& xmlFiles)
+template <typename Partial, typename MapFn, typename MergeFn, typename ProgressFn>
+bool XmlProcessor::mapReduceFiles(const QVector<PathId>& xmlFiles, Partial& result,
+                                  MapFn mapFn, MergeFn mergeFn, ProgressFn progressFn)
+{
+    const qsizetype total = xmlFiles.size();
+    const qsizetype chunkCount = (total + kChunkSize - 1) / kChunkSize;
+    const int threads = qMin<qsizetype>(effectiveThreadCount(), chunkCount);
+
+    QElapsedTimer sinceProgress;
+    sinceProgress.start();
+    // 每合并一块检查一次是否需要发送进度
+    auto afterMerge = [&](qsizetype chunkIndex) {
+        const qsizetype done = qMin(total, (chunkIndex + 1) * kChunkSize);
+        if (done == total || sinceProgress.elapsed() >= kProgressIntervalMs) {
+            progressFn(done, result);
+            sinceProgress.restart();
+        }
+    };
+    auto chunkBegin = [&](qsizetype c) { return xmlFiles.constBegin() + c * kChunkSize; };
+    auto chunkEnd = [&](qsizetype c) { return xmlFiles.constBegin() + qMin(total, (c + 1) * kChunkSize); };
+
+    if (threads <= 1) {
+        // 串行路径：直接在当前工作线程上处理，所有块共用一个读取器
+        const std::unique_ptr<AnnotationReader> reader = createReader();
+        for (qsizetype c = 0; c < chunkCount; ++c) {
+            if (cancelRequested_.load()) {
+                return false;
+            }
+            Partial partial;
+            mapFn(*reader, chunkBegin(c), chunkEnd(c), partial);
+            mergeFn(result, partial);
+            afterMerge(c);
+        }
+        return true;
+    }
+
+    pool_.setMaxThreadCount(threads);
+
+    QVector<Partial> partials(chunkCount);
+    Partial *out = partials.data(); // 每个任务只写自己的下标，避免并发 detach
+
+    QVector<QFuture<void>> futures;
+    futures.reserve(chunkCount);
+    for (qsizetype c = 0; c < chunkCount; ++c) {
+        futures.append(QtConcurrent::run(&pool_, [this, &mapFn, &chunkBegin, &chunkEnd, out, c]() {
+            if (cancelRequested_.load()) {
+                return; // 已取消，剩下的块直接跳过
+            }
+            const std::unique_ptr<AnnotationReader> reader = createReader(); // 每个任务使用自己的读取器
+            mapFn(*reader, chunkBegin(c), chunkEnd(c), out[c]);
+        }));
+    }
+
+    // 按块的顺序合并，结果与串行路径完全一致；取消后仍要等所有任务返回
+    bool completed = true;
+    for (qsizetype c = 0; c < chunkCount; ++c) {
+        futures[c].waitForFinished();
+        if (!completed || cancelRequested_.load()) {
+            completed = false;
+            continue;
+        }
+        mergeFn(result, out[c]);
+        out[c] = Partial(); // 合并后立即释放
+        afterMerge(c);
+    }
+    return completed;
+}
+
+void XmlProcessor::requestCancel()
+{
+    cancelRequested_.store(true);
+}
+
+void XmlProcessor::setPathTable(const QSharedPointer<PathTable>& paths)
+{
+    if (paths == paths_) {
+        return;
+    }
+    paths_ = paths;
+    clearLive();
+}
+
+void XmlProcessor::setCachePath(const QString& cachePath)
+{
+    if (cachePath == cachePath_) {
+        return;
+    }
+    cachePath_ = cachePath;
+    cache_.clear();
+    cacheLoaded_ = false;
+}
+
+void XmlProcessor::parseWithCache(AnnotationReader& reader, const QString& filePath, AnnotationStore& store,
+                                  QVector<int>& cacheLabelRemap, QVector<ParseCache::Record>& missed) const
+{
+    const int fileIndex = store.beginFile();
+    if (cachePath_.isEmpty() || !reader.isCacheable()) {
+        reader.parseInto(filePath, store);
+        return;
+    }
+    // 有数据质量问题的文件不写入缓存，每次都重新解析，这样报告不会因为命中缓存而漏掉问题
+    const qint64 issuesBefore = reader.report() ? reader.report()->issueCount() : 0;
+
+    const QFileInfo info(filePath);
+    const qint64 size = info.size();
+    const qint64 mtime = info.lastModified().toMSecsSinceEpoch();
+
+    if (cache_.lookupInto(filePath, size, mtime, store, cacheLabelRemap)) {
+        return;
+    }
+
+    reader.parseInto(filePath, store);
+    if (!reader.report() || reader.report()->issueCount() == issuesBefore) {
+        missed.append({filePath, size, mtime, fileIndex});
+    }
+}
+
+DatasetStats XmlProcessor::analyzeDataset(const QVector<PathId>& xmlFiles, bool *cancelled)
+{
+    cancelRequested_.store(false);
+    return analyzeFiles(xmlFiles, cancelled);
+}
+
+DatasetStats XmlProcessor::analyzeFiles(const QVector<PathId>& xmlFiles, bool *cancelled)
+{
+    const std::unique_ptr<AnnotationReader> probe = createReader();
+    if (!probe->isPerImage()) {
+        return analyzeMultiImageFiles(*probe, xmlFiles, cancelled);
+    }
+    const bool useCache = !cachePath_.isEmpty() && probe->isCacheable();
+
+    if (useCache && !cacheLoaded_) {
+        cache_.load(cachePath_);
+        cacheLoaded_ = true;
+        qDebug() << "工作线程: 已读取解析缓存，条目数：" << cache_.size();
+    }
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    // 每个块解析到自己的列存储中，按顺序追加到 result.store，文件序号与 xmlFiles 下标一致
+    AnalysisPartial result;
+    ProgressTally tally;
+    const bool completed = mapReduceFiles(
+        xmlFiles, result,
+        [this](AnnotationReader& reader, QVector<PathId>::const_iterator begin, QVector<PathId>::const_iterator end, AnalysisPartial& partial) {
+            QVector<int> cacheLabelRemap;
+            reader.setReport(&partial.report);
+            // 整块的路径一次取出，工作线程之间不必每个文件争一次路径表的锁
+            const QVector<QString> filePaths = paths_->paths(begin, end);
+            for (const QString& filePath : filePaths)
+            {
+                parseWithCache(reader, filePath, partial.store, cacheLabelRemap, partial.missed);
+            }
+        },
+        [](AnalysisPartial& into, const AnalysisPartial& from) {
+            const int fileOffset = into.store.fileCount();
+            into.store.append(from.store);
+            for (ParseCache::Record record : from.missed) {
+                record.fileIndex += fileOffset;
+                into.missed.append(record);
+            }
+            into.report.merge(from.report);
+        },
+        [this, &elapsed, &xmlFiles, &tally](qsizetype done, const AnalysisPartial& partial) {
+            DatasetProgress progress;
+            progress.filesDone = int(done);
+            progress.totalFiles = int(xmlFiles.size());
+            const qint64 ms = qMax<qint64>(1, elapsed.elapsed());
+            progress.filesPerSecond = done * 1000.0 / ms;
+            progress.partial = tally.update(partial.store, histogramSpec());
+            progress.partial.report = partial.report;
+            emit progressUpdated(progress);
+        });
+
+    if (cancelled) {
+        *cancelled = !completed;
+    }
+
+    if (useCache) {
+        // 取消时也把已经解析过的文件写回缓存，下次可以接着用
+        // 只在有变化时重写缓存文件
+        const int before = cache_.size();
+        for (const ParseCache::Record& record : std::as_const(result.missed)) {
+            cache_.insert(record, result.store);
+        }
+        if (completed) {
+            cache_.pruneMissing(xmlFiles, *paths_);
+        }
+        if (!result.missed.isEmpty() || cache_.size() != before) {
+            cache_.save(cachePath_);
+        }
+        qDebug() << "工作线程: 重新解析文件数：" << result.missed.size()
+                 << "缓存命中数：" << result.store.fileCount() - result.missed.size();
+    }
+
+    DatasetStats stats = DatasetStats::fromStore(result.store, histogramSpec());
+    stats.geometry = GeometryStats::compute(result.store);
+    stats.report = result.report;
+    stats.sourceFiles = result.store.fileCount(); // 单图片格式中文件与图片一一对应
+    stats.images = xmlFiles.mid(0, stats.sourceFiles);
+    stats.paths = paths_;
+    stats.directories = DirectoryStats::compute(result.store, *paths_, stats.images, histogramSpec());
+    stats.index = QSharedPointer<AnnotationIndex>::create(AnnotationIndex::build(result.store));
+    stats.store = QSharedPointer<AnnotationStore>::create(std::move(result.store));
+    return stats;
+}
+
+DatasetStats XmlProcessor::analyzeMultiImageFiles(AnnotationReader& reader, const QVector<PathId>& files, bool *cancelled)
+{
+    QElapsedTimer elapsed;
+    elapsed.start();
+    QElapsedTimer sinceProgress;
+    sinceProgress.start();
+
+    qint64 bytesTotal = 0;
+    for (PathId file : files) {
+        bytesTotal += QFileInfo(paths_->path(file)).size();
+    }
+
+    AnnotationStore store;
+    QVector<PathId> images;
+    ParseReport report;
+    reader.setReport(&report);
+    qint64 bytesBefore = 0; // 已经读完的文件的字节数
+    int filesDone = 0;
+    ProgressTally tally;
+
+    auto emitProgress = [&](qint64 bytesDone, int imagesInFile) {
+        DatasetProgress progress;
+        progress.filesDone = filesDone;
+        progress.totalFiles = int(files.size());
+        progress.bytesDone = bytesDone;
+        progress.bytesTotal = bytesTotal;
+        const qint64 ms = qMax<qint64>(1, elapsed.elapsed());
+        // 文件内部按图片计速，界面显示的"文件/秒"在这里是"图片/秒"
+        progress.filesPerSecond = (store.fileCount() + imagesInFile) * 1000.0 / ms;
+        progress.partial = tally.update(store, histogramSpec());
+        progress.partial.report = report;
+        emit progressUpdated(progress);
+        sinceProgress.restart();
+    };
+
+    AnnotationReader::ReadControl control;
+    control.cancel = &cancelRequested_;
+    control.progress = [&](qint64 bytesDone, qint64, int imagesRead) {
+        if (sinceProgress.elapsed() >= kProgressIntervalMs) {
+            emitProgress(bytesBefore + bytesDone, imagesRead);
+        }
+    };
+
+    bool completed = true;
+    for (PathId fileId : files) {
+        if (cancelRequested_.load()) {
+            completed = false;
+            break;
+        }
+        const QString file = paths_->path(fileId);
+        if (!reader.readImages(file, store, *paths_, images, control) && cancelRequested_.load()) {
+            completed = false; // 读到一半被取消，这个文件的图片不计入
+            break;
+        }
+        bytesBefore += QFileInfo(file).size();
+        ++filesDone;
+        emitProgress(bytesBefore, 0);
+    }
+
+    if (cancelled) {
+        *cancelled = !completed;
+    }
+
+    DatasetStats stats = DatasetStats::fromStore(store, histogramSpec());
+    stats.geometry = GeometryStats::compute(store);
+    stats.report = report;
+    stats.sourceFiles = filesDone;
+    stats.images = std::move(images);
+    stats.paths = paths_;
+    stats.directories = DirectoryStats::compute(store, *paths_, stats.images, histogramSpec());
+    stats.index = QSharedPointer<AnnotationIndex>::create(AnnotationIndex::build(store));
+    stats.store = QSharedPointer<AnnotationStore>::create(std::move(store));
+    return stats;
+}
+
+void XmlProcessor::processDataset(const QVector<PathId>& xmlFiles)
 {
     emit processingStarted(); // 发送开始处理信号
+    clearLive();
+    bool cancelled = false;
+    DatasetStats stats = analyzeDataset(xmlFiles, &cancelled);
+    if (cancelled) {
+        emit processingCancelled(stats.sourceFiles, int(xmlFiles.size()));
+        qDebug() << "工作线程: 数据集统计已取消，已处理文件数：" << stats.sourceFiles;
+    } else {
+        keepLiveStats(stats);
+        emit datasetProcessingFinished(stats);
+        qDebug() << "工作线程: 数据集统计完成，有效文件数：" << stats.validFiles;
+    }
+    emit processingFinished(); // 发送处理结束信号
+}
 
-    QVector<int> xml_count = {0, 0, 0, 0, 0, 0}; // 局部变量存储统计结果
-    int totalValidFiles = 0; // 统计有效文件（包含object的文件）的数量
+void XmlProcessor::processDatasetPreview(const QVector<PathId>& xmlFiles, int sampleSize, bool stratified, bool refine,
+                                         quint32 seed)
+{
+    const DatasetSample sample = DatasetSample::draw(xmlFiles, *paths_, sampleSize, stratified, seed);
+    if (sample.coversAll() || !createReader()->isPerImage()) {
+        processDataset(xmlFiles); // 样本就是全部文件，或者格式不能按文件抽样（COCO）
+        return;
+    }
 
-    for (const QString& filePath : xmlFiles)
-    {
-        QList<VocObject> obj_list = parser_.parseObjects(filePath);
-        int totalObjectsInFile = obj_list.size();
-        if (totalObjectsInFile == 0)
-        {
-            continue; // 如果文件没有object，则跳过
+    emit processingStarted();
+    cancelRequested_.store(false);
+    clearLive();
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    bool cancelled = false;
+    const DatasetStats sampleStats = analyzeFiles(sample.files, &cancelled);
+    if (cancelled) {
+        emit processingCancelled(0, int(xmlFiles.size()));
+        emit processingFinished();
+        return;
+    }
+    emit previewReady(DatasetEstimate::compute(sample, sampleStats, histogramSpec()));
+    qDebug() << "工作线程: 抽样预览完成，样本文件数：" << sample.files.size() << "分层数：" << sample.stratumSize.size()
+             << "用时" << elapsed.elapsed() << "ms";
+
+    if (refine) {
+        // 样本已经解析过，只解析其余文件，再把两部分合并成精确结果
+        const DatasetStats restStats = analyzeFiles(sample.remainingFiles(xmlFiles), &cancelled);
+        const DatasetStats stats = combineStats(sampleStats, restStats);
+        if (cancelled) {
+            emit processingCancelled(stats.sourceFiles, int(xmlFiles.size()));
+        } else {
+            keepLiveStats(stats);
+            emit datasetProcessingFinished(stats);
+            qDebug() << "工作线程: 精确统计完成，有效文件数：" << stats.validFiles;
+        }
+    }
+    emit processingFinished();
+}
+
+void XmlProcessor::clearLive()
+{
+    live_ = DatasetStats();
+    liveStore_.reset();
+    liveQueryIndex_.reset();
+    liveIndex_.clear();
+}
+
+void XmlProcessor::keepLiveStats(const DatasetStats& stats)
+{
+    clearLive();
+    if (!stats.store || !stats.index || !createReader()->isPerImage()) {
+        return;
+    }
+    live_ = stats; // 与界面共享 store，界面在请求增量更新前放开它
+    liveStore_ = qSharedPointerConstCast<AnnotationStore>(stats.store);
+    liveQueryIndex_ = qSharedPointerConstCast<AnnotationIndex>(stats.index);
+    liveSpec_ = histogramSpec();
+    liveIndex_.reserve(live_.images.size());
+    for (int f = 0; f < live_.images.size(); ++f) {
+        liveIndex_.insert(live_.images[f], f);
+    }
+}
+
+void XmlProcessor::updateFiles(const QVector<PathId>& changed, const QVector<PathId>& removed)
+{
+    if (!liveStore_ || !liveQueryIndex_ || live_.images.size() != liveStore_->fileCount()) {
+        return; // 没有可以增量更新的结果，或者它与 store 对不上
+    }
+    emit processingStarted();
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    // 界面可能在这之间换了区间，先按当前区间重新分箱
+    const HistogramSpec spec = histogramSpec();
+    if (spec != liveSpec_) {
+        live_.distribution = spec.apply(live_.objectsPerFile);
+        live_.directories.rebin(spec, live_.objectsPerFile);
+        liveSpec_ = spec;
+    }
+
+    // 重新解析变化的文件：已有的文件按原来的位置替换，新文件追加到末尾
+    // 数据质量报告只在完整统计时生成，这里不记录
+    const QSet<PathId> removedSet(removed.constBegin(), removed.constEnd());
+    QVector<int> replacedFiles;
+    QVector<PathId> addedIds;
+    AnnotationStore replaced; // 与 replacedFiles 一一对应
+    AnnotationStore added;    // 与 addedIds 一一对应
+    const std::unique_ptr<AnnotationReader> reader = createReader();
+    for (PathId id : changed) {
+        if (removedSet.contains(id)) {
+            continue;
+        }
+        auto it = liveIndex_.constFind(id);
+        const bool existing = it != liveIndex_.constEnd();
+        AnnotationStore& target = existing ? replaced : added;
+        if (existing) {
+            replacedFiles.append(it.value());
+        } else {
+            addedIds.append(id);
+        }
+        target.beginFile();
+        reader->parseInto(paths_->path(id), target);
+    }
+    QVector<int> removedFiles;
+    for (PathId id : removed) {
+        auto it = liveIndex_.constFind(id);
+        if (it != liveIndex_.constEnd()) {
+            removedFiles.append(it.value());
+        }
+    }
+
+    // 界面已经放开 store 和倒排表，这里独占它们并原地修改；框数数组与 store 共享，也先放开
+    live_.store.reset();
+    live_.index.reset();
+    live_.objectsPerFile.clear();
+    AnnotationStore& store = *liveStore_;
+    AnnotationIndex& index = *liveQueryIndex_;
+
+    // 每个变化的文件先减去旧内容的贡献，修改 store 后再加上新内容的贡献，其余文件不再遍历
+    AnnotationStore previous; // 被替换或删除的文件原来的内容，用来减去几何分布
+    auto accumulate = [this, &spec, &store](int file, int sign) {
+        const int objects = store.fileBoxCount(file);
+        if (objects > 0) {
+            live_.distribution[spec.binOf(objects)] += sign;
+            live_.validFiles += sign;
+        }
+        const qsizetype begin = store.fileBegin(file);
+        for (qsizetype b = begin; b < begin + objects; ++b) {
+            const QString name = store.labelName(store.labelIds()[b]);
+            int& count = live_.labelCounts[name];
+            count += sign;
+            if (count <= 0) {
+                live_.labelCounts.remove(name);
+            }
+        }
+    };
+    auto subtractFile = [&](int file, bool countFile) {
+        accumulate(file, -1);
+        previous.appendFile(store, file);
+        live_.directories.adjustFile(store, file, spec, -1, countFile);
+        index.removeFile(store, file);
+    };
+    auto addFile = [&](int file, bool countFile) {
+        accumulate(file, +1);
+        live_.directories.adjustFile(store, file, spec, +1, countFile);
+        index.addFile(store, file);
+    };
+
+    for (int k = 0; k < replacedFiles.size(); ++k) {
+        subtractFile(replacedFiles[k], false);
+        store.replaceFile(replacedFiles[k], replaced, k);
+        addFile(replacedFiles[k], false);
+    }
+
+    // 删除的文件由最后一个文件补位；从大到小删除，补位的文件不会再被删除
+    std::sort(removedFiles.begin(), removedFiles.end(), std::greater<int>());
+    for (int f : std::as_const(removedFiles)) {
+        subtractFile(f, true);
+        const int last = store.fileCount() - 1;
+        if (f != last) {
+            index.removeFile(store, last);
         }
-        totalValidFiles++; // 有效文件数增加
-        int index = (totalObjectsInFile - 1) / 5;
-        if (index > 5) // 最大索引是5 (对应 "25以上")
-        {
-            index = 5;
+        store.removeFileSwapLast(f);
+        live_.directories.removeFileSwapLast(f);
+        liveIndex_.remove(live_.images[f]);
+        live_.images[f] = live_.images.last();
+        live_.images.removeLast();
+        if (f != last) {
+            liveIndex_.insert(live_.images[f], f);
+            index.addFile(store, f);
         }
-        xml_count[index] += 1;
     }
+
+    bool rebuildDirectories = false;
+    for (int k = 0; k < added.fileCount(); ++k) {
+        const int f = store.appendFile(added, k);
+        live_.images.append(addedIds[k]);
+        liveIndex_.insert(addedIds[k], f);
+        accumulate(f, +1);
+        index.addFile(store, f);
+        rebuildDirectories = rebuildDirectories || !live_.directories.appendFile(addedIds[k], *paths_, spec);
+        if (!rebuildDirectories) {
+            live_.directories.adjustFile(store, f, spec, +1, true);
+        }
+    }
+    index.setFileCount(store.fileCount());
+    if (rebuildDirectories) { // 新图片在原来的公共目录之外，根节点变了，只能重新汇总
+        live_.directories = DirectoryStats::compute(store, *paths_, live_.images, spec);
+    }
+
+    // 几何分布只在变化的文件上计算
+    live_.geometry.merge(GeometryStats::compute(previous), -1);
+    live_.geometry.merge(GeometryStats::compute(replaced), +1);
+    live_.geometry.merge(GeometryStats::compute(added), +1);
+
+    live_.objectsPerFile = store.fileBoxCounts();
+    live_.sourceFiles = store.fileCount();
+    live_.store = liveStore_;
+    live_.index = liveQueryIndex_;
+
+    const int changedFiles = int(replacedFiles.size() + addedIds.size());
+    emit datasetUpdated(live_, changedFiles, int(removedFiles.size()));
+    qDebug() << "工作线程: 增量更新完成，重新解析" << changedFiles << "个文件，删除" << removedFiles.size()
+             << "个文件，用时" << elapsed.elapsed() << "ms";
+    emit processingFinished();
+}
+
+DatasetStats XmlProcessor::combineStats(const DatasetStats& first, const DatasetStats& second) const
+{
+    AnnotationStore store;
+    if (first.store) {
+        store = *first.store;
+    }
+    if (second.store) {
+        store.append(*second.store);
+    }
+
+    DatasetStats stats = DatasetStats::fromStore(store, histogramSpec());
+    stats.geometry = GeometryStats::compute(store);
+    stats.report = first.report;
+    stats.report.merge(second.report);
+    stats.sourceFiles = first.sourceFiles + second.sourceFiles;
+    stats.images = first.images + second.images;
+    stats.paths = first.paths ? first.paths : second.paths;
+    stats.directories = DirectoryStats::compute(store, *paths_, stats.images, histogramSpec());
+    stats.index = QSharedPointer<AnnotationIndex>::create(AnnotationIndex::build(store));
+    stats.store = QSharedPointer<AnnotationStore>::create(std::move(store));
+    return stats;
+}
+
+void XmlProcessor::processXmlDistribution(const QVector<PathId>& xmlFiles)
+{
+    emit processingStarted(); // 发送开始处理信号
+    DatasetStats stats = analyzeDataset(xmlFiles);
     // 发送处理完成信号，携带统计结果和有效文件总数
-    emit distributionProcessingFinished(xml_count, totalValidFiles);
+    emit distributionProcessingFinished(stats.distribution, stats.validFiles);
     emit processingFinished(); // 发送处理结束信号
     qDebug() << "工作线程: XML分布处理完成。";
 }
 
-void XmlProcessor::processXmlBoxCounts(const QVector<QString>& xmlFiles)
+void XmlProcessor::processXmlBoxCounts(const QVector<PathId>& xmlFiles)
 {
     emit processingStarted(); // 发送开始处理信号
-    QMap<QString, int> box_map; // 局部变量存储统计结果
-
-    for (const QString& filePath : xmlFiles)
-    {
-        QList<VocObject> obj_list = parser_.parseObjects(filePath);
-        for(const auto& obj : std::as_const(obj_list))
-        {
-            QString label_name = obj.name;
-            box_map[label_name] += 1;
-        }
-    }
-    emit boxCountProcessingFinished(box_map);
+    DatasetStats stats = analyzeDataset(xmlFiles);
+    emit boxCountProcessingFinished(stats.labelCounts);
     emit processingFinished(); // 发送处理结束信号
 }
@@ -5,7 +5,16 @@
 #include <QString>
 #include <QVector>
 #include <QMap>
-#include "vocParser.h" // 确保这个路径是正确的
+#include <QHash>
+#include <QThreadPool>
+#include <QMutex>
+#include <QSharedPointer>
+#include <atomic>
+#include "annotationreader.h"
+#include "datasetstats.h"
+#include "datasetsample.h"
+#include "parsecache.h"
+#include "pathtable.h"
 
 class XmlProcessor : public QObject
 {
@@ -13,13 +22,69 @@ class XmlProcessor : public QObject
 public:
     explicit XmlProcessor(QObject *parent = nullptr);
 
+    // 设置并行解析使用的线程数：0 表示使用 QThread::idealThreadCount()，1 表示串行
+    // 可以在任意线程调用，下一次处理时生效
+    void setThreadCount(int count);
+    int threadCount() const;
+
+    // 设置结果中 distribution 使用的区间，可以在任意线程调用，影响之后的进度和结果
+    void setHistogramSpec(const HistogramSpec& spec);
+    HistogramSpec histogramSpec() const;
+
+    // 设置 VOC 的解析后端，可以在任意线程调用，下一次创建解析器时生效
+    void setParserBackend(VocParser::Backend backend) { parserBackend_.store(backend); }
+    // 设置输入文件的标注格式，可以在任意线程调用，下一次创建解析器时生效
+    void setInputFormat(AnnotationFormat format) { inputFormat_.store(format); }
+    AnnotationFormat inputFormat() const { return inputFormat_.load(); }
+
+    QSharedPointer<PathTable> pathTable() const { return paths_; }
+
+    // 同步执行一次完整统计：每个文件只解析一次，同时得到分布和标签个数
+    // 过程中按节流间隔发送 progressUpdated；被取消时返回已完成部分的结果并设置 *cancelled
+    DatasetStats analyzeDataset(const QVector<PathId>& xmlFiles, bool *cancelled = nullptr);
+
+    // 请求停止当前统计（协作式，已在解析的文件会处理完），可以在任意线程调用
+    void requestCancel();
+
+    static constexpr int kChunkSize = 256;          // 每个任务处理的文件数
+    static constexpr int kProgressIntervalMs = 250; // 进度信号的最小间隔
+
 public slots:
+    // 文件列表中的序号都指向这个路径表，默认使用自己新建的表
+    // 换表后旧表的序号不再有效，丢弃用于增量更新的结果；通过排队的信号调用时在当前统计结束后才生效
+    void setPathTable(const QSharedPointer<PathTable>& paths);
+    // 设置解析缓存文件，空字符串表示不使用缓存
+    // 设置后只重新解析新增或修改过的文件，其余直接从缓存读取
+    void setCachePath(const QString& cachePath);
+
+    // 一次遍历得到全部统计结果，完成后发送 datasetProcessingFinished
+    void processDataset(const QVector<PathId>& xmlFiles);
+    // 抽样预览：先统计 sampleSize 个文件的样本（stratified 时按目录分层），发送 previewReady；
+    // refine 为 true 时接着统计其余文件，合并后与 processDataset 一样发送 datasetProcessingFinished
+    // 预览阶段的进度信号针对样本，精确统计阶段的进度信号只包含其余文件
+    void processDatasetPreview(const QVector<PathId>& xmlFiles, int sampleSize, bool stratified, bool refine,
+                               quint32 seed);
+    // 监视到文件变化后增量更新最近一次完整统计的结果：changed 为新增或内容变化的文件，removed 为已删除的文件
+    // 先从各项统计中减去这些文件原来的贡献，再加上重新解析的结果，store 和倒排表原地修改，完成后发送 datasetUpdated
+    // 调用前界面必须放开 live 结果中的 store 和 index（MainWindow::flushWatchedChanges）
+    // 还没有完整统计结果（未统计、已取消或 COCO）时忽略，下一次完整统计自然会包含这些变化
+    void updateFiles(const QVector<PathId>& changed, const QVector<PathId>& removed);
     // 处理XML标签分布的槽函数
-    void processXmlDistribution(const QVector<QString>& xmlFiles);
+    void processXmlDistribution(const QVector<PathId>& xmlFiles);
     // 处理XML标签个数统计的槽函数
-    void processXmlBoxCounts(const QVector<QString>& xmlFiles);
+    void processXmlBoxCounts(const QVector<PathId>& xmlFiles);
 
 signals:
+    // 统计进度，携带已处理文件数、速度和到目前为止的分布与标签个数
+    void progressUpdated(const DatasetProgress& progress);
+    // 抽样预览完成，携带估计值和置信区间
+    void previewReady(const DatasetEstimate& estimate);
+    // updateFiles 完成，stats 为更新后的完整结果
+    void datasetUpdated(const DatasetStats& stats, int changedFiles, int removedFiles);
+    // 统计被 requestCancel 取消
+    void processingCancelled(int filesDone, int totalFiles);
+    // 全量统计完成信号，携带分布、标签个数、有效文件数和每个文件的标签个数
+    void datasetProcessingFinished(const DatasetStats& stats);
     // 标签分布处理完成信号，参数为各区间的数量和处理的总文件数
     void distributionProcessingFinished(const QVector<int>& counts, int totalFilesProcessed);
     // 标签个数统计完成信号，参数为标签名和对应的数量
@@ -30,7 +95,55 @@ signals:
     void processingFinished();
 
 private:
-    VocParser parser_; // VocParser 实例，在工作线程中使用
+    // 实际生效的线程数（已把 0 换算成 idealThreadCount）
+    int effectiveThreadCount() const;
+
+    // analyzeDataset 的实现，不重置取消标志，抽样预览的两个阶段共用一次取消
+    DatasetStats analyzeFiles(const QVector<PathId>& xmlFiles, bool *cancelled);
+    // 把两次统计的结果合并成一个（second 的图片排在 first 之后）
+    DatasetStats combineStats(const DatasetStats& first, const DatasetStats& second) const;
+
+    // 把文件列表切成每块 kChunkSize 个文件，每块在线程池里独立累加到自己的 Partial 中，
+    // 当前线程按块的顺序依次合并到 result 并节流回调 progressFn，工作线程之间不共享任何锁
+    // 返回 false 表示中途被取消，此时 result 只包含前面连续完成的块
+    template <typename Partial, typename MapFn, typename MergeFn, typename ProgressFn>
+    bool mapReduceFiles(const QVector<PathId>& xmlFiles, Partial& result,
+                        MapFn mapFn, MergeFn mergeFn, ProgressFn progressFn);
+
+    // 在 store 中新建一个文件：命中缓存时直接从缓存填充，否则解析文件并记到 missed 中，由调用方合并回缓存
+    // 只有 reader.isCacheable() 的格式使用缓存
+    void parseWithCache(AnnotationReader& reader, const QString& filePath, AnnotationStore& store,
+                        QVector<int>& cacheLabelRemap, QVector<ParseCache::Record>& missed) const;
+
+    // 一个文件包含多张图片的格式（COCO）：逐个文件读取，文件内部按字节报告进度
+    DatasetStats analyzeMultiImageFiles(AnnotationReader& reader, const QVector<PathId>& files, bool *cancelled);
+
+    // 记下一次完整统计的结果，之后的 updateFiles 在它上面增量更新；多图片格式不支持增量更新
+    void keepLiveStats(const DatasetStats& stats);
+    // 丢弃增量更新的基础：live_ 和它的 store、倒排表、路径序号索引一起清空
+    void clearLive();
+
+    std::unique_ptr<AnnotationReader> createReader() const { return AnnotationReader::create(inputFormat_.load(), parserBackend_.load()); }
+
+    QSharedPointer<PathTable> paths_;
+    std::atomic<VocParser::Backend> parserBackend_{VocParser::Backend::Stream};
+    std::atomic<AnnotationFormat> inputFormat_{AnnotationFormat::Voc};
+    QThreadPool pool_; // 并行模式使用的线程池
+    std::atomic<int> threadCount_{0};
+    std::atomic<bool> cancelRequested_{false};
+
+    mutable QMutex specMutex_; // 保护 histogramSpec_，界面线程会在统计过程中修改它
+    HistogramSpec histogramSpec_;
+
+    DatasetStats live_;             // 最近一次完整统计的结果，store 为空表示不能增量更新
+    HistogramSpec liveSpec_;        // live_.distribution 使用的区间
+    QSharedPointer<AnnotationStore> liveStore_;      // live_.store 的可写引用，store 由本对象创建
+    QSharedPointer<AnnotationIndex> liveQueryIndex_; // live_.index 的可写引用
+    QHash<PathId, int> liveIndex_;  // 路径序号 -> live_.store 中的文件序号
+
+    QString cachePath_;      // 为空时不使用缓存
+    ParseCache cache_;       // 统计期间只读，统计结束后在工作线程中合并新结果
+    bool cacheLoaded_ = false;
 };
 
 
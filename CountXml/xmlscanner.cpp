@@ -0,0 +1,61 @@
+#include "xmlscanner.h"
+#include <QDirIterator>
+#include <QElapsedTimer>
+
+XmlScanner::XmlScanner(QSharedPointer<PathTable> paths, QObject *parent)
+    : QObject(parent), paths_(std::move(paths))
+{
+}
+
+void XmlScanner::cancel(int scanId)
+{
+    int current = cancelledUpTo_.load();
+    while (current < scanId && !cancelledUpTo_.compare_exchange_weak(current, scanId)) {
+    }
+}
+
+void XmlScanner::scan(const QString& dir, const QStringList& nameFilters, const QStringList& excludedNames, int scanId)
+{
+    QDirIterator it(dir,
+                    nameFilters,
+                    QDir::Files | QDir::Readable, // 只查找文件，可读
+                    QDirIterator::Subdirectories); // 包含子目录
+
+    QVector<QString> batch;
+    batch.reserve(kBatchSize);
+    int totalFound = 0;
+    QElapsedTimer timer;
+    timer.start();
+
+    while (it.hasNext()) {
+        if (isCancelled(scanId)) {
+            flushBatch(scanId, batch, totalFound);
+            emit scanFinished(scanId, totalFound, true);
+            return;
+        }
+        const QString path = it.next();
+        if (!excludedNames.isEmpty() && excludedNames.contains(it.fileName())) {
+            continue;
+        }
+        batch.push_back(path);
+        ++totalFound;
+
+        if (batch.size() >= kBatchSize || timer.elapsed() >= kBatchIntervalMs) {
+            flushBatch(scanId, batch, totalFound);
+            timer.restart();
+        }
+    }
+
+    flushBatch(scanId, batch, totalFound);
+    emit scanFinished(scanId, totalFound, false);
+}
+
+void XmlScanner::flushBatch(int scanId, QVector<QString>& batch, int totalFound)
+{
+    if (batch.isEmpty()) {
+        return;
+    }
+    emit batchFound(scanId, paths_->addAll(batch), totalFound);
+    batch.clear();
+    batch.reserve(kBatchSize);
+}
@@ -0,0 +1,50 @@
+#ifndef XMLSCANNER_H
+#define XMLSCANNER_H
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include "pathtable.h"
+
+// 在后台线程中递归查找标注文件（XML、YOLO 的 txt 或 COCO 的 json），路径加入共享的 PathTable，
+// 分批把路径序号发送给界面
+// 每找到 kBatchSize 个文件或距上一批超过 kBatchIntervalMs 毫秒就发送一批，
+// 界面可以实时显示数量，并在扫描结束前就开始统计已找到的文件
+class XmlScanner : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr int kBatchSize = 4096;
+    static constexpr int kBatchIntervalMs = 200;
+
+    explicit XmlScanner(QSharedPointer<PathTable> paths, QObject *parent = nullptr);
+
+    // 取消编号不大于 scanId 的扫描，可以在任意线程调用
+    // 按编号记录，扫描还在队列中没开始时取消也不会丢失
+    void cancel(int scanId);
+
+public slots:
+    // 换用另一个路径表，之后的扫描把路径加入新表；通过排队的信号调用时在正在进行的扫描返回后才生效
+    void setPathTable(const QSharedPointer<PathTable>& paths) { paths_ = paths; }
+    // scanId 由调用方分配，用来丢弃已被取消的旧扫描发出的批次
+    // nameFilters 为文件名通配符，文件名在 excludedNames 中的文件跳过（如 YOLO 的 classes.txt）
+    void scan(const QString& dir, const QStringList& nameFilters, const QStringList& excludedNames, int scanId);
+
+signals:
+    void batchFound(int scanId, const QVector<PathId>& paths, int totalFound);
+    void scanFinished(int scanId, int totalFound, bool cancelled);
+
+private:
+    // 把 batch 加入路径表并发送
+    void flushBatch(int scanId, QVector<QString>& batch, int totalFound);
+
+    bool isCancelled(int scanId) const { return scanId <= cancelledUpTo_.load(); }
+
+    QSharedPointer<PathTable> paths_;
+    std::atomic<int> cancelledUpTo_{-1}; // 编号不大于它的扫描都已取消
+};
+
+#endif // XMLSCANNER_H
@@ -0,0 +1,217 @@
+#include "yoloreader.h"
+#include "annotationstore.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <cmath>
+
+namespace {
+
+quint32 readBigEndian(const uchar* p, int bytes)
+{
+    quint32 value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+qint32 readLittleEndian32(const uchar* p)
+{
+    return qint32(quint32(p[0]) | (quint32(p[1]) << 8) | (quint32(p[2]) << 16) | (quint32(p[3]) << 24));
+}
+
+// 在 JPEG 的段中查找 SOFn，只读取段头，跳过 EXIF 等数据段
+bool readJpegSize(QFile& file, int& width, int& height)
+{
+    uchar header[4];
+    file.seek(2); // 跳过 SOI
+    while (true) {
+        if (file.read(reinterpret_cast<char*>(header), 2) != 2 || header[0] != 0xFF) {
+            return false;
+        }
+        uchar marker = header[1];
+        while (marker == 0xFF) { // 填充字节
+            if (!file.getChar(reinterpret_cast<char*>(&marker))) {
+                return false;
+            }
+        }
+        if (marker == 0xD8 || (marker >= 0xD0 && marker <= 0xD7) || marker == 0x01) {
+            continue; // 没有长度字段的标记
+        }
+        if (file.read(reinterpret_cast<char*>(header), 2) != 2) {
+            return false;
+        }
+        const int length = int(readBigEndian(header, 2));
+        if (length < 2) {
+            return false;
+        }
+        const bool isSof = marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+        if (isSof) {
+            uchar sof[5];
+            if (file.read(reinterpret_cast<char*>(sof), 5) != 5) {
+                return false;
+            }
+            height = int(readBigEndian(sof + 1, 2));
+            width = int(readBigEndian(sof + 3, 2));
+            return width > 0 && height > 0;
+        }
+        if (!file.seek(file.pos() + length - 2)) {
+            return false;
+        }
+    }
+}
+
+} // namespace
+
+bool YoloReader::readImageSize(const QString& imagePath, int& width, int& height)
+{
+    QFile file(imagePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    uchar header[26];
+    const qint64 n = file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (n >= 24 && readBigEndian(header, 4) == 0x89504E47) { // PNG，IHDR 紧跟在签名之后
+        width = int(readBigEndian(header + 16, 4));
+        height = int(readBigEndian(header + 20, 4));
+        return width > 0 && height > 0;
+    }
+    if (n >= 26 && header[0] == 'B' && header[1] == 'M') {
+        width = readLittleEndian32(header + 18);
+        height = qAbs(readLittleEndian32(header + 22)); // 高度为负表示自上而下存储
+        return width > 0 && height > 0;
+    }
+    if (n >= 2 && header[0] == 0xFF && header[1] == 0xD8) {
+        return readJpegSize(file, width, height);
+    }
+    return false;
+}
+
+QString YoloReader::findImage(const QString& labelPath)
+{
+    static const char* const kExtensions[] = {"jpg", "jpeg", "png", "bmp", "JPG", "JPEG", "PNG", "BMP"};
+
+    const QFileInfo info(labelPath);
+    QStringList dirs;
+    dirs << info.path();
+    // 常见的 YOLO 目录结构：images/xxx.jpg 与 labels/xxx.txt 平行
+    const QString path = QDir::fromNativeSeparators(info.path());
+    const int labelsPos = path.lastIndexOf("/labels");
+    if (labelsPos >= 0 && (labelsPos + 7 == path.size() || path.at(labelsPos + 7) == '/')) {
+        dirs << path.left(labelsPos) + "/images" + path.mid(labelsPos + 7);
+    }
+
+    const QString base = info.completeBaseName();
+    for (const QString& dir : std::as_const(dirs)) {
+        for (const char* extension : kExtensions) {
+            const QString candidate = dir + '/' + base + '.' + QLatin1String(extension);
+            if (QFileInfo::exists(candidate)) {
+                return candidate;
+            }
+        }
+    }
+    return QString();
+}
+
+const QStringList& YoloReader::classNamesFor(const QString& dir)
+{
+    auto it = classNames_.constFind(dir);
+    if (it != classNames_.constEnd()) {
+        return it.value();
+    }
+
+    QStringList names;
+    QDir search(dir);
+    for (int level = 0; level < 3; ++level) {
+        QFile file(search.filePath("classes.txt"));
+        if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            while (!file.atEnd()) {
+                names << QString::fromUtf8(file.readLine()).trimmed();
+            }
+            break;
+        }
+        if (!search.cdUp()) {
+            break;
+        }
+    }
+    return classNames_.insert(dir, names).value();
+}
+
+int YoloReader::parseInto(const QString& filePath, AnnotationStore& store)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        note(ParseReport::CannotOpen, filePath, file.errorString());
+        return 0;
+    }
+    const QByteArray content = file.readAll();
+    file.close();
+
+    int imageWidth = 0, imageHeight = 0;
+    const QString imagePath = findImage(filePath);
+    const bool sizeKnown = !imagePath.isEmpty() && readImageSize(imagePath, imageWidth, imageHeight);
+    if (sizeKnown) {
+        store.setImageSize(imageWidth, imageHeight);
+    }
+    const double scaleX = sizeKnown ? imageWidth : kFallbackImageSize;
+    const double scaleY = sizeKnown ? imageHeight : kFallbackImageSize;
+
+    const QStringList& classNames = classNamesFor(QFileInfo(filePath).path());
+    int added = 0;
+    int lineNumber = 0;
+    for (const QByteArray& rawLine : content.split('\n')) {
+        ++lineNumber;
+        const QList<QByteArray> fields = rawLine.simplified().split(' ');
+        if (fields.size() == 1 && fields[0].isEmpty()) {
+            continue; // 空行
+        }
+
+        bool ok = fields.size() >= 5 && fields.size() % 2 == 1;
+        const int classId = ok ? fields[0].toInt(&ok) : -1;
+        double x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+        if (ok && fields.size() == 5) {
+            bool okValues[4];
+            const double cx = fields[1].toDouble(&okValues[0]);
+            const double cy = fields[2].toDouble(&okValues[1]);
+            const double w = fields[3].toDouble(&okValues[2]);
+            const double h = fields[4].toDouble(&okValues[3]);
+            ok = okValues[0] && okValues[1] && okValues[2] && okValues[3] && w > 0 && h > 0;
+            x0 = cx - w / 2;
+            x1 = cx + w / 2;
+            y0 = cy - h / 2;
+            y1 = cy + h / 2;
+        } else if (ok) {
+            // 分割格式：多边形顶点的外接框
+            x0 = y0 = INFINITY;
+            x1 = y1 = -INFINITY;
+            for (int i = 1; ok && i + 1 < fields.size(); i += 2) {
+                bool okX = false, okY = false;
+                const double x = fields[i].toDouble(&okX);
+                const double y = fields[i + 1].toDouble(&okY);
+                ok = okX && okY;
+                x0 = qMin(x0, x);
+                x1 = qMax(x1, x);
+                y0 = qMin(y0, y);
+                y1 = qMax(y1, y);
+            }
+            ok = ok && x1 > x0 && y1 > y0;
+        }
+        // 换算成 VOC 的像素坐标，框覆盖 [x0, x1) 中的全部像素；超出 int 范围或不是有限值的坐标也算无效行
+        int xmin = 0, ymin = 0, xEnd = 0, yEnd = 0;
+        ok = ok && toInteger(std::floor(x0 * scaleX), xmin) && toInteger(std::floor(y0 * scaleY), ymin)
+             && toInteger(std::ceil(x1 * scaleX), xEnd) && toInteger(std::ceil(y1 * scaleY), yEnd);
+        if (!ok || classId < 0) {
+            note(ParseReport::InvalidLine, filePath,
+                 wantsSample(ParseReport::InvalidLine) ? QString("第 %1 行").arg(lineNumber) : QString());
+            continue;
+        }
+        const int xmax = int(qMax<qint64>(xmin, qint64(xEnd) - 1));
+        const int ymax = int(qMax<qint64>(ymin, qint64(yEnd) - 1));
+        const QString name = classId < classNames.size() && !classNames[classId].isEmpty()
+                                 ? classNames[classId] : QString::number(classId);
+        store.addBox(store.internLabel(name), xmin, ymin, xmax, ymax);
+        ++added;
+    }
+    return added;
+}
@@ -0,0 +1,33 @@
+#ifndef YOLOREADER_H
+#define YOLOREADER_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include "annotationreader.h"
+
+// YOLO 格式：每张图片一个 .txt，每行 "类别 cx cy w h"（相对图片宽高的 0~1 坐标），
+// 或分割格式 "类别 x1 y1 x2 y2 ..."，此时取多边形的外接框
+// 类别名从 .txt 所在目录或其上两级目录中的 classes.txt 读取，找不到时用类别序号作为标签名
+// 图片宽高从同名图片（同目录，或把路径中的 labels 换成 images）的文件头读取，不解码图片
+class YoloReader : public AnnotationReader
+{
+public:
+    // 找不到对应图片时按这个尺寸换算像素坐标（YOLO 常用的训练尺寸），store 中的图片宽高记为未知
+    static constexpr int kFallbackImageSize = 640;
+
+    AnnotationFormat format() const override { return AnnotationFormat::Yolo; }
+    int parseInto(const QString& filePath, AnnotationStore& store) override;
+
+    // 读取 PNG/JPEG/BMP 文件头中的宽高，失败时返回 false
+    static bool readImageSize(const QString& imagePath, int& width, int& height);
+
+private:
+    // 同名图片的路径，找不到时为空
+    static QString findImage(const QString& labelPath);
+    const QStringList& classNamesFor(const QString& dir);
+
+    QHash<QString, QStringList> classNames_; // 标注文件目录 -> 类别名，每个目录只查找一次
+};
+
+#endif // YOLOREADER_H